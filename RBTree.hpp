@@ -1,6 +1,7 @@
 #ifndef REDBLACKTREE_HPP
 # define REDBLACKTREE_HPP
 
+# include <cstring>
 # include <stdexcept>
 # include <memory>
 # include "pair.hpp"
@@ -13,13 +14,90 @@
 
 namespace ft
 {
-	template <typename T, typename Comparator, typename Alloc>
+	// Снимок состояния дерева. Счетчики операций ведутся, только если собрать
+	// с -DFT_RBTREE_STATS, иначе они нулевые и ничего не стоят; форма дерева
+	// (высота, число узлов на каждой глубине) считается при каждом снимке
+	struct tree_stats
+	{
+		static const std::size_t	depth_buckets = 64;
+
+		bool		counters_enabled;
+
+		std::size_t	finds;
+		std::size_t	inserts;
+		std::size_t	erases;
+		std::size_t	find_comparisons;
+		std::size_t	insert_comparisons;
+		std::size_t	erase_comparisons;
+		std::size_t	rotations;
+		std::size_t	recolors;
+		std::size_t	descents;
+		std::size_t	descent_steps;		// узлов пройдено при спусках от корня
+		std::size_t	max_descent;
+		std::size_t	iterator_steps;		// переходов по ссылкам в ++/-- всех итераторов этого типа узла:
+										// счетчик общий для всех деревьев с тем же Node, не для одного дерева
+
+		std::size_t	size;
+		std::size_t	height;
+		std::size_t	depth_histogram[depth_buckets];
+
+		tree_stats(void)
+		{
+			this->reset();
+		};
+
+		void	reset(void)
+		{
+			std::memset(static_cast<void *>(this), 0, sizeof(*this));
+		};
+	};
+
+	// Политика дополнения узлов по умолчанию: ничего не хранит и не пересчитывает.
+	// Своя политика задает data (база узла) и update(node), который пересчитывает
+	// данные узла по его детям; дерево вызывает update после вращений и вдоль
+	// пути от измененного места к корню при вставке и удалении
+	struct tree_no_augment
+	{
+		static const bool	enabled = false;
+
+		typedef	tree_no_augment_data	data;
+
+		template <class Node>
+		static void	update(Node *) {};
+	};
+
+	// Источник значений для RedBlackTree::build_sorted поверх итератора
+	template <typename Iter, typename T>
+	class _iterator_source
+	{
+		private:
+			Iter	_cursor;
+
+		public:
+			explicit _iterator_source(Iter first) : _cursor(first) {};
+
+			T	operator()(void)
+			{
+				return (*this->_cursor++);
+			};
+	};
+
+	template <typename T, typename Comparator, typename Alloc, class Augment = tree_no_augment>
 	class RedBlackTree
 	{
+		// Тесты (tests/test.hpp) проверяют инварианты дерева
+		friend struct _test_access;
+
+		// Параллельная сборка (parallel_build.hpp) строит поддеревья через _buildSorted
+		template <class>
+		friend struct _tree_parallel_build;
+
 		public:
-			typedef typename	ft::TreeNode<T>										Node;
+			typedef typename	ft::TreeNode<T, typename Augment::data>				Node;
 
 		public:
+			typedef				T													value_type;
+			typedef				Augment												augment_type;
 			typedef typename	Alloc::template rebind<Node>::other					allocator_type;
 			typedef typename	allocator_type::size_type							size_type;
 			typedef typename	ft::tree_iterator<T, Node >							iterator;
@@ -35,15 +113,25 @@ namespace ft
 			Comparator			comparator;
 			size_type			size;
 
+		private:
+
+# ifdef FT_RBTREE_STATS
+			mutable tree_stats		_stats;
+			mutable std::size_t *	_comparisons;
+# endif
+
 		public:
 
 			explicit RedBlackTree(allocator_type const & alloc = allocator_type(), Comparator const & comparator = Comparator())
 				: root(NULL), allocator(allocator_type(alloc)), comparator(Comparator(comparator)), size(0)
-			{};
+			{
+				FT_RBTREE_COUNT(this->_comparisons = &this->_stats.find_comparisons;)
+			};
 
 			explicit RedBlackTree(const RedBlackTree & src)
 				: root(NULL), allocator(src.allocator), comparator(src.comparator), size(src.size)
 			{
+				FT_RBTREE_COUNT(this->_comparisons = &this->_stats.find_comparisons;)
 				this->_copy(src.root, &this->root);
 			};
 
@@ -54,6 +142,8 @@ namespace ft
 
 			RedBlackTree &	operator=(const RedBlackTree & src)
 			{
+				if (this == &src)
+					return (*this);
 				this->clear();
 				this->size = src.size;
 
@@ -71,8 +161,52 @@ namespace ft
 
 				*dst = this->allocator.allocate(1);
 				this->allocator.construct(*dst, *src);
+				(*dst)->parent = parent;
+				(*dst)->left = NULL;
+				(*dst)->right = NULL;
 				this->_copy(src->left, &(*dst)->left, *dst);
-				this->_copy(src->left, &(*dst)->right, *dst);
+				this->_copy(src->right, &(*dst)->right, *dst);
+			};
+
+			// Все сравнения дерева идут через _less, чтобы их можно было посчитать
+			bool	_less(const T & lhd, const T & rhd)	const
+			{
+				FT_RBTREE_COUNT(_stats_add(*__atomic_load_n(&this->_comparisons, __ATOMIC_RELAXED));)
+				return (this->comparator(lhd, rhd));
+			};
+
+# ifdef FT_RBTREE_STATS
+			// const-поиски могут идти из нескольких потоков сразу (и потоки
+			// сборки из parallel_build.hpp тоже сравнивают), поэтому счетчики и указатель
+			// на текущий счетчик сравнений меняются атомарно, без упорядочивания
+			void	_beginOperation(std::size_t & counter, std::size_t & comparisons)	const
+			{
+				_stats_add(counter);
+				__atomic_store_n(&this->_comparisons, &comparisons, __ATOMIC_RELAXED);
+			};
+
+			void	_countDescent(std::size_t depth)	const
+			{
+				std::size_t	seen = __atomic_load_n(&this->_stats.max_descent, __ATOMIC_RELAXED);
+
+				_stats_add(this->_stats.descents);
+				_stats_add(this->_stats.descent_steps, depth);
+				while (depth > seen && !__atomic_compare_exchange_n(&this->_stats.max_descent, &seen, depth,
+					true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+					;
+			};
+# endif
+
+			void	_measureShape(const Node * node, std::size_t depth, tree_stats & stats)	const
+			{
+				if (!node)
+					return ;
+
+				if (depth + 1 > stats.height)
+					stats.height = depth + 1;
+				stats.depth_histogram[depth < tree_stats::depth_buckets ? depth : tree_stats::depth_buckets - 1]++;
+				this->_measureShape(node->left, depth + 1, stats);
+				this->_measureShape(node->right, depth + 1, stats);
 			};
 
 			void	_updateRoot(void)
@@ -84,42 +218,74 @@ namespace ft
 					this->root = this->root->parent;				
 			};
 
-			static void	_insertionRebalance(Node * start)
+			// Пересчет дополнения от node до корня
+			void	_augmentPath(Node * node)
+			{
+				if (!Augment::enabled)
+					return ;
+				for (; node; node = node->parent)
+					Augment::update(node);
+			};
+
+			// Поворот, поднимающий node на место родителя. Содержимое поддеревьев
+			// выше не меняется, поэтому пересчитать нужно только эти два узла
+			void	_rotateUp(Node * node)
+			{
+				Node *	parent = node->parent;
+
+				node->getOnSurface();
+				if (!Augment::enabled)
+					return ;
+				Augment::update(parent);
+				Augment::update(node);
+			};
+
+			void	_insertionRebalance(Node * start)
 			{
 				Node *	uncle = start->getUncle();
 
 				if (!start->parent)
+				{
 					start->red = false;
+					FT_RBTREE_COUNT(_stats_add(this->_stats.recolors);)
+				}
 				else if (start->parent->red && !start->parent->parent)
+				{
 					start->parent->red = false;
+					FT_RBTREE_COUNT(_stats_add(this->_stats.recolors);)
+				}
 				else if (start->parent->red && (!uncle || !uncle->red))
 				{
 					if (!start->isOuterGrandchild())
 					{
 						Node *	buf = start->parent;
 
-						start->getOnSurface();
+						this->_rotateUp(start);
+						FT_RBTREE_COUNT(_stats_add(this->_stats.rotations);)
 						start = buf;
 					}
 
-					start->parent->getOnSurface();
+					this->_rotateUp(start->parent);
 					start->parent->red = false;
 
 					if (start->parent->left)
 						start->parent->left->red = true;
 					if (start->parent->right)
 						start->parent->right->red = true;
+					FT_RBTREE_COUNT(_stats_add(this->_stats.rotations);)
+					FT_RBTREE_COUNT(_stats_add(this->_stats.recolors, 2);)
 				}
 				else if (start->parent->red && uncle->red)
 				{
 					start->parent->red = false;
 					uncle->red = false;
 					start->parent->parent->red = true;
-					_insertionRebalance(start->parent->parent);
+					FT_RBTREE_COUNT(_stats_add(this->_stats.recolors, 3);)
+					this->_insertionRebalance(start->parent->parent);
 				}
 			};
 
-			static void	_deletionRebalance(Node * start)
+			void	_deletionRebalance(Node * start)
 			{
 				if (!start->parent)
 					return ;
@@ -129,33 +295,47 @@ namespace ft
 				if (!sibling->red && sibling->allChildrensBlack())
 				{
 					sibling->red = true;
+					FT_RBTREE_COUNT(_stats_add(this->_stats.recolors);)
 
 					if (!start->parent->red)
-						_deletionRebalance(start->parent);
+						this->_deletionRebalance(start->parent);
 					else
+					{
 						start->parent->red = false;
+						FT_RBTREE_COUNT(_stats_add(this->_stats.recolors);)
+					}
 				}
 				else if (!sibling->red)
 				{
-					Node *	closest = *sibling->dirs[start->getDir()];
+					Node *	closest = sibling->dir(start->getDir());
 
 					if (closest && closest->red)
 					{
-						closest->getOnSurface();
+						this->_rotateUp(closest);
 						closest->red = false;
 						sibling = closest;
+						FT_RBTREE_COUNT(_stats_add(this->_stats.rotations);)
+						FT_RBTREE_COUNT(_stats_add(this->_stats.recolors);)
 					}
 
-					sibling->getOnSurface();
+					Node *	farthest = sibling->dir(!start->getDir());
+
+					this->_rotateUp(sibling);
 					sibling->red = start->parent->red;
 					start->parent->red = false;
+					if (farthest)
+						farthest->red = false;
+					FT_RBTREE_COUNT(_stats_add(this->_stats.rotations);)
+					FT_RBTREE_COUNT(_stats_add(this->_stats.recolors, 3);)
 				}
 				else if (sibling->red)
 				{
-					sibling->getOnSurface();
+					this->_rotateUp(sibling);
 					sibling->red = false;
 					start->parent->red = true;
-					_deletionRebalance(start);
+					FT_RBTREE_COUNT(_stats_add(this->_stats.rotations);)
+					FT_RBTREE_COUNT(_stats_add(this->_stats.recolors, 2);)
+					this->_deletionRebalance(start);
 				}
 			};
 
@@ -198,62 +378,111 @@ namespace ft
 				this->_checkBranches(this->root, height);
 			};
 
-			void	_replaceNode(Node * src, Node * dst)
+			// Меняет местами в дереве node и pred - максимум его левого поддерева;
+			// цвета остаются на местах. Значения не копируются, узлы не пересоздаются
+			void	_swapWithPredecessor(Node * node, Node * pred)
 			{
-				if (src)
-					src->stealLinks(dst);
+				Node *	parent = node->parent;
+				Node *	left = node->left;
+				Node *	right = node->right;
+				int		dir = node->getDir();
+				bool	red = node->red;
+
+				node->left = pred->left;
+				node->right = NULL;
+				if (pred == left)
+				{
+					node->parent = pred;
+					pred->left = node;
+				}
 				else
-					*dst->parent->dirs[dst->getDir()] = NULL;
+				{
+					node->parent = pred->parent;
+					pred->parent->right = node;
+					pred->left = left;
+					left->parent = pred;
+				}
+				if (node->left)
+					node->left->parent = node;
+
+				pred->right = right;
+				right->parent = pred;
+				pred->parent = parent;
+				if (parent)
+					parent->dir(dir) = pred;
+				else
+					this->root = pred;
 
-				this->allocator.destroy(dst);
-				this->allocator.deallocate(dst, 1);
+				node->red = pred->red;
+				pred->red = red;
 			};
 
-			void	_deleteNode(Node *node)
+			// Вынимает узел из дерева с перебалансировкой, но не освобождает его:
+			// узел с двумя детьми сначала меняется местами с предшественником
+			void	_unlink(Node * node)
 			{
+				if (node->left && node->right)
+				{
+					Node *	pred = node->left;
+
+					while (pred->right)
+						pred = pred->right;
+					this->_swapWithPredecessor(node, pred);
+				}
+
 				Node *	child = node->getChild();
 
-				*node->parent->dirs[node->getDir()] = child;
+				if (!node->red && !child)
+					this->_deletionRebalance(node);
+
+				if (!node->parent)
+					this->root = child;
+				else
+					node->parent->dir(node->getDir()) = child;
 				if (child)
 				{
 					child->parent = node->parent;
-					child->red = node->red;
+					child->red = false;
 				}
+				this->_augmentPath(node->parent);
+				this->_updateRoot();
+				this->size--;
 
-				this->allocator.destroy(node);
-				this->allocator.deallocate(node, 1);
+				node->parent = NULL;
+				node->left = NULL;
+				node->right = NULL;
 			};
 
-			Node *	_internalDeletionHandler(Node * node)
+			// Место для нового узла со значением val; NULL, если такой ключ уже есть
+			// (тогда parent - узел с этим ключом)
+			Node **	_findSlot(const T & val, Node * hint, Node *& parent)
 			{
-				Node *	cursor = NULL;
-
-				if (node->left && node->right)
-				{
-					cursor = node->left;
-					while (cursor->right)
-						cursor = cursor->right;
-				}
-				else
-					return (node);
-				
-				Node *	dummy = this->allocator.allocate(1);
-
-				this->allocator.construct(dummy, Node());
-
-				dummy->stealLinks(cursor);
-
-				this->_replaceNode(cursor, node);
+				parent = this->_findPlaceForInsert(val, hint);
+				if (!parent)
+					return (&this->root);
+				if (this->_less(val, parent->value))
+					return (&parent->left);
+				if (this->_less(parent->value, val))
+					return (&parent->right);
+				return (NULL);
+			};
 
-				return (dummy);
+			void	_link(Node * node, Node * parent, Node ** side)
+			{
+				node->parent = parent;
+				*side = node;
+				this->_augmentPath(node);
+				this->_insertionRebalance(node);
+				this->_updateRoot();
+				this->size++;
 			};
 
 			Node *	_iteratorRoutine(bool end)	const
 			{
 				Node *	cursor = this->root;
 
-				while (cursor && *cursor->dirs[end])
-					cursor = *cursor->dirs[end];
+				while (cursor && cursor->dir(end))
+					cursor = cursor->dir(end);
 
 				return (cursor);
 			};
@@ -262,29 +491,122 @@ namespace ft
 			{
 				if (hint && hint != this->root)
 				{
-					if (this->comparator(val, hint->value))
+					if (this->_less(val, hint->value))
 						return (this->_findPlaceForInsert(val));
-					if (this->comparator(hint->parent->value, val))
+					if (!this->_less(val, hint->parent->value))
 						return (this->_findPlaceForInsert(val));
 				}
 				else if (!hint)
 					hint = this->root;
 
-				Node *	crsr = hint;
+				Node *		crsr = hint;
+				std::size_t	depth = 0;
 
 				while (crsr)
 				{
-					if (crsr->left && this->comparator(val, crsr->value))
+					depth++;
+					if (crsr->left && this->_less(val, crsr->value))
 						crsr = crsr->left;
-					else if (crsr->right && this->comparator(crsr->value, val))
+					else if (crsr->right && this->_less(crsr->value, val))
 						crsr = crsr->right;
 					else
 						break;
 				}
+				FT_RBTREE_COUNT(this->_countDescent(depth);)
+				(void)depth;
 				
 				return (crsr);
 			};
 
+			// Первый узел не меньше key (upper - строго больше), NULL если такого нет
+			Node *	_bound(const T & key, bool upper)	const
+			{
+				Node *		result = NULL;
+				Node *		cursor = this->root;
+				std::size_t	depth = 0;
+
+				FT_RBTREE_COUNT(this->_beginOperation(this->_stats.finds, this->_stats.find_comparisons);)
+				while (cursor)
+				{
+					depth++;
+					if (upper ? this->_less(key, cursor->value) : !this->_less(cursor->value, key))
+					{
+						result = cursor;
+						cursor = cursor->left;
+					}
+					else
+						cursor = cursor->right;
+				}
+				FT_RBTREE_COUNT(this->_countDescent(depth);)
+				(void)depth;
+
+				return (result);
+			};
+
+			// Средний элемент - в корень, половины - в поддеревья: source читается
+			// строго по порядку. Уровни выше full заполнены целиком и черные,
+			// неполный нижний уровень красный, так что черная высота везде одинакова
+			template <class Source>
+			Node *	_buildSorted(Source & source, size_type n, std::size_t depth, std::size_t full, const T *& last)
+			{
+				if (!n)
+					return (NULL);
+
+				size_type	left_size = (n - 1) / 2;
+				Node *		left = this->_buildSorted(source, left_size, depth + 1, full, last);
+				Node *		node = NULL;
+
+				try
+				{
+					T	value = source();
+
+					if (last && !this->_less(*last, value))
+						throw std::invalid_argument("RedBlackTree: sorted input is not strictly increasing");
+					node = this->allocator.allocate(1);
+					this->allocator.construct(node, Node(value, NULL, depth == full));
+				}
+				catch (...)
+				{
+					// Узел выделен, но не построен: только вернуть память
+					if (node)
+						this->allocator.deallocate(node, 1);
+					this->_destroy(left);
+					throw;
+				}
+
+				node->left = left;
+				if (left)
+					left->parent = node;
+				last = &node->value;
+
+				try
+				{
+					node->right = this->_buildSorted(source, n - 1 - left_size, depth + 1, full, last);
+				}
+				catch (...)
+				{
+					this->_destroy(node);
+					throw;
+				}
+				if (node->right)
+					node->right->parent = node;
+				if (Augment::enabled)
+					Augment::update(node);
+
+				return (node);
+			};
+
+			void	_destroy(Node * node)
+			{
+				if (!node)
+					return ;
+
+				this->_destroy(node->left);
+				this->_destroy(node->right);
+				this->allocator.destroy(node);
+				this->allocator.deallocate(node, 1);
+			};
+
 			static void	_print_value(Node * node, std::string before = std::string(""), std::string after = std::string(""))
 			{
 				if (before.size())
@@ -302,110 +624,228 @@ namespace ft
 
 			ft::pair<iterator, bool>	insert(const T & val, Node * hint = NULL)
 			{
-				Node *	parent = this->_findPlaceForInsert(val, hint);
-				Node **	insertion_side = &parent;
+				FT_RBTREE_COUNT(this->_beginOperation(this->_stats.inserts, this->_stats.insert_comparisons);)
 
-				if (!parent)
-					insertion_side = &this->root;
-				else if (this->comparator(val, parent->value))
-					insertion_side = &parent->left;
-				else if (this->comparator(parent->value, val))
-					insertion_side = &parent->right;
-				else
+				Node *	parent;
+				Node **	side = this->_findSlot(val, hint, parent);
+
+				if (!side)
+					return (ft::make_pair(iterator(parent), false));
+
+				Node *	node = this->allocator.allocate(1);
+
+				this->allocator.construct(node, Node(val, parent));
+				this->_link(node, parent, side);
+
+				return (ft::make_pair(iterator(node, this->root), true));
+			};
+
+			// Вставка уже выделенного узла (например, вынутого extract из другого
+			// дерева с тем же аллокатором). При совпадении ключа узел не трогается.
+			// Если узел еще висит в дереве from, он вынимается оттуда, только когда
+			// место найдено: merge обходится одним спуском на узел
+			ft::pair<iterator, bool>	insert_node(Node * node, RedBlackTree * from = NULL)
+			{
+				FT_RBTREE_COUNT(this->_beginOperation(this->_stats.inserts, this->_stats.insert_comparisons);)
+
+				Node *	parent;
+				Node **	side = this->_findSlot(node->value, NULL, parent);
+
+				if (!side)
 					return (ft::make_pair(iterator(parent), false));
+				if (from)
+					from->extract(node);
+
+				node->red = true;
+				node->left = NULL;
+				node->right = NULL;
+				this->_link(node, parent, side);
+
+				return (ft::make_pair(iterator(node, this->root), true));
+			};
+
+			// Пересчет дополнения после изменения значения узла на месте
+			void	refresh(Node * node)
+			{
+				this->_augmentPath(node);
+			};
+
+			// Вынимает узел без освобождения памяти, владение переходит к вызывающему
+			Node *	extract(Node * node)
+			{
+				FT_RBTREE_COUNT(_stats_add(this->_stats.erases);)
+				this->_unlink(node);
+				return (node);
+			};
+
+			// Вставка с повторами: равный ключ уходит вправо, поэтому равные
+			// значения идут в порядке вставки
+			iterator	insert_multi(const T & val)
+			{
+				FT_RBTREE_COUNT(this->_beginOperation(this->_stats.inserts, this->_stats.insert_comparisons);)
 
-				*insertion_side = this->allocator.allocate(1);
-				this->allocator.construct(*insertion_side, Node(val, parent));
+				Node *		parent = NULL;
+				Node **		side = &this->root;
+				std::size_t	depth = 0;
+
+				while (*side)
+				{
+					depth++;
+					parent = *side;
+					side = this->_less(val, parent->value) ? &parent->left : &parent->right;
+				}
+				FT_RBTREE_COUNT(this->_countDescent(depth);)
+				(void)depth;
 
-				return (ft::make_pair(iterator(*insertion_side), bool(++this->size)));
+				Node *	node = this->allocator.allocate(1);
+
+				this->allocator.construct(node, Node(val, parent));
+				this->_link(node, parent, side);
+
+				return (iterator(node, this->root));
+			};
+
+			// Дерево из n строго возрастающих значений за O(n): n - 1 сравнение
+			// для проверки порядка и ни одной перебалансировки. Прежнее содержимое удаляется
+			template <class Source>
+			void	build_sorted(Source & source, size_type n)
+			{
+				std::size_t	full = 0;
+				const T *	last = NULL;
+
+				this->clear();
+				while ((std::size_t(2) << full) - 1 <= n)
+					full++;
+				this->root = this->_buildSorted(source, n, 0, full, last);
+				this->size = n;
 			};
 
 			iterator	find(const T & val)
 			{
-				Node *	founded = this->_findPlaceForInsert(val);
+				FT_RBTREE_COUNT(this->_beginOperation(this->_stats.finds, this->_stats.find_comparisons);)
 
-				if (founded
-					&& !this->comparator(val, founded->value)
-					&& !this->comparator(founded->value, val))
-					return (iterator(founded));
-				return (this->end());
+				Node *	founded = this->_findNode(val);
+
+				return (founded ? iterator(founded) : this->end());
 			};
 
 			const_iterator	find(const T & val)	const
 			{
-				Node *	founded = this->_findPlaceForInsert(val);
+				FT_RBTREE_COUNT(this->_beginOperation(this->_stats.finds, this->_stats.find_comparisons);)
 
-				if (founded
-					&& !this->comparator(val, founded->value)
-					&& !this->comparator(founded->value, val))
-					return (const_iterator(founded));
-				return (this->cend());
+				Node *	founded = this->_findNode(val);
+
+				return (founded ? const_iterator(founded) : this->cend());
 			};
 
-			iterator	lower_bound(const T & key)
+			// Без итератора: ни подъема к корню, ни поиска end()
+			size_type	count(const T & val)	const
 			{
-				Node *	founded = this->_findPlaceForInsert(key);
+				FT_RBTREE_COUNT(this->_beginOperation(this->_stats.finds, this->_stats.find_comparisons);)
 
-				if (!founded
-					|| (!this->comparator(founded->value, key)
-						&& !this->comparator(key, founded->value)))
-					return (iterator(founded));
-				return (++iterator(founded));
+				return (this->_findNode(val) != NULL);
 			};
 
-			const_iterator	lower_bound(const T & key)	const
+			Node *	find_node(const T & val)	const
 			{
-				Node *	founded = this->_findPlaceForInsert(key);
+				FT_RBTREE_COUNT(this->_beginOperation(this->_stats.finds, this->_stats.find_comparisons);)
 
-				if (!founded
-					|| (!this->comparator(founded->value, key)
-						&& !this->comparator(key, founded->value)))
-					return (const_iterator(founded));
-				return (++const_iterator(founded));
+				return (this->_findNode(val));
 			};
 
-			iterator	upper_bound(const T & key)
+			iterator	lower_bound(const T & key)
+			{
+				return (iterator(this->_bound(key, false), this->root));
+			};
+
+			const_iterator	lower_bound(const T & key)	const
 			{
-				iterator	it = this->lower_bound(key);
+				return (const_iterator(this->_bound(key, false), this->root));
+			};
 
-				if (it != this->end()
-					&& !this->comparator(*it, key) && !this->comparator(key, *it))
-					return (++it);
-				return (it);
+			iterator	upper_bound(const T & key)
+			{
+				return (iterator(this->_bound(key, true), this->root));
 			};
 
 			const_iterator	upper_bound(const T & key)	const
 			{
-				const_iterator	it = this->lower_bound(key);
+				return (const_iterator(this->_bound(key, true), this->root));
+			};
 
-				if (it != this->end()
-					&& !this->comparator(*it, key) && !this->comparator(key, *it))
-					return (++it);
-				return (it);
+			size_type	erase(const T & val)
+			{
+				FT_RBTREE_COUNT(this->_beginOperation(this->_stats.erases, this->_stats.erase_comparisons);)
+
+				Node *	founded = this->_findNode(val);
+
+				if (!founded)
+					return (0);
+				this->_erase(founded);
+				return (1);
 			};
 
 			void	erase(Node * node)
 			{
-				if (node == this->root)
-				{
-					this->root = node->left;
-					if (!node->left)
-						this->root = node->right;
-				}
+				FT_RBTREE_COUNT(_stats_add(this->_stats.erases);)
+				this->_erase(node);
+			};
 
-				node = _internalDeletionHandler(node);
-				
-				Node *	child = node->getChild();
+			tree_stats	stats(void)	const
+			{
+				tree_stats	snapshot;
 
-				if (!node->red && !child)
-					_deletionRebalance(node);
-				
-				this->_deleteNode(node);
-				this->_updateRoot();
-				this->_checkTree();
-				this->size--;
+# ifdef FT_RBTREE_STATS
+				static std::size_t tree_stats::* const	counters[] = {
+					&tree_stats::finds, &tree_stats::inserts, &tree_stats::erases,
+					&tree_stats::find_comparisons, &tree_stats::insert_comparisons, &tree_stats::erase_comparisons,
+					&tree_stats::rotations, &tree_stats::recolors,
+					&tree_stats::descents, &tree_stats::descent_steps, &tree_stats::max_descent
+				};
+
+				for (std::size_t i = 0; i < sizeof(counters) / sizeof(*counters); i++)
+					snapshot.*counters[i] = __atomic_load_n(&(this->_stats.*counters[i]), __ATOMIC_RELAXED);
+				snapshot.counters_enabled = true;
+				snapshot.iterator_steps = __atomic_load_n(&_tree_iterator_steps<Node>::value, __ATOMIC_RELAXED);
+# endif
+				snapshot.size = this->size;
+				snapshot.height = 0;
+				for (std::size_t i = 0; i < tree_stats::depth_buckets; i++)
+					snapshot.depth_histogram[i] = 0;
+				this->_measureShape(this->root, 0, snapshot);
+				return (snapshot);
 			};
 
+			void	reset_stats(void)
+			{
+# ifdef FT_RBTREE_STATS
+				this->_stats.reset();
+				__atomic_store_n(&_tree_iterator_steps<Node>::value, 0, __ATOMIC_RELAXED);
+# endif
+			};
+
+		private:
+
+			Node *	_findNode(const T & val)	const
+			{
+				Node *	founded = this->_findPlaceForInsert(val);
+
+				if (founded
+					&& !this->_less(val, founded->value)
+					&& !this->_less(founded->value, val))
+					return (founded);
+				return (NULL);
+			};
+
+			void	_erase(Node * node)
+			{
+				this->_unlink(node);
+				this->allocator.destroy(node);
+				this->allocator.deallocate(node, 1);
+			};
+
+		public:
+
 			void	clear(Node * start = NULL)
 			{
 				if (!start)
@@ -465,15 +905,18 @@ namespace ft
 
 			const_reverse_iterator	crend(void)	const
 			{
-				return (const_reverse_iterator(this->begin()));
+				return (const_reverse_iterator(this->cbegin()));
 			};
 
-			void	swap(const RedBlackTree & ref)
+			void	swap(RedBlackTree & ref)
 			{
-				Node *	buf = this->root;
+				Node *		root_buf = this->root;
+				size_type	size_buf = this->size;
 
 				this->root = ref.root;
-				ref.root = buf;
+				this->size = ref.size;
+				ref.root = root_buf;
+				ref.size = size_buf;
 			};
 	};
 }
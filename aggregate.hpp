@@ -0,0 +1,160 @@
+#ifndef AGGREGATE_HPP
+# define AGGREGATE_HPP
+
+# include <cstddef>
+# include <limits>
+# include "RBTree.hpp"
+
+namespace ft
+{
+	// Моноид для map::aggregate: result_type, нейтральный identity(),
+	// ассоциативный combine(a, b) и lift(mapped) - вклад одного элемента.
+	// combine может быть некоммутативным, порядок ключей сохраняется
+	template <typename T>
+	struct sum_monoid
+	{
+		typedef	T	result_type;
+
+		static result_type	identity(void)
+		{
+			return (result_type());
+		};
+
+		static result_type	combine(const result_type & lhd, const result_type & rhd)
+		{
+			return (lhd + rhd);
+		};
+
+		static result_type	lift(const T & value)
+		{
+			return (value);
+		};
+	};
+
+	template <typename T>
+	struct count_monoid
+	{
+		typedef	std::size_t	result_type;
+
+		static result_type	identity(void)
+		{
+			return (0);
+		};
+
+		static result_type	combine(const result_type & lhd, const result_type & rhd)
+		{
+			return (lhd + rhd);
+		};
+
+		static result_type	lift(const T &)
+		{
+			return (1);
+		};
+	};
+
+	template <typename T>
+	struct min_monoid
+	{
+		typedef	T	result_type;
+
+		static result_type	identity(void)
+		{
+			return (std::numeric_limits<T>::max());
+		};
+
+		static result_type	combine(const result_type & lhd, const result_type & rhd)
+		{
+			return (rhd < lhd ? rhd : lhd);
+		};
+
+		static result_type	lift(const T & value)
+		{
+			return (value);
+		};
+	};
+
+	template <typename T>
+	struct max_monoid
+	{
+		typedef	T	result_type;
+
+		static result_type	identity(void)
+		{
+			return (std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::min() : -std::numeric_limits<T>::max());
+		};
+
+		static result_type	combine(const result_type & lhd, const result_type & rhd)
+		{
+			return (lhd < rhd ? rhd : lhd);
+		};
+
+		static result_type	lift(const T & value)
+		{
+			return (value);
+		};
+	};
+
+	// map без агрегата: дерево без дополнения
+	struct no_aggregate
+	{
+		typedef	void	result_type;
+	};
+
+	// Узел map хранит свертку моноида по своему поддереву
+	template <class Monoid>
+	struct map_aggregate_augment
+	{
+		static const bool	enabled = true;
+
+		struct data
+		{
+			typename Monoid::result_type	aggregate;
+
+			data(void) : aggregate(Monoid::identity()) {};
+		};
+
+		template <class Node>
+		static void	update(Node * node)
+		{
+			typename Monoid::result_type	result = Monoid::lift(node->value.second);
+
+			if (node->left)
+				result = Monoid::combine(node->left->aggregate, result);
+			if (node->right)
+				result = Monoid::combine(result, node->right->aggregate);
+			node->aggregate = result;
+		};
+	};
+
+	template <class Monoid>
+	struct _map_augment
+	{
+		typedef	map_aggregate_augment<Monoid>	type;
+	};
+
+	template <>
+	struct _map_augment<no_aggregate>
+	{
+		typedef	tree_no_augment	type;
+	};
+
+	// Со сверткой map отдает значения только для чтения: запись мимо assign
+	// оставила бы свертки предков устаревшими. Без свертки - как std::map
+	template <class Monoid, class Tree, typename T>
+	struct _map_access
+	{
+		typedef typename	Tree::const_iterator			iterator;
+		typedef typename	Tree::const_reverse_iterator	reverse_iterator;
+		typedef				const T &						mapped_reference;
+	};
+
+	template <class Tree, typename T>
+	struct _map_access<no_aggregate, Tree, T>
+	{
+		typedef typename	Tree::iterator					iterator;
+		typedef typename	Tree::reverse_iterator			reverse_iterator;
+		typedef				T &								mapped_reference;
+	};
+};
+
+#endif
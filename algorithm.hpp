@@ -1,9 +1,123 @@
 #ifndef ALGORITHM
 # define ALGORITHM
 
+# include <algorithm>
+# include <climits>
+# include <cstddef>
+# include <cstring>
+# include <cwchar>
+# include <memory>
+# include "type_traits.hpp"
+# include "iterator_traits.hpp"
+# include "vector_iterator.hpp"
+# if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  define FT_SIMD_X86 1
+# endif
+
 namespace ft {
+	// Итераторы поверх непрерывной памяти: указатели и vector_iterator
+	template <typename Iter>
+	struct _contiguous : public false_type {};
+
+	template <typename T>
+	struct _contiguous<T *> : public true_type
+	{
+		typedef typename _remove_cv<T>::type	value_type;
+
+		static const T *	address(T * it) { return (it); };
+	};
+
+	template <typename Iter>
+	struct _contiguous< vector_iterator<Iter> > : public _contiguous<Iter>
+	{
+		static typename _contiguous<Iter>::value_type const *	address(const vector_iterator<Iter> & it) { return (it.base()); };
+	};
+
+	// Оба диапазона непрерывны и содержат одинаковые целые: равенство элементов
+	// совпадает с равенством байт, а порядок решает первый несовпавший элемент
+	template <typename Iter1, typename Iter2, bool = _contiguous<Iter1>::value && _contiguous<Iter2>::value>
+	struct _bytewise_comparable : public false_type {};
+
+	template <typename Iter1, typename Iter2>
+	struct _bytewise_comparable<Iter1, Iter2, true> : public integral_constant<bool,
+		is_same<typename _contiguous<Iter1>::value_type, typename _contiguous<Iter2>::value_type>::value
+		&& is_integral<typename _contiguous<Iter1>::value_type>::value> {};
+
+	// Поиск первого различающегося байта. Ядро выбирается один раз по cpuid
+	struct _mismatch_kernel
+	{
+		typedef std::size_t	(*function)(const unsigned char *, const unsigned char *, std::size_t);
+
+		static std::size_t	scalar(const unsigned char * lhd, const unsigned char * rhd, std::size_t n)
+		{
+			std::size_t	i = 0;
+
+			for (; i + 64 <= n && !std::memcmp(lhd + i, rhd + i, 64); i += 64)
+				;
+			for (; i < n && lhd[i] == rhd[i]; i++)
+				;
+			return (i);
+		};
+
+# ifdef FT_SIMD_X86
+		__attribute__((target("sse2")))
+		static std::size_t	sse2(const unsigned char * lhd, const unsigned char * rhd, std::size_t n)
+		{
+			std::size_t	i = 0;
+
+			for (; i + 16 <= n; i += 16)
+			{
+				__m128i	a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lhd + i));
+				__m128i	b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhd + i));
+				int		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xFFFF;
+
+				if (mask)
+					return (i + __builtin_ctz(mask));
+			}
+			return (i + scalar(lhd + i, rhd + i, n - i));
+		};
+
+		__attribute__((target("avx2")))
+		static std::size_t	avx2(const unsigned char * lhd, const unsigned char * rhd, std::size_t n)
+		{
+			std::size_t	i = 0;
+
+			for (; i + 32 <= n; i += 32)
+			{
+				__m256i		a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhd + i));
+				__m256i		b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhd + i));
+				unsigned	mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+
+				if (mask)
+					return (i + __builtin_ctz(mask));
+			}
+			return (i + scalar(lhd + i, rhd + i, n - i));
+		};
+# endif
+
+		static function	select(void)
+		{
+# ifdef FT_SIMD_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+				return (&avx2);
+			if (__builtin_cpu_supports("sse2"))
+				return (&sse2);
+# endif
+			return (&scalar);
+		};
+
+		static std::size_t	run(const void * lhd, const void * rhd, std::size_t n)
+		{
+			static const function	kernel = select();
+
+			return (kernel(static_cast<const unsigned char *>(lhd), static_cast<const unsigned char *>(rhd), n));
+		};
+	};
+
 	template <typename InpIter1, typename InpIter2>
-	bool	equal(InpIter1 first1, InpIter1 last, InpIter2 first2)
+	bool	_equal(InpIter1 first1, InpIter1 last, InpIter2 first2, false_type)
 	{
 		while (first1 != last)
 		{
@@ -15,6 +129,22 @@ namespace ft {
 		return (true);
 	};
 
+	// memcmp в glibc сам выбирает SSE2/AVX2 реализацию
+	template <typename InpIter1, typename InpIter2>
+	bool	_equal(InpIter1 first1, InpIter1 last, InpIter2 first2, true_type)
+	{
+		std::size_t	n = last - first1;
+
+		return (!n || !std::memcmp(_contiguous<InpIter1>::address(first1), _contiguous<InpIter2>::address(first2),
+			n * sizeof(typename _contiguous<InpIter1>::value_type)));
+	};
+
+	template <typename InpIter1, typename InpIter2>
+	bool	equal(InpIter1 first1, InpIter1 last, InpIter2 first2)
+	{
+		return (_equal(first1, last, first2, _bytewise_comparable<InpIter1, InpIter2>()));
+	};
+
 	template <typename InpIter1, typename InpIter2, typename BinPred>
 	bool	equal(InpIter1 first1, InpIter1 last, InpIter2 first2, BinPred pred)
 	{
@@ -30,7 +160,7 @@ namespace ft {
 
 	// Cравнение строк
 	template <typename InpIter1, typename InpIter2>
-	bool	lexicographical_compare(InpIter1 first1, InpIter1 last, InpIter2 first2, InpIter2 last2)
+	bool	_lexicographical_compare(InpIter1 first1, InpIter1 last, InpIter2 first2, InpIter2 last2, false_type)
 	{
 		while (first1 != last)
 		{
@@ -45,14 +175,42 @@ namespace ft {
 		return (first2 != last2);
 	};
 
+	// Векторным ядром ищем первый несовпавший байт, сравниваем только содержащий его элемент
+	template <typename InpIter1, typename InpIter2>
+	bool	_lexicographical_compare(InpIter1 first1, InpIter1 last, InpIter2 first2, InpIter2 last2, true_type)
+	{
+		typedef typename _contiguous<InpIter1>::value_type	value_type;
+
+		std::size_t	n1 = last - first1;
+		std::size_t	n2 = last2 - first2;
+		std::size_t	n = n1 < n2 ? n1 : n2;
+
+		if (!n)
+			return (n1 < n2);
+
+		const value_type *	lhd = _contiguous<InpIter1>::address(first1);
+		const value_type *	rhd = _contiguous<InpIter2>::address(first2);
+		std::size_t			i = _mismatch_kernel::run(lhd, rhd, n * sizeof(value_type)) / sizeof(value_type);
+
+		if (i < n)
+			return (lhd[i] < rhd[i]);
+		return (n1 < n2);
+	};
+
+	template <typename InpIter1, typename InpIter2>
+	bool	lexicographical_compare(InpIter1 first1, InpIter1 last, InpIter2 first2, InpIter2 last2)
+	{
+		return (_lexicographical_compare(first1, last, first2, last2, _bytewise_comparable<InpIter1, InpIter2>()));
+	};
+
 	template <typename InpIter1, typename InpIter2, typename Comparator>
 	bool	lexicographical_compare(InpIter1 first1, InpIter1 last, InpIter2 first2, InpIter2 last2, Comparator comp)
 	{
 		while (first1 != last)
 		{
-			if (first2 == last2 || comp(*first1, *first2))
+			if (first2 == last2 || comp(*first2, *first1))
 				return (false);
-			if (!comp(*first1, *first2))
+			if (comp(*first1, *first2))
 				return (true);
 			first1++;
 			first2++;
@@ -60,6 +218,499 @@ namespace ft {
 
 		return (first2 != last2);
 	};
+
+	// Сортировки
+
+	struct _less
+	{
+		template <typename T>
+		bool	operator()(const T & lhd, const T & rhd)	const { return (lhd < rhd); };
+	};
+
+	// Сырой буфер, элементы в котором конструируются копированием по мере надобности
+	template <typename T>
+	struct _temporary_buffer
+	{
+		std::allocator<T>	allocator;
+		T *					data;
+		std::size_t			capacity;
+		std::size_t			size;
+
+		explicit _temporary_buffer(std::size_t n) : data(allocator.allocate(n)), capacity(n), size(0) {};
+
+		~_temporary_buffer()
+		{
+			while (this->size)
+				this->allocator.destroy(this->data + --this->size);
+			this->allocator.deallocate(this->data, this->capacity);
+		};
+
+		template <typename InpIter>
+		void	assign(InpIter first, std::size_t n)
+		{
+			for (; this->size < n; ++first)
+			{
+				this->allocator.construct(this->data + this->size, *first);
+				this->size++;
+			}
+		};
+
+		private:
+			_temporary_buffer(const _temporary_buffer &);
+			_temporary_buffer &	operator=(const _temporary_buffer &);
+	};
+
+	template <typename RandomIt, typename Compare>
+	void	_insertion_sort(RandomIt first, RandomIt last, Compare comp)
+	{
+		typedef typename iterator_traits<RandomIt>::value_type	value_type;
+
+		if (first == last)
+			return ;
+
+		for (RandomIt i = first + 1; i != last; ++i)
+		{
+			value_type	val = *i;
+			RandomIt	hole = i;
+
+			if (comp(val, *first))
+			{
+				for (; hole != first; --hole)
+					*hole = *(hole - 1);
+			}
+			else
+			{
+				// *first не больше val, поэтому граница не проверяется
+				for (RandomIt prev = hole - 1; comp(val, *prev); --prev, --hole)
+					*hole = *prev;
+			}
+			*hole = val;
+		}
+	};
+
+	template <typename RandomIt, typename Compare>
+	void	_sift_down(RandomIt first, typename iterator_traits<RandomIt>::difference_type hole,
+		typename iterator_traits<RandomIt>::difference_type len,
+		typename iterator_traits<RandomIt>::value_type val, Compare comp)
+	{
+		typename iterator_traits<RandomIt>::difference_type	child;
+
+		while ((child = 2 * hole + 1) < len)
+		{
+			if (child + 1 < len && comp(first[child], first[child + 1]))
+				child++;
+			if (!comp(val, first[child]))
+				break ;
+			first[hole] = first[child];
+			hole = child;
+		}
+		first[hole] = val;
+	};
+
+	template <typename RandomIt, typename Compare>
+	void	_heap_sort(RandomIt first, RandomIt last, Compare comp)
+	{
+		typedef typename iterator_traits<RandomIt>::difference_type	difference_type;
+		typedef typename iterator_traits<RandomIt>::value_type		value_type;
+
+		difference_type	n = last - first;
+
+		for (difference_type i = n / 2; i-- > 0; )
+			_sift_down(first, i, n, value_type(first[i]), comp);
+		for (difference_type end = n - 1; end > 0; end--)
+		{
+			value_type	val = first[end];
+
+			first[end] = *first;
+			_sift_down(first, difference_type(0), end, val, comp);
+		}
+	};
+
+	// Медиана из трех ставится в *first и служит опорным элементом,
+	// а минимум и максимум тройки - ограничителями для разбиения без проверок границ
+	template <typename RandomIt, typename Compare>
+	RandomIt	_partition_pivot(RandomIt first, RandomIt last, Compare comp)
+	{
+		RandomIt	a = first + 1;
+		RandomIt	b = first + (last - first) / 2;
+		RandomIt	c = last - 1;
+
+		if (comp(*a, *b))
+		{
+			if (comp(*b, *c))
+				std::swap(*first, *b);
+			else if (comp(*a, *c))
+				std::swap(*first, *c);
+			else
+				std::swap(*first, *a);
+		}
+		else if (comp(*a, *c))
+			std::swap(*first, *a);
+		else if (comp(*b, *c))
+			std::swap(*first, *c);
+		else
+			std::swap(*first, *b);
+
+		RandomIt	lo = first + 1;
+		RandomIt	hi = last;
+
+		for (;;)
+		{
+			while (comp(*lo, *first))
+				++lo;
+			--hi;
+			while (comp(*first, *hi))
+				--hi;
+			if (!(lo < hi))
+				return (lo);
+			std::swap(*lo, *hi);
+			++lo;
+		}
+	};
+
+	static const std::ptrdiff_t	_insertion_sort_threshold = 16;
+
+	template <typename RandomIt, typename Compare>
+	void	_introsort_loop(RandomIt first, RandomIt last, std::size_t depth, Compare comp)
+	{
+		while (last - first > _insertion_sort_threshold)
+		{
+			if (!depth--)
+			{
+				_heap_sort(first, last, comp);
+				return ;
+			}
+
+			RandomIt	cut = _partition_pivot(first, last, comp);
+
+			_introsort_loop(cut, last, depth, comp);
+			last = cut;
+		}
+	};
+
+	// Быстрая сортировка до кусков по 16 элементов, которые досортировывает один
+	// проход вставками; при слишком глубокой рекурсии - пирамидальная
+	template <typename RandomIt, typename Compare>
+	void	_introsort(RandomIt first, RandomIt last, Compare comp)
+	{
+		std::size_t	depth = 0;
+
+		for (std::size_t n = last - first; n > 1; n >>= 1)
+			depth += 2;
+
+		_introsort_loop(first, last, depth, comp);
+		_insertion_sort(first, last, comp);
+	};
+
+	static const std::ptrdiff_t	_merge_sort_threshold = 32;
+
+	// Левая половина копируется в общий буфер и сливается обратно с правой
+	template <typename RandomIt, typename T, typename Compare>
+	void	_merge_sort(RandomIt first, RandomIt last, T * buffer, Compare comp)
+	{
+		if (last - first <= _merge_sort_threshold)
+		{
+			_insertion_sort(first, last, comp);
+			return ;
+		}
+
+		RandomIt	middle = first + (last - first) / 2;
+
+		_merge_sort(first, middle, buffer, comp);
+		_merge_sort(middle, last, buffer, comp);
+		if (!comp(*middle, *(middle - 1)))
+			return ;
+
+		T *	left = buffer;
+		T *	left_end = buffer;
+
+		for (RandomIt it = first; it != middle; ++it)
+			*left_end++ = *it;
+		for (; left != left_end && middle != last; ++first)
+		{
+			if (comp(*middle, *left))
+				*first = *middle++;
+			else
+				*first = *left++;
+		}
+		for (; left != left_end; ++first)
+			*first = *left++;
+	};
+
+	template <typename RandomIt, typename Compare>
+	void	_stable_sort(RandomIt first, RandomIt last, Compare comp)
+	{
+		typedef typename iterator_traits<RandomIt>::value_type	value_type;
+
+		std::size_t	n = last - first;
+
+		if (n <= static_cast<std::size_t>(_merge_sort_threshold))
+		{
+			_insertion_sort(first, last, comp);
+			return ;
+		}
+
+		_temporary_buffer<value_type>	buffer(n / 2 + 1);
+
+		buffer.assign(first, n / 2 + 1);
+		_merge_sort(first, last, buffer.data, comp);
+	};
+
+	// Поразрядная сортировка
+
+	template <typename T>
+	struct _is_signed_integral : public false_type {};
+
+	template <> struct _is_signed_integral<char> : public integral_constant<bool, (CHAR_MIN < 0)> {};
+	template <> struct _is_signed_integral<wchar_t> : public integral_constant<bool, (WCHAR_MIN < 0)> {};
+	template <> struct _is_signed_integral<signed char> : public true_type {};
+	template <> struct _is_signed_integral<short int> : public true_type {};
+	template <> struct _is_signed_integral<int> : public true_type {};
+	template <> struct _is_signed_integral<long int> : public true_type {};
+	template <> struct _is_signed_integral<long long int> : public true_type {};
+
+	// Ключ как беззнаковое число того же порядка: у знаковых инвертируется старший бит
+	template <typename Key>
+	struct _radix_key
+	{
+		static const std::size_t	passes = sizeof(Key);
+
+		static unsigned long long	bits(Key key)
+		{
+			unsigned long long	u = static_cast<unsigned long long>(key);
+
+			if (_is_signed_integral<Key>::value)
+				u ^= static_cast<unsigned long long>(1) << (sizeof(Key) * CHAR_BIT - 1);
+			return (u);
+		};
+	};
+
+	// Тип ключа: result_type функтора или результат указателя на функцию
+	template <typename KeyFn>
+	struct _key_result
+	{
+		typedef typename _remove_cv<typename KeyFn::result_type>::type	type;
+	};
+
+	template <typename R, typename A>
+	struct _key_result<R (*)(A)>
+	{
+		typedef typename _remove_cv<R>::type	type;
+	};
+
+	template <typename T>
+	struct _identity_key
+	{
+		typedef T	result_type;
+
+		T	operator()(const T & val)	const { return (val); };
+	};
+
+	template <typename SrcIter, typename DstIter, typename KeyFn>
+	void	_radix_scatter(SrcIter src, std::size_t n, DstIter dst, KeyFn key, std::size_t shift, std::size_t * offsets)
+	{
+		typedef typename _key_result<KeyFn>::type	key_type;
+
+		for (std::size_t i = 0; i < n; ++i, ++src)
+			dst[offsets[(_radix_key<key_type>::bits(key(*src)) >> shift) & 0xFF]++] = *src;
+	};
+
+	// LSD по байтам: все гистограммы считаются одним проходом, разряды, в которых
+	// все ключи совпадают, пропускаются. Устойчива, нужен буфер на n элементов
+	template <typename RandomIt, typename KeyFn>
+	void	_radix_sort(RandomIt first, RandomIt last, KeyFn key)
+	{
+		typedef typename iterator_traits<RandomIt>::value_type	value_type;
+		typedef typename _key_result<KeyFn>::type				key_type;
+		typedef _radix_key<key_type>							radix;
+
+		std::size_t	n = last - first;
+
+		if (n < 2)
+			return ;
+
+		std::size_t	counts[radix::passes][256];
+
+		std::memset(counts, 0, sizeof(counts));
+		for (RandomIt it = first; it != last; ++it)
+		{
+			unsigned long long	bits = radix::bits(key(*it));
+
+			for (std::size_t p = 0; p < radix::passes; p++)
+				counts[p][(bits >> (p * 8)) & 0xFF]++;
+		}
+
+		unsigned long long	head = radix::bits(key(*first));
+		std::size_t			active[radix::passes];
+		std::size_t			active_count = 0;
+
+		for (std::size_t p = 0; p < radix::passes; p++)
+			if (counts[p][(head >> (p * 8)) & 0xFF] != n)
+				active[active_count++] = p;
+		if (!active_count)
+			return ;
+
+		_temporary_buffer<value_type>	buffer(n);
+		bool							in_buffer = true;
+
+		buffer.assign(first, n);
+		for (std::size_t i = 0; i < active_count; i++)
+		{
+			std::size_t *	offsets = counts[active[i]];
+			std::size_t		sum = 0;
+
+			for (std::size_t d = 0; d < 256; d++)
+			{
+				std::size_t	c = offsets[d];
+
+				offsets[d] = sum;
+				sum += c;
+			}
+
+			if (in_buffer)
+				_radix_scatter(buffer.data, n, first, key, active[i] * 8, offsets);
+			else
+				_radix_scatter(first, n, buffer.data, key, active[i] * 8, offsets);
+			in_buffer = !in_buffer;
+		}
+
+		if (!in_buffer)
+			return ;
+		for (std::size_t i = 0; i < n; ++i, ++first)
+			*first = buffer.data[i];
+	};
+
+	// Ниже этого размера сравнения дешевле подсчета гистограмм
+	static const std::size_t	_radix_sort_threshold = 1024;
+
+	template <typename RandomIt>
+	void	_sort(RandomIt first, RandomIt last, true_type)
+	{
+		typedef typename iterator_traits<RandomIt>::value_type	value_type;
+
+		if (static_cast<std::size_t>(last - first) >= _radix_sort_threshold)
+			_radix_sort(first, last, _identity_key<value_type>());
+		else
+			_introsort(first, last, _less());
+	};
+
+	template <typename RandomIt>
+	void	_sort(RandomIt first, RandomIt last, false_type)
+	{
+		_introsort(first, last, _less());
+	};
+
+	template <typename RandomIt>
+	void	_stable_sort(RandomIt first, RandomIt last, true_type)
+	{
+		typedef typename iterator_traits<RandomIt>::value_type	value_type;
+
+		if (static_cast<std::size_t>(last - first) >= _radix_sort_threshold)
+			_radix_sort(first, last, _identity_key<value_type>());
+		else
+			_stable_sort(first, last, _less());
+	};
+
+	template <typename RandomIt>
+	void	_stable_sort(RandomIt first, RandomIt last, false_type)
+	{
+		_stable_sort(first, last, _less());
+	};
+
+	// Целые сортируются поразрядно, остальное - интроспективно
+	template <typename RandomIt>
+	void	sort(RandomIt first, RandomIt last)
+	{
+		_sort(first, last, typename is_integral<typename iterator_traits<RandomIt>::value_type>::type());
+	};
+
+	template <typename RandomIt, typename Compare>
+	void	sort(RandomIt first, RandomIt last, Compare comp)
+	{
+		_introsort(first, last, comp);
+	};
+
+	template <typename RandomIt>
+	void	stable_sort(RandomIt first, RandomIt last)
+	{
+		_stable_sort(first, last, typename is_integral<typename iterator_traits<RandomIt>::value_type>::type());
+	};
+
+	template <typename RandomIt, typename Compare>
+	void	stable_sort(RandomIt first, RandomIt last, Compare comp)
+	{
+		_stable_sort(first, last, comp);
+	};
+
+	template <typename RandomIt>
+	typename enable_if<is_integral<typename iterator_traits<RandomIt>::value_type>::value>::type
+		radix_sort(RandomIt first, RandomIt last)
+	{
+		_radix_sort(first, last, _identity_key<typename iterator_traits<RandomIt>::value_type>());
+	};
+
+	// Устойчивая сортировка записей по целому ключу: key - функтор с result_type
+	// (например, наследник std::unary_function) или указатель на функцию
+	template <typename RandomIt, typename KeyFn>
+	typename enable_if<is_integral<typename _key_result<KeyFn>::type>::value>::type
+		radix_sort(RandomIt first, RandomIt last, KeyFn key)
+	{
+		_radix_sort(first, last, key);
+	};
+
+	// Слияние и удаление повторов
+
+	// Из равных первым идет элемент первого диапазона, как в std::merge
+	template <typename InpIter1, typename InpIter2, typename OutIter, typename Compare>
+	OutIter	merge(InpIter1 first1, InpIter1 last1, InpIter2 first2, InpIter2 last2, OutIter out, Compare comp)
+	{
+		for (; first1 != last1 && first2 != last2; ++out)
+		{
+			if (comp(*first2, *first1))
+				*out = *first2++;
+			else
+				*out = *first1++;
+		}
+		for (; first1 != last1; ++first1, ++out)
+			*out = *first1;
+		for (; first2 != last2; ++first2, ++out)
+			*out = *first2;
+		return (out);
+	};
+
+	template <typename InpIter1, typename InpIter2, typename OutIter>
+	OutIter	merge(InpIter1 first1, InpIter1 last1, InpIter2 first2, InpIter2 last2, OutIter out)
+	{
+		return (ft::merge(first1, last1, first2, last2, out, _less()));
+	};
+
+	struct _equal_to
+	{
+		template <typename T>
+		bool	operator()(const T & lhd, const T & rhd)	const { return (lhd == rhd); };
+	};
+
+	// Из каждой серии подряд идущих равных остается первый;
+	// pred получает последний оставленный и очередной элементы
+	template <typename ForwardIt, typename BinPred>
+	ForwardIt	unique(ForwardIt first, ForwardIt last, BinPred pred)
+	{
+		if (first == last)
+			return (last);
+
+		ForwardIt	result = first;
+
+		while (++first != last)
+			if (!pred(*result, *first))
+				*++result = *first;
+		return (++result);
+	};
+
+	template <typename ForwardIt>
+	ForwardIt	unique(ForwardIt first, ForwardIt last)
+	{
+		return (ft::unique(first, last, _equal_to()));
+	};
 };
 
 #endif
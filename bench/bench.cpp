@@ -0,0 +1,1792 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <fcntl.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "perf.hpp"
+#include "mmap_allocator.hpp"
+
+// Тот же переключатель, что и в main.cpp: TEST_STL=0 собирает std::.
+// Псевдоним namespace ft = std невозможен рядом с ft::perf, поэтому using
+#ifndef TEST_STL
+# define TEST_STL 1
+#endif
+#if !TEST_STL
+	#include <map>
+	#include <set>
+	#include <stack>
+	#include <vector>
+	namespace ft
+	{
+		using std::vector;
+		using std::map;
+		using std::set;
+		using std::stack;
+		using std::make_pair;
+		using std::pair;
+		using std::sort;
+		using std::stable_sort;
+	}
+	#define LIBRARY "std"
+#else
+	#include "concurrent_stack.hpp"
+	#include "cow_map.hpp"
+	#include "deque.hpp"
+	#include "interval_map.hpp"
+	#include "map.hpp"
+	#include "mapped_vector.hpp"
+	#include "memory_resource.hpp"
+	#include "parallel.hpp"
+	#include "parallel_build.hpp"
+	#include "set.hpp"
+	#include "stack.hpp"
+	#include "vector.hpp"
+	#define LIBRARY "ft"
+#endif
+
+#define SEED 42
+#define DEFAULT_COUNT 1000000
+#define QUADRATIC_COUNT 20000
+#define ZIPF_EXPONENT 0.99
+
+static volatile long	g_sink;
+
+using ft::perf::now_ns;
+
+struct Random
+{
+	uint64_t	state;
+
+	explicit Random(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+	uint64_t	next(void)
+	{
+		this->state ^= this->state << 13;
+		this->state ^= this->state >> 7;
+		this->state ^= this->state << 17;
+		return (this->state);
+	}
+};
+
+// Ключи в порядке обращений: случайные, по возрастанию и по Ципфу.
+// Ранги Ципфа перемешиваются, чтобы популярные ключи не лежали рядом
+enum Distribution { RANDOM, SORTED, ZIPF };
+
+static const char *	distribution_name(Distribution d)
+{
+	return (d == RANDOM ? "random" : d == SORTED ? "sorted" : "zipf");
+}
+
+static std::vector<int>	make_keys(Distribution d, size_t n, uint64_t seed)
+{
+	std::vector<int>	keys(n);
+	Random				rng(seed);
+
+	if (d == SORTED)
+		for (size_t i = 0; i < n; i++)
+			keys[i] = static_cast<int>(i);
+	else if (d == RANDOM)
+		for (size_t i = 0; i < n; i++)
+			keys[i] = static_cast<int>(rng.next() >> 33);
+	else
+	{
+		std::vector<double>	cdf(n);
+		double				sum = 0;
+
+		for (size_t i = 0; i < n; i++)
+			cdf[i] = (sum += 1.0 / std::pow(static_cast<double>(i + 1), ZIPF_EXPONENT));
+		for (size_t i = 0; i < n; i++)
+		{
+			double	u = static_cast<double>(rng.next() >> 11) / 9007199254740992.0 * sum;
+			size_t	rank = std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin();
+
+			keys[i] = static_cast<int>((rank * 2654435761u) & 0x7FFFFFFF);
+		}
+	}
+	return (keys);
+}
+
+// Нагрузка: prepare() вне замера, затем op(i) для i в [0, ops())
+struct Workload
+{
+	virtual ~Workload() {}
+	virtual const char *	name(void) const = 0;
+	virtual size_t			ops(void) const = 0;
+	virtual void			prepare(void) = 0;
+	virtual void			op(size_t i) = 0;
+	virtual void			finish(void) {}
+	// Байт кучи на элемент после прохода, если нагрузка их считает
+	virtual double			bytes_per_element(void) const { return (-1); }
+};
+
+struct VectorPushBack : Workload
+{
+	size_t				n;
+	ft::vector<int>		v;
+
+	explicit VectorPushBack(size_t n) : n(n) {}
+	const char *	name(void) const { return ("vector_push_back"); }
+	size_t			ops(void) const { return (this->n); }
+	void			prepare(void) { ft::vector<int>().swap(this->v); }
+	void			op(size_t i) { this->v.push_back(static_cast<int>(i)); }
+	void			finish(void) { g_sink += this->v.size(); }
+};
+
+struct VectorInsert : Workload
+{
+	size_t				n;
+	std::vector<size_t>	positions;
+	ft::vector<int>		v;
+
+	explicit VectorInsert(size_t n) : n(n), positions(n)
+	{
+		Random	rng(SEED);
+
+		for (size_t i = 0; i < n; i++)
+			this->positions[i] = rng.next() % (i + 1);
+	}
+	const char *	name(void) const { return ("vector_insert"); }
+	size_t			ops(void) const { return (this->n); }
+	void			prepare(void) { ft::vector<int>().swap(this->v); }
+	void			op(size_t i) { this->v.insert(this->v.begin() + this->positions[i], static_cast<int>(i)); }
+	void			finish(void) { g_sink += this->v.size(); }
+};
+
+struct VectorErase : Workload
+{
+	size_t				n;
+	std::vector<size_t>	positions;
+	ft::vector<int>		v;
+
+	explicit VectorErase(size_t n) : n(n), positions(n)
+	{
+		Random	rng(SEED);
+
+		for (size_t i = 0; i < n; i++)
+			this->positions[i] = rng.next() % (n - i);
+	}
+	const char *	name(void) const { return ("vector_erase"); }
+	size_t			ops(void) const { return (this->n); }
+	void			prepare(void) { ft::vector<int>(this->n, 1).swap(this->v); }
+	void			op(size_t i) { this->v.erase(this->v.begin() + this->positions[i]); }
+	void			finish(void) { g_sink += this->v.size(); }
+};
+
+struct VectorIterate : Workload
+{
+	size_t						n;
+	ft::vector<int>				v;
+	ft::vector<int>::iterator	it;
+	long						sum;
+
+	explicit VectorIterate(size_t n) : n(n), sum(0) {}
+	const char *	name(void) const { return ("vector_iterate"); }
+	size_t			ops(void) const { return (this->n); }
+	void			prepare(void)
+	{
+		ft::vector<int>(this->n, 1).swap(this->v);
+		this->it = this->v.begin();
+		this->sum = 0;
+	}
+	void			op(size_t)
+	{
+		this->sum += *this->it;
+		++this->it;
+	}
+	void			finish(void) { g_sink += this->sum + (this->it == this->v.end()); }
+};
+
+static const char *	element_name(const int &) { return ("int"); }
+static const char *	element_name(const std::string &) { return ("string"); }
+static int			make_element(int key, const int &) { return (key); }
+static std::string	make_element(int key, const std::string &)
+{
+	std::ostringstream	out;
+
+	out << key;
+	return (out.str());
+}
+
+// Снимок рабочего вектора, который каждый раз копируется заново: источники
+// в n, 3n/4, n/2 и n/4 элементов по кругу, приемник один. operator= пишет
+// поверх живых элементов, достраивает хвост и разрушает лишнее, не выделяя
+template <typename T>
+struct VectorSnapshot : Workload
+{
+	ft::vector<T>	sources[4];
+	ft::vector<T>	snapshot;
+	char			label[64];
+
+	explicit VectorSnapshot(size_t n)
+	{
+		std::vector<int>	keys = make_keys(RANDOM, n, SEED);
+
+		for (size_t k = 0; k < 4; k++)
+			for (size_t i = 0; i < n * (4 - k) / 4; i++)
+				this->sources[k].push_back(make_element(keys[i], T()));
+		snprintf(this->label, sizeof(this->label), "vector_snapshot_%s", element_name(T()));
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (64); }
+	void			prepare(void) { ft::vector<T>().swap(this->snapshot); }
+	void			op(size_t i)
+	{
+		this->snapshot = this->sources[i % 4];
+		g_sink += this->snapshot.size();
+	}
+};
+
+// Вектор из двунаправленного диапазона map: длина считается заранее,
+// одно выделение вместо удвоений
+struct VectorFromMap : Workload
+{
+	ft::map<int, int>	m;
+
+	explicit VectorFromMap(size_t n)
+	{
+		std::vector<int>	keys = make_keys(RANDOM, n, SEED);
+
+		for (size_t i = 0; i < n; i++)
+			this->m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+	}
+	const char *	name(void) const { return ("vector_from_map"); }
+	size_t			ops(void) const { return (8); }
+	void			prepare(void) {}
+	void			op(size_t)
+	{
+		ft::vector<ft::pair<int, int> >	v(this->m.begin(), this->m.end());
+
+		g_sink += v.size() + v.capacity();
+	}
+};
+
+// Чтение n чисел из потока через istream_iterator: однопроходный диапазон,
+// вектор растет по мере чтения
+struct VectorFromStream : Workload
+{
+	std::string		text;
+
+	explicit VectorFromStream(size_t n)
+	{
+		std::vector<int>	keys = make_keys(RANDOM, n, SEED);
+		std::ostringstream	out;
+
+		for (size_t i = 0; i < n; i++)
+			out << keys[i] << ' ';
+		this->text = out.str();
+	}
+	const char *	name(void) const { return ("vector_from_stream"); }
+	size_t			ops(void) const { return (4); }
+	void			prepare(void) {}
+	void			op(size_t)
+	{
+		std::istringstream	in(this->text);
+		ft::vector<int>		v((std::istream_iterator<int>(in)), std::istream_iterator<int>());
+
+		g_sink += v.size();
+	}
+};
+
+// Буфер под входные данные, который тут же целиком перезаписывается
+// (чтение файла, декодирование): resize обнуляет bytes байт и потом их пишут
+// второй раз, resize_default_init оставляет память как есть. Операция -
+// выделение, заполнение и освобождение, minor_faults - страницы, тронутые впервые
+template <bool Default>
+struct VectorFill : Workload
+{
+	size_t	bytes;
+	char	label[64];
+
+	explicit VectorFill(size_t bytes) : bytes(bytes)
+	{
+		snprintf(this->label, sizeof(this->label), "vector_fill_%s_%zu", Default ? "default_init" : "resize", bytes);
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (2); }
+	void			prepare(void) {}
+	void			op(size_t i)
+	{
+		ft::vector<char>	buffer;
+
+#if TEST_STL
+		if (Default)
+			buffer.resize_default_init(this->bytes);
+		else
+#endif
+			buffer.resize(this->bytes);
+		std::memset(&buffer[0], static_cast<int>(i) + 1, this->bytes);
+		g_sink += buffer[this->bytes / 2];
+	}
+};
+
+// Сравнение двух векторов по bytes байт, различие только в последнем байте,
+// так что просматривается все. Операций столько, чтобы пройти около 256 МиБ
+template <bool Ordering>
+struct VectorCompare : Workload
+{
+	size_t					bytes;
+	ft::vector<signed char>	lhd;
+	ft::vector<signed char>	rhd;
+	char					label[64];
+
+	explicit VectorCompare(size_t bytes) : bytes(bytes)
+	{
+		snprintf(this->label, sizeof(this->label), "vector_%s_%zu", Ordering ? "less" : "equal", bytes);
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (this->bytes < (size_t(256) << 20) ? (size_t(256) << 20) / this->bytes : 1); }
+	void			prepare(void)
+	{
+		Random	rng(SEED);
+
+		this->lhd.resize(this->bytes);
+		for (size_t i = 0; i < this->bytes; i++)
+			this->lhd[i] = static_cast<signed char>(rng.next());
+		this->rhd = this->lhd;
+		this->rhd[this->bytes - 1] = static_cast<signed char>(this->lhd[this->bytes - 1] + 1);
+	}
+	void			op(size_t)
+	{
+		if (Ordering)
+			g_sink += this->lhd < this->rhd;
+		else
+			g_sink += this->lhd == this->rhd;
+	}
+};
+
+struct SortRecord
+{
+	int		key;
+	int		payload;
+};
+
+struct SortRecordLess
+{
+	bool	operator()(const SortRecord & lhd, const SortRecord & rhd) const { return (lhd.key < rhd.key); }
+};
+
+// Одна сортировка n элементов за операцию, размер 1e6-1e8 задается аргументом bench.
+// int без компаратора в ft идут поразрядно, записи с компаратором - сравнениями
+template <typename T, bool Stable>
+struct SortWorkload : Workload
+{
+	std::vector<T>	input;
+	ft::vector<T>	v;
+	char			label[64];
+
+	SortWorkload(const char * kind, size_t n) : input(n)
+	{
+		snprintf(this->label, sizeof(this->label), "%s_%s_random", Stable ? "stable_sort" : "sort", kind);
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (1); }
+	void			prepare(void) { ft::vector<T>(this->input.begin(), this->input.end()).swap(this->v); }
+	void			finish(void) { g_sink += this->v.size(); }
+};
+
+template <bool Stable>
+struct SortInts : SortWorkload<int, Stable>
+{
+	explicit SortInts(size_t n) : SortWorkload<int, Stable>("int", n)
+	{
+		std::vector<int>	keys = make_keys(RANDOM, n, SEED);
+
+		for (size_t i = 0; i < n; i++)
+			this->input[i] = keys[i] - 0x40000000;
+	}
+	void	op(size_t)
+	{
+		if (Stable)
+			ft::stable_sort(this->v.begin(), this->v.end());
+		else
+			ft::sort(this->v.begin(), this->v.end());
+	}
+};
+
+template <bool Stable>
+struct SortRecords : SortWorkload<SortRecord, Stable>
+{
+	explicit SortRecords(size_t n) : SortWorkload<SortRecord, Stable>("records", n)
+	{
+		std::vector<int>	keys = make_keys(RANDOM, n, SEED);
+
+		for (size_t i = 0; i < n; i++)
+		{
+			this->input[i].key = keys[i];
+			this->input[i].payload = static_cast<int>(i);
+		}
+	}
+	void	op(size_t)
+	{
+		if (Stable)
+			ft::stable_sort(this->v.begin(), this->v.end(), SortRecordLess());
+		else
+			ft::sort(this->v.begin(), this->v.end(), SortRecordLess());
+	}
+};
+
+struct MapWorkload : Workload
+{
+	Distribution		distribution;
+	std::vector<int>	keys;
+	ft::map<int, int>	m;
+	char				label[64];
+
+	MapWorkload(const char * kind, Distribution d, size_t n)
+		: distribution(d), keys(make_keys(d, n, SEED))
+	{
+		snprintf(this->label, sizeof(this->label), "map_%s_%s", kind, distribution_name(d));
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (this->keys.size()); }
+
+	void	fill(void)
+	{
+		ft::map<int, int>().swap(this->m);
+		for (size_t i = 0; i < this->keys.size(); i++)
+			this->m.insert(ft::make_pair(this->keys[i], static_cast<int>(i)));
+	}
+	void	finish(void) { g_sink += this->m.size(); }
+};
+
+struct MapInsert : MapWorkload
+{
+	MapInsert(Distribution d, size_t n) : MapWorkload("insert", d, n) {}
+	void	prepare(void) { ft::map<int, int>().swap(this->m); }
+	void	op(size_t i) { this->m.insert(ft::make_pair(this->keys[i], static_cast<int>(i))); }
+};
+
+// Поиск идет по ключам того же распределения, но с другим зерном:
+// для random и zipf часть запросов промахивается
+struct MapFind : MapWorkload
+{
+	std::vector<int>	queries;
+
+	MapFind(Distribution d, size_t n) : MapWorkload("find", d, n), queries(make_keys(d, n, SEED + 1))
+	{
+		if (d == SORTED)
+			this->queries = this->keys;
+	}
+	void	prepare(void) { this->fill(); }
+	void	op(size_t i) { g_sink += this->m.find(this->queries[i]) != this->m.end(); }
+};
+
+struct MapErase : MapWorkload
+{
+	MapErase(Distribution d, size_t n) : MapWorkload("erase", d, n) {}
+	void	prepare(void) { this->fill(); }
+	void	op(size_t i) { g_sink += this->m.erase(this->keys[i]); }
+};
+
+struct MapIterate : MapWorkload
+{
+	ft::map<int, int>::iterator	it;
+	long						sum;
+
+	explicit MapIterate(size_t n) : MapWorkload("iterate", RANDOM, n), sum(0) {}
+	size_t	ops(void) const { return (this->m.size()); }
+	void	prepare(void)
+	{
+		this->fill();
+		this->it = this->m.begin();
+		this->sum = 0;
+	}
+	void	op(size_t)
+	{
+		this->sum += this->it->second;
+		++this->it;
+	}
+	void	finish(void) { g_sink += this->sum + (this->it == this->m.end()); }
+};
+
+struct SumValues
+{
+	long	sum;
+
+	SumValues(void) : sum(0) {}
+	bool	operator()(const ft::pair<const int, int> & value)
+	{
+		this->sum += value.second;
+		return (true);
+	}
+};
+
+enum ScanMode { SCAN_ITERATOR, SCAN_ITERATOR_RANGE, SCAN_FOR_EACH, SCAN_FOR_EACH_RANGE };
+
+static const char *	scan_name(ScanMode mode)
+{
+	static const char *	names[] = { "scan_iterator", "scan_iterator_range", "scan_for_each", "scan_for_each_range" };
+
+	return (names[mode]);
+}
+
+// Полный проход по map (или по средней половине ключей): цикл по итераторам
+// против for_each/for_each_in_range. Операция - один проход; размер map - n,
+// так что масштаб 1e6-1e8 задается аргументом bench
+static const int	g_scan_lo = 0x7FFFFFFF / 4;
+static const int	g_scan_hi = 0x7FFFFFFF / 4 * 3;
+
+template <ScanMode Mode>
+struct MapScan : MapWorkload
+{
+	explicit MapScan(size_t n) : MapWorkload(scan_name(Mode), RANDOM, n) {}
+	size_t	ops(void) const { return (8); }
+	void	prepare(void) { this->fill(); }
+	void	op(size_t)
+	{
+		SumValues	sum;
+
+		if (Mode == SCAN_ITERATOR || Mode == SCAN_ITERATOR_RANGE)
+		{
+			ft::map<int, int>::iterator	it = Mode == SCAN_ITERATOR ? this->m.begin() : this->m.lower_bound(g_scan_lo);
+			ft::map<int, int>::iterator	last = Mode == SCAN_ITERATOR ? this->m.end() : this->m.upper_bound(g_scan_hi);
+
+			for (; it != last; ++it)
+				sum(*it);
+		}
+#if TEST_STL
+		else if (Mode == SCAN_FOR_EACH)
+			sum = this->m.for_each(sum);
+		else
+			sum = this->m.for_each_in_range(g_scan_lo, g_scan_hi, sum);
+#endif
+		g_sink += sum.sum;
+	}
+};
+
+// Сборка map из n несортированных пар: цикл insert против build_parallel
+// на 1..N потоках. Операция - одна сборка с нуля в свой map, чтобы в замер
+// не попадало освобождение предыдущего
+struct MapBuild : Workload
+{
+	std::vector<ft::pair<int, int> >	input;
+	ft::map<int, int>					maps[4];
+	size_t								threads;
+	char								label[64];
+
+	MapBuild(size_t n, size_t threads) : threads(threads)
+	{
+		std::vector<int>	keys = make_keys(RANDOM, n, SEED);
+
+		for (size_t i = 0; i < n; i++)
+			this->input.push_back(ft::make_pair(keys[i], static_cast<int>(i)));
+		if (threads)
+			snprintf(this->label, sizeof(this->label), "map_build_parallel_t%zu", threads);
+		else
+			snprintf(this->label, sizeof(this->label), "map_build_insert");
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (4); }
+	void			prepare(void)
+	{
+		for (size_t i = 0; i < 4; i++)
+			ft::map<int, int>().swap(this->maps[i]);
+	}
+	void			op(size_t i)
+	{
+		if (!this->threads)
+			for (size_t k = 0; k < this->input.size(); k++)
+				this->maps[i].insert(this->input[k]);
+#if TEST_STL
+		else
+			this->maps[i].build_parallel(this->input.begin(), this->input.end(), this->threads);
+#endif
+	}
+	void			finish(void) { g_sink += this->maps[3].size(); }
+};
+
+struct MapBuildInsert : MapBuild
+{
+	explicit MapBuildInsert(size_t n) : MapBuild(n, 0) {}
+};
+
+static const char *	copy_name(const ft::map<int, int> &) { return ("map"); }
+static void			write_key(ft::map<int, int> & m, int key, int value) { m[key] = value; }
+#if TEST_STL
+static const char *	copy_name(const ft::cow_map<int, int> &) { return ("cow_map"); }
+static void			write_key(ft::cow_map<int, int> & m, int key, int value) { m.assign(key, value); }
+#endif
+
+// Обработчик запроса копирует общий map из n / 10 ключей, читает из копии
+// 16 ключей и, при Write, пишет один. ft::map копирует все узлы, cow_map
+// делит дерево и при записи копирует один путь. Уничтожение копии входит в замер
+template <class Map, bool Write>
+struct CopyThen : Workload
+{
+	static const size_t	copies = 100;
+
+	Map					original;
+	std::vector<int>	keys;
+	char				label[64];
+
+	explicit CopyThen(size_t n) : keys(make_keys(RANDOM, 16 * copies, SEED))
+	{
+		size_t	size = n / 10 + 1;
+
+		for (size_t i = 0; i < size; i++)
+			this->original.insert(ft::make_pair(static_cast<int>(i), static_cast<int>(i)));
+		for (size_t i = 0; i < this->keys.size(); i++)
+			this->keys[i] %= static_cast<int>(size);
+		snprintf(this->label, sizeof(this->label), "%s_copy_then_%s", copy_name(this->original), Write ? "write" : "read");
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (copies); }
+	void			prepare(void) {}
+	void			op(size_t i)
+	{
+		Map		copy(this->original);
+		long	sum = 0;
+
+		for (size_t k = i * 16; k < i * 16 + 16; k++)
+			sum += copy.find(this->keys[k])->second;
+		if (Write)
+			write_key(copy, this->keys[i * 16], static_cast<int>(i));
+		g_sink += sum + copy.size();
+	}
+};
+
+enum RebalanceMode { REBALANCE_ERASE_INSERT, REBALANCE_EXTRACT, REBALANCE_MERGE };
+
+static const char *	rebalance_name(RebalanceMode mode)
+{
+	static const char *	names[] = { "erase_insert", "extract_insert", "merge" };
+
+	return (names[mode]);
+}
+
+// Перебалансировка шардов: n ключей по кругу в 8 map, операция i переносит
+// все записи шарда i в шард i + 1, так что к концу последний шард держит
+// все n. Копия в insert с erase выделяет и освобождает узел на каждую запись,
+// extract/insert(node) и merge перевешивают узлы без выделений
+template <RebalanceMode Mode>
+struct ShardRebalance : Workload
+{
+	static const size_t	shards_count = 8;
+
+	std::vector<int>	keys;
+	ft::map<int, int>	shards[shards_count];
+	char				label[64];
+
+	explicit ShardRebalance(size_t n) : keys(make_keys(RANDOM, n, SEED))
+	{
+		snprintf(this->label, sizeof(this->label), "map_rebalance_%s", rebalance_name(Mode));
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (shards_count - 1); }
+	void			prepare(void)
+	{
+		for (size_t s = 0; s < shards_count; s++)
+			ft::map<int, int>().swap(this->shards[s]);
+		for (size_t i = 0; i < this->keys.size(); i++)
+			this->shards[i % shards_count].insert(ft::make_pair(this->keys[i], static_cast<int>(i)));
+	}
+	void			op(size_t i)
+	{
+		ft::map<int, int> &	source = this->shards[i];
+		ft::map<int, int> &	target = this->shards[i + 1];
+
+		if (Mode == REBALANCE_ERASE_INSERT)
+			while (!source.empty())
+			{
+				target.insert(*source.begin());
+				source.erase(source.begin());
+			}
+#if TEST_STL
+		else if (Mode == REBALANCE_EXTRACT)
+			while (!source.empty())
+			{
+				ft::map<int, int>::node_type	node = source.extract(source.begin());
+
+				target.insert(node);
+			}
+		else
+			target.merge(source);
+#endif
+	}
+	void			finish(void) { g_sink += this->shards[shards_count - 1].size(); }
+};
+
+enum SetOp { SET_UNION, SET_INTERSECTION, SET_DIFFERENCE, SET_SYMMETRIC_DIFFERENCE };
+
+static const char *	set_op_name(SetOp op)
+{
+	static const char *	names[] = { "union", "intersection", "difference", "symmetric_difference" };
+
+	return (names[op]);
+}
+
+struct PairKeyLess
+{
+	bool	operator()(const ft::pair<const int, int> & lhd, const ft::pair<const int, int> & rhd)	const
+	{
+		return (lhd.first < rhd.first);
+	}
+};
+
+// Операция над двумя map, у которых половина ключей меньшей общая: сравнимого
+// размера (n и n) или перекошенные (n и n / 64, тогда m * log2(n) < n).
+// std:: - std::set_* с вставкой через inserter, ft:: - map_union и др.
+// Операция - одна функция с уничтожением результата
+template <SetOp Op, bool Skewed>
+struct MapSetOp : Workload
+{
+	ft::map<int, int>	a;
+	ft::map<int, int>	b;
+	char				label[64];
+
+	explicit MapSetOp(size_t n)
+	{
+		std::vector<int>	keys = make_keys(RANDOM, n, SEED);
+		std::vector<int>	other = make_keys(RANDOM, n, SEED + 1);
+		size_t				m = Skewed ? n / 64 + 1 : n;
+
+		for (size_t i = 0; i < n; i++)
+			this->a.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+		for (size_t i = 0; i < m; i++)
+			this->b.insert(ft::make_pair(i % 2 ? keys[i * (n / m)] : other[i], -static_cast<int>(i)));
+		snprintf(this->label, sizeof(this->label), "map_%s_%s", set_op_name(Op), Skewed ? "skewed" : "balanced");
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (4); }
+	void			prepare(void) {}
+	void			op(size_t)
+	{
+#if TEST_STL
+		ft::map<int, int>	result = Op == SET_UNION ? ft::map_union(this->a, this->b)
+			: Op == SET_INTERSECTION ? ft::map_intersection(this->a, this->b)
+			: Op == SET_DIFFERENCE ? ft::map_difference(this->a, this->b)
+			: ft::map_symmetric_difference(this->a, this->b);
+#else
+		ft::map<int, int>	result;
+
+		if (Op == SET_UNION)
+			std::set_union(this->a.begin(), this->a.end(), this->b.begin(), this->b.end(),
+				std::inserter(result, result.end()), PairKeyLess());
+		else if (Op == SET_INTERSECTION)
+			std::set_intersection(this->a.begin(), this->a.end(), this->b.begin(), this->b.end(),
+				std::inserter(result, result.end()), PairKeyLess());
+		else if (Op == SET_DIFFERENCE)
+			std::set_difference(this->a.begin(), this->a.end(), this->b.begin(), this->b.end(),
+				std::inserter(result, result.end()), PairKeyLess());
+		else
+			std::set_symmetric_difference(this->a.begin(), this->a.end(), this->b.begin(), this->b.end(),
+				std::inserter(result, result.end()), PairKeyLess());
+#endif
+		g_sink += result.size();
+	}
+};
+
+struct StackPush : Workload
+{
+	size_t				n;
+	ft::stack<int> *	s;
+
+	explicit StackPush(size_t n) : n(n), s(NULL) {}
+	~StackPush() { delete this->s; }
+	const char *	name(void) const { return ("stack_push"); }
+	size_t			ops(void) const { return (this->n); }
+	void			prepare(void)
+	{
+		delete this->s;
+		this->s = new ft::stack<int>();
+	}
+	void			op(size_t i) { this->s->push(static_cast<int>(i)); }
+	void			finish(void) { g_sink += this->s->size(); }
+};
+
+struct StackPop : StackPush
+{
+	explicit StackPop(size_t n) : StackPush(n) {}
+	const char *	name(void) const { return ("stack_pop"); }
+	void			prepare(void)
+	{
+		StackPush::prepare();
+		for (size_t i = 0; i < this->n; i++)
+			this->s->push(static_cast<int>(i));
+	}
+	void			op(size_t)
+	{
+		g_sink += this->s->top();
+		this->s->pop();
+	}
+};
+
+static const char *	backing_name(const std::deque<int> &) { return ("std_deque"); }
+static const char *	backing_name(const ft::vector<int> &) { return ("vector"); }
+#if TEST_STL
+static const char *	backing_name(const ft::deque<int> &) { return ("ft_deque"); }
+#endif
+
+// Один и тот же stack на разных контейнерах: рост с нуля (push) и пила
+// глубиной 64K (sawtooth), где deque берет чанки из запаса, а vector - емкость
+template <class Container, bool Sawtooth>
+struct StackBacking : Workload
+{
+	static const size_t				depth = 65536;
+
+	size_t							n;
+	ft::stack<int, Container> *		s;
+	char							label[64];
+
+	explicit StackBacking(size_t n) : n(n), s(NULL)
+	{
+		snprintf(this->label, sizeof(this->label), "stack_%s_%s", backing_name(Container()), Sawtooth ? "sawtooth" : "push");
+	}
+	~StackBacking() { delete this->s; }
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (this->n); }
+	void			prepare(void)
+	{
+		delete this->s;
+		this->s = new ft::stack<int, Container>();
+	}
+	void			op(size_t i)
+	{
+		if (!Sawtooth || !(i / depth % 2))
+			this->s->push(static_cast<int>(i));
+		else
+		{
+			g_sink += this->s->top();
+			this->s->pop();
+		}
+	}
+	void			finish(void) { g_sink += this->s->size(); }
+};
+
+// Разбор выражений: операция кладет 16 операндов, читает их с вершины,
+// снимает и кладет результат. bulk - push_range/top_n/pop_n, loop - по одному
+template <class Container, bool Bulk>
+struct StackParser : Workload
+{
+	static const size_t				arity = 16;
+
+	std::vector<int>				tokens;
+	ft::stack<int, Container> *		s;
+	char							label[64];
+
+	explicit StackParser(size_t n) : tokens(make_keys(RANDOM, n + arity, SEED)), s(NULL)
+	{
+		snprintf(this->label, sizeof(this->label), "stack_parser_%s_%s", backing_name(Container()), Bulk ? "bulk" : "loop");
+	}
+	~StackParser() { delete this->s; }
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (this->tokens.size() - arity); }
+	void			prepare(void)
+	{
+		delete this->s;
+		this->s = new ft::stack<int, Container>();
+	}
+	void			op(size_t i)
+	{
+		const int *	operands = &this->tokens[i];
+		int			top[arity];
+		int			result = 0;
+
+		if (Bulk)
+		{
+#if TEST_STL
+			this->s->push_range(operands, operands + arity);
+			this->s->top_n(arity, top);
+			this->s->pop_n(arity);
+#endif
+		}
+		else
+		{
+			for (size_t k = 0; k < arity; k++)
+				this->s->push(operands[k]);
+			for (size_t k = 0; k < arity; k++)
+			{
+				top[k] = this->s->top();
+				this->s->pop();
+			}
+		}
+		for (size_t k = 0; k < arity; k++)
+			result ^= top[k];
+		this->s->push(result);
+	}
+	void			finish(void) { g_sink += this->s->size() + this->s->top(); }
+};
+
+static const char *	key_name(int) { return ("int"); }
+static const char *	key_name(long) { return ("long"); }
+
+template <typename K>
+static const char *	container_name(const ft::set<K> &) { return ("set"); }
+template <typename K>
+static const char *	container_name(const ft::map<K, char> &) { return ("map_char"); }
+
+template <typename K>
+static void	insert_key(ft::set<K> & s, int key) { s.insert(key); }
+template <typename K>
+static void	insert_key(ft::map<K, char> & m, int key) { m.insert(ft::make_pair(static_cast<K>(key), char())); }
+
+// Занятые байты кучи вместе с заголовками malloc
+static size_t	heap_in_use(void)
+{
+	return (mallinfo2().uordblks);
+}
+
+// ft::set против map<K, char>, которым множества эмулировали раньше:
+// память на элемент - bytes_per_element вставки, скорость поиска - find.
+// malloc округляет блоки до 16 байт, поэтому с ключом int узлы обоих по 48
+// байт, а с long разница видна
+template <class Set>
+struct KeyWorkload : Workload
+{
+	std::vector<int>	keys;
+	Set					s;
+	char				label[64];
+
+	KeyWorkload(const char * kind, Distribution d, size_t n) : keys(make_keys(d, n, SEED))
+	{
+		snprintf(this->label, sizeof(this->label), "%s_%s_%s_%s", container_name(this->s),
+			key_name(typename Set::key_type()), kind, distribution_name(d));
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (this->keys.size()); }
+	void			finish(void) { g_sink += this->s.size(); }
+};
+
+template <class Set>
+struct KeyInsert : KeyWorkload<Set>
+{
+	size_t	heap;
+	double	per_element;
+
+	KeyInsert(Distribution d, size_t n) : KeyWorkload<Set>("insert", d, n), heap(0), per_element(-1) {}
+	void	prepare(void)
+	{
+		Set().swap(this->s);
+		this->heap = heap_in_use();
+	}
+	void	op(size_t i) { insert_key(this->s, this->keys[i]); }
+	void	finish(void)
+	{
+		KeyWorkload<Set>::finish();
+		this->per_element = static_cast<double>(heap_in_use() - this->heap) / this->s.size();
+	}
+	double	bytes_per_element(void) const { return (this->per_element); }
+};
+
+template <class Set>
+struct KeyFind : KeyWorkload<Set>
+{
+	std::vector<int>	queries;
+
+	KeyFind(Distribution d, size_t n)
+		: KeyWorkload<Set>("find", d, n), queries(d == SORTED ? this->keys : make_keys(d, n, SEED + 1))
+	{}
+	void	prepare(void)
+	{
+		Set().swap(this->s);
+		for (size_t i = 0; i < this->keys.size(); i++)
+			insert_key(this->s, this->keys[i]);
+	}
+	void	op(size_t i) { g_sink += this->s.count(this->queries[i]); }
+};
+
+enum StackMode { STACK_MUTEX, STACK_LOCK_FREE, STACK_LOCAL_CACHE };
+
+static const char *	stack_mode_name(StackMode mode)
+{
+	static const char *	names[] = { "stack_mutex", "concurrent_stack", "concurrent_stack_cache" };
+
+	return (names[mode]);
+}
+
+// threads потоков делят n пар push/try_pop на одном стеке: ft::stack под
+// pthread_mutex против concurrent_stack без и с local_cache. Операция - один
+// раунд с запуском и ожиданием потоков, общий объем работы от числа потоков
+// не зависит, так что ops/s сравнимы между t1..t64
+template <StackMode Mode>
+struct StackContention : Workload
+{
+	size_t						n;
+	size_t						threads;
+	pthread_mutex_t				mutex;
+	ft::stack<int>				locked;
+#if TEST_STL
+	ft::concurrent_stack<int>	lock_free;
+#endif
+	char						label[64];
+
+	StackContention(size_t n, size_t threads) : n(n), threads(threads)
+	{
+		pthread_mutex_init(&this->mutex, NULL);
+		snprintf(this->label, sizeof(this->label), "%s_t%zu", stack_mode_name(Mode), threads);
+	}
+	~StackContention() { pthread_mutex_destroy(&this->mutex); }
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (4); }
+	void			prepare(void) {}
+
+	void	work(void)
+	{
+		size_t	count = this->n / this->threads;
+		long	sum = 0;
+		int		value = 0;
+
+		if (Mode == STACK_MUTEX)
+			for (size_t i = 0; i < count; i++)
+			{
+				pthread_mutex_lock(&this->mutex);
+				this->locked.push(static_cast<int>(i));
+				pthread_mutex_unlock(&this->mutex);
+				pthread_mutex_lock(&this->mutex);
+				if (!this->locked.empty())
+				{
+					sum += this->locked.top();
+					this->locked.pop();
+				}
+				pthread_mutex_unlock(&this->mutex);
+			}
+#if TEST_STL
+		else if (Mode == STACK_LOCK_FREE)
+			for (size_t i = 0; i < count; i++)
+			{
+				this->lock_free.push(static_cast<int>(i));
+				if (this->lock_free.try_pop(value))
+					sum += value;
+			}
+		else
+		{
+			ft::concurrent_stack<int>::local_cache	cache(this->lock_free);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				this->lock_free.push(static_cast<int>(i), cache);
+				if (this->lock_free.try_pop(value, cache))
+					sum += value;
+			}
+		}
+#endif
+		__atomic_add_fetch(&g_sink, sum + value, __ATOMIC_RELAXED);
+	}
+	static void *	run_thread(void * arg)
+	{
+		static_cast<StackContention *>(arg)->work();
+		return (NULL);
+	}
+	void	op(size_t)
+	{
+		std::vector<pthread_t>	ids(this->threads);
+
+		for (size_t t = 0; t < this->threads; t++)
+			pthread_create(&ids[t], NULL, run_thread, this);
+		for (size_t t = 0; t < this->threads; t++)
+			pthread_join(ids[t], NULL);
+	}
+};
+
+// Обработка запроса: map из 64 ключей и вектор из 256 чисел живут один запрос.
+// std_alloc - malloc на каждый узел и рост вектора; arena - сдвиг указателя
+// в буфере и один release() на запрос; pool - списки свободных блоков
+struct RequestChurn : Workload
+{
+	static const size_t	per_request = 64;
+
+	std::vector<int>	keys;
+	char				label[64];
+
+	RequestChurn(const char * kind, size_t n) : keys(make_keys(RANDOM, n / per_request * per_request + per_request, SEED))
+	{
+		snprintf(this->label, sizeof(this->label), "request_churn_%s", kind);
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (this->keys.size() / per_request); }
+	void			prepare(void) {}
+
+	template <class Map, class Vector>
+	void	handle(Map & m, Vector & v, size_t i)
+	{
+		const int *	request = &this->keys[i * per_request];
+
+		for (size_t k = 0; k < per_request; k++)
+			m.insert(ft::make_pair(request[k], static_cast<int>(k)));
+		for (size_t k = 0; k < 4 * per_request; k++)
+			v.push_back(request[k % per_request]);
+		g_sink += m.size() + v.back() + m.find(request[0])->second;
+	}
+};
+
+struct RequestChurnStd : RequestChurn
+{
+	explicit RequestChurnStd(size_t n) : RequestChurn("std_alloc", n) {}
+	void	op(size_t i)
+	{
+		ft::map<int, int>	m;
+		ft::vector<int>		v;
+
+		this->handle(m, v, i);
+	}
+};
+
+#if TEST_STL
+typedef ft::pmr::map<int, int>::type	pmr_map;
+typedef ft::pmr::vector<int>::type		pmr_vector;
+
+struct RequestChurnArena : RequestChurn
+{
+	char							buffer[16384];
+	ft::monotonic_buffer_resource	arena;
+
+	explicit RequestChurnArena(size_t n) : RequestChurn("arena", n), arena(this->buffer, sizeof(this->buffer)) {}
+	void	op(size_t i)
+	{
+		{
+			pmr_map		m((std::less<int>()), &this->arena);
+			pmr_vector	v(&this->arena);
+
+			this->handle(m, v, i);
+		}
+		this->arena.release();
+	}
+};
+
+struct RequestChurnPool : RequestChurn
+{
+	ft::unsynchronized_pool_resource	pool;
+
+	explicit RequestChurnPool(size_t n) : RequestChurn("pool", n) {}
+	void	op(size_t i)
+	{
+		pmr_map		m((std::less<int>()), &this->pool);
+		pmr_vector	v(&this->pool);
+
+		this->handle(m, v, i);
+	}
+};
+#endif
+
+static const char *	allocator_name(const std::allocator<int> &) { return ("std_alloc"); }
+static const char *	allocator_name(const ft::mmap_allocator<int> &) { return ("mmap"); }
+static const char *	allocator_name(const ft::hugepage_allocator<int> &) { return ("hugepage"); }
+
+// Случайные чтения из вектора в 16 раз длиннее числа операций: на 4 КиБ
+// страницах почти каждое - промах TLB, на больших страницах их меньше (dtlb_misses)
+template <class Alloc>
+struct VectorRandomRead : Workload
+{
+	std::vector<size_t>		positions;
+	ft::vector<int, Alloc>	v;
+	long					sum;
+	char					label[64];
+
+	explicit VectorRandomRead(size_t n) : positions(n), sum(0)
+	{
+		Random	rng(SEED);
+
+		for (size_t i = 0; i < n; i++)
+			this->positions[i] = rng.next() % (n * 16);
+		snprintf(this->label, sizeof(this->label), "vector_random_read_%s", allocator_name(Alloc()));
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (this->positions.size()); }
+	void			prepare(void)
+	{
+		ft::vector<int, Alloc>(this->positions.size() * 16, 1, Alloc()).swap(this->v);
+		this->sum = 0;
+	}
+	void			op(size_t i) { this->sum += this->v[this->positions[i]]; }
+	void			finish(void) { g_sink += this->sum; }
+};
+
+// Интервалы [lo, lo + до 2^20] на ключах до 2^31 и запросы шириной до 2^16:
+// на запрос приходится несколько пересечений
+struct IntervalWorkload : Workload
+{
+	std::vector<int>	lows;
+	std::vector<int>	highs;
+	std::vector<int>	queries;
+	size_t				found;
+	char				label[64];
+
+	IntervalWorkload(const char * kind, size_t count, size_t n) : lows(count), highs(count), queries(n), found(0)
+	{
+		Random	rng(SEED);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			this->lows[i] = static_cast<int>(rng.next() >> 33);
+			this->highs[i] = this->lows[i] + static_cast<int>(rng.next() % (1 << 20));
+		}
+		for (size_t i = 0; i < n; i++)
+			this->queries[i] = static_cast<int>(rng.next() >> 33);
+		snprintf(this->label, sizeof(this->label), "%s_%zu", kind, count);
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (this->queries.size()); }
+	int				query_high(size_t i) const { return (this->queries[i] + (this->queries[i] & 0xFFFF)); }
+	void			finish(void) { g_sink += this->found; }
+};
+
+// Как сейчас без interval_map: ft::map lo -> hi, скан от начала до upper_bound(hi)
+// запроса - интервал с меньшим lo тоже может пересекаться
+struct IntervalScan : IntervalWorkload
+{
+	ft::map<int, int>	m;
+
+	IntervalScan(size_t count, size_t n) : IntervalWorkload("map_scan_overlapping", count, n) {}
+	void	prepare(void)
+	{
+		ft::map<int, int>().swap(this->m);
+		for (size_t i = 0; i < this->lows.size(); i++)
+			this->m.insert(ft::make_pair(this->lows[i], this->highs[i]));
+		this->found = 0;
+	}
+	void	op(size_t i)
+	{
+		ft::map<int, int>::iterator	last = this->m.upper_bound(this->query_high(i));
+
+		for (ft::map<int, int>::iterator it = this->m.begin(); it != last; ++it)
+			this->found += it->second >= this->queries[i];
+	}
+};
+
+#if TEST_STL
+// Выходной итератор, который только считает записи
+struct CountingOutput
+{
+	size_t *	count;
+
+	CountingOutput &	operator*(void) { return (*this); }
+	CountingOutput &	operator++(void) { return (*this); }
+	CountingOutput &	operator++(int) { return (*this); }
+	template <typename T>
+	CountingOutput &	operator=(const T &)
+	{
+		++*this->count;
+		return (*this);
+	}
+};
+
+struct IntervalQuery : IntervalWorkload
+{
+	ft::interval_map<int, int>	m;
+	bool						stabbing;
+
+	IntervalQuery(size_t count, size_t n, bool stabbing)
+		: IntervalWorkload(stabbing ? "interval_map_stabbing" : "interval_map_overlapping", count, n), stabbing(stabbing)
+	{}
+	void	prepare(void)
+	{
+		this->m.clear();
+		for (size_t i = 0; i < this->lows.size(); i++)
+			this->m.insert(this->lows[i], this->highs[i], static_cast<int>(i));
+		this->found = 0;
+	}
+	void	op(size_t i)
+	{
+		CountingOutput	out = { &this->found };
+
+		if (this->stabbing)
+			this->m.stabbing(this->queries[i], out);
+		else
+			this->m.overlapping(this->queries[i], this->query_high(i), out);
+	}
+};
+
+struct IntervalOverlapping : IntervalQuery
+{
+	IntervalOverlapping(size_t count, size_t n) : IntervalQuery(count, n, false) {}
+};
+
+struct IntervalStabbing : IntervalQuery
+{
+	IntervalStabbing(size_t count, size_t n) : IntervalQuery(count, n, true) {}
+};
+
+struct Record
+{
+	int64_t	key;
+	char	payload[56];
+};
+
+// Файл из n записей для mapped_vector и для чтения в ft::vector. Холодный запуск
+// сбрасывает страницы файла из кэша (fdatasync + POSIX_FADV_DONTNEED), на tmpfs
+// это ничего не дает
+struct RecordsFile : Workload
+{
+	size_t	n;
+	char	path[64];
+
+	explicit RecordsFile(size_t n) : n(n)
+	{
+		snprintf(this->path, sizeof(this->path), "ft_bench_records_%d.bin", static_cast<int>(getpid()));
+
+		ft::mapped_vector<Record>	file(this->path, ft::mapped_vector<Record>::truncate);
+		Record						record = Record();
+
+		file.reserve(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			record.key = static_cast<int64_t>(i);
+			file.push_back(record);
+		}
+	}
+	~RecordsFile() { unlink(this->path); }
+	size_t	ops(void) const { return (this->n); }
+
+	void	drop_cache(void)
+	{
+		int		fd = open(this->path, O_RDONLY);
+
+		if (fd == -1)
+			return ;
+		fdatasync(fd);
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+
+	void	load(ft::vector<Record> & out)
+	{
+		int		fd = open(this->path, O_RDONLY);
+		char *	cursor;
+		size_t	left = this->n * sizeof(Record);
+		ssize_t	got = 1;
+
+		out.resize(this->n);
+		cursor = reinterpret_cast<char *>(out.data());
+		while (fd != -1 && left && (got = read(fd, cursor, left)) > 0)
+		{
+			cursor += got;
+			left -= got;
+		}
+		if (fd != -1)
+			close(fd);
+	}
+};
+
+// Запуск - открыть файл и прочитать одну запись: mapped_vector за O(1),
+// чтение в ft::vector копирует весь файл
+template <bool Mapped, bool Cold>
+struct RecordsStartup : RecordsFile
+{
+	ft::mapped_vector<Record>	mapped;
+	ft::vector<Record>			loaded;
+	char						label[64];
+
+	explicit RecordsStartup(size_t n) : RecordsFile(n)
+	{
+		snprintf(this->label, sizeof(this->label), "%s_startup_%s",
+			Mapped ? "mapped_vector" : "vector_read", Cold ? "cold" : "warm");
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (1); }
+	void			prepare(void)
+	{
+		this->mapped.close();
+		ft::vector<Record>().swap(this->loaded);
+		if (Cold)
+			this->drop_cache();
+	}
+	void			op(size_t)
+	{
+		if (Mapped)
+		{
+			this->mapped.open(this->path, ft::mapped_vector<Record>::read_only);
+			g_sink += this->mapped[this->n / 2].key;
+		}
+		else
+		{
+			this->load(this->loaded);
+			g_sink += this->loaded[this->n / 2].key;
+		}
+	}
+};
+
+// Скан всех записей после открытия: холодный mapped_vector подгружает страницы
+// по ходу скана, ft::vector уже прочитан целиком
+template <bool Mapped, bool Cold>
+struct RecordsScan : RecordsFile
+{
+	ft::mapped_vector<Record>	mapped;
+	ft::vector<Record>			loaded;
+	const Record *				records;
+	long						sum;
+	char						label[64];
+
+	explicit RecordsScan(size_t n) : RecordsFile(n), records(NULL), sum(0)
+	{
+		snprintf(this->label, sizeof(this->label), "%s_scan_%s",
+			Mapped ? "mapped_vector" : "vector_read", Cold ? "cold" : "warm");
+	}
+	const char *	name(void) const { return (this->label); }
+	void			prepare(void)
+	{
+		this->mapped.close();
+		if (Cold)
+			this->drop_cache();
+		if (Mapped)
+		{
+			this->mapped.open(this->path, ft::mapped_vector<Record>::read_only);
+			this->records = this->mapped.data();
+		}
+		else
+		{
+			this->load(this->loaded);
+			this->records = this->loaded.data();
+		}
+		this->sum = 0;
+	}
+	void			op(size_t i) { this->sum += this->records[i].key; }
+	void			finish(void) { g_sink += this->sum; }
+};
+
+struct Plus
+{
+	long	operator()(long lhd, long rhd) const { return (lhd + rhd); }
+};
+
+struct Twice
+{
+	long	operator()(long x) const { return (x * 2); }
+};
+
+// Масштабирование parallel:: на 1..N потоках: операция - проход по вектору
+// из 4n элементов, пул свой у каждой нагрузки
+struct ParallelWorkload : Workload
+{
+	ft::parallel::thread_pool	pool;
+	ft::vector<long>			values;
+	char						label[64];
+
+	ParallelWorkload(const char * kind, size_t n, size_t threads) : pool(threads), values(n * 4, 1)
+	{
+		snprintf(this->label, sizeof(this->label), "parallel_%s_t%zu", kind, threads);
+	}
+	const char *	name(void) const { return (this->label); }
+	size_t			ops(void) const { return (32); }
+	void			prepare(void) {}
+};
+
+struct ParallelReduce : ParallelWorkload
+{
+	ParallelReduce(size_t n, size_t threads) : ParallelWorkload("reduce", n, threads) {}
+	void	op(size_t)
+	{
+		g_sink += ft::parallel::reduce(this->values.begin(), this->values.end(), 0L, Plus(), this->pool);
+	}
+};
+
+struct ParallelTransform : ParallelWorkload
+{
+	ft::vector<long>	out;
+
+	ParallelTransform(size_t n, size_t threads) : ParallelWorkload("transform", n, threads), out(n * 4) {}
+	void	op(size_t)
+	{
+		ft::parallel::transform(this->values.begin(), this->values.end(), this->out.begin(), Twice(), this->pool);
+	}
+	void	finish(void) { g_sink += this->out.back(); }
+};
+#endif
+
+// Цена пары вызовов часов, она входит в каждое значение задержки
+static uint64_t	timer_overhead_ns(void)
+{
+	std::vector<uint32_t>	samples(100000);
+
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		uint64_t	t = now_ns();
+
+		samples[i] = static_cast<uint32_t>(now_ns() - t);
+	}
+	std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+	return (samples[samples.size() / 2]);
+}
+
+static uint64_t	percentile(std::vector<uint32_t> & samples, double p)
+{
+	size_t	k = static_cast<size_t>(p * (samples.size() - 1));
+
+	std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+	return (samples[k]);
+}
+
+// Первый проход меряет общее время, минорные page faults и аппаратные счетчики
+// (если ядро их дает) без накладных расходов на часы, второй, на свежих данных, - задержку каждой операции
+static void	run(Workload & w)
+{
+	w.prepare();
+
+	size_t					ops = w.ops();
+	std::vector<uint32_t>	latency(ops);
+	ft::perf::counters		counters;
+	ft::perf::sample		sample;
+	struct rusage			usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+
+	long	faults = usage.ru_minflt;
+
+	{
+		ft::perf::scope	measure(counters, sample);
+
+		for (size_t i = 0; i < ops; i++)
+			w.op(i);
+	}
+	w.finish();
+	getrusage(RUSAGE_SELF, &usage);
+	faults = usage.ru_minflt - faults;
+
+	uint64_t	wall = sample.wall_ns;
+
+	w.prepare();
+	for (size_t i = 0; i < ops; i++)
+	{
+		uint64_t	t = now_ns();
+
+		w.op(i);
+		latency[i] = static_cast<uint32_t>(std::min<uint64_t>(now_ns() - t, 0xFFFFFFFFu));
+	}
+	w.finish();
+
+	getrusage(RUSAGE_SELF, &usage);
+	printf("    {\"workload\": \"%s\", \"ops\": %zu, \"wall_s\": %.6f, \"ops_per_s\": %.0f, "
+		"\"p50_ns\": %llu, \"p99_ns\": %llu, \"peak_rss_kb\": %ld, \"minor_faults\": %ld, ",
+		w.name(), ops, wall / 1e9, wall ? ops / (wall / 1e9) : 0.0,
+		static_cast<unsigned long long>(percentile(latency, 0.50)),
+		static_cast<unsigned long long>(percentile(latency, 0.99)),
+		usage.ru_maxrss, faults);
+	if (w.bytes_per_element() >= 0)
+		printf("\"bytes_per_element\": %.1f, ", w.bytes_per_element());
+	printf("\"perf\": {");
+	for (int c = 0; c < ft::perf::COUNTER_COUNT; c++)
+	{
+		printf("%s\"%s\": ", c ? ", " : "", ft::perf::counter_name(static_cast<ft::perf::counter>(c)));
+		if (sample.available[c])
+			printf("%llu", static_cast<unsigned long long>(sample.values[c]));
+		else
+			printf("null");
+	}
+	printf("}}");
+	fflush(stdout);
+}
+
+// Каждая нагрузка - в отдельном процессе, чтобы пиковый RSS не копился.
+// Возвращает true в потомке; родитель ждет его завершения
+static bool	fork_workload(bool & first)
+{
+	if (!first)
+		printf(",\n");
+	first = false;
+	fflush(stdout);
+
+	pid_t	pid = fork();
+
+	if (!pid)
+		return (true);
+	waitpid(pid, NULL, 0);
+	return (false);
+}
+
+// Деструктор нагрузки вызывается до _exit: он убирает временные файлы
+template <typename W, typename A>
+static void	spawn(bool & first, A arg)
+{
+	if (fork_workload(first))
+	{
+		{
+			W	w(arg);
+
+			run(w);
+		}
+		_exit(0);
+	}
+}
+
+template <typename W, typename A, typename B>
+static void	spawn(bool & first, A a, B b)
+{
+	if (fork_workload(first))
+	{
+		{
+			W	w(a, b);
+
+			run(w);
+		}
+		_exit(0);
+	}
+}
+
+// Один и тот же W на 1, 2, 4... потоках и на всех ядрах
+template <typename W>
+static void	spawn_scaling(bool & first, size_t n, size_t cores)
+{
+	size_t	threads = 1;
+
+	for (; threads < cores; threads *= 2)
+		spawn<W>(first, n, threads);
+	spawn<W>(first, n, cores);
+}
+
+template <typename W>
+static void	spawn_map(bool & first, size_t n)
+{
+	Distribution	all[] = {RANDOM, SORTED, ZIPF};
+
+	for (size_t i = 0; i < 3; i++)
+	{
+		if (fork_workload(first))
+		{
+			{
+				W	w(all[i], n);
+
+				run(w);
+			}
+			_exit(0);
+		}
+	}
+}
+
+// 1 КиБ, 64 КиБ, 4 МиБ... до n * 64 байт, но не больше 1 ГиБ
+template <bool Ordering>
+static void	spawn_compare(bool & first, size_t n)
+{
+	size_t	limit = n * 64 < (size_t(1) << 30) ? n * 64 : (size_t(1) << 30);
+
+	for (size_t bytes = 1024; bytes <= limit; bytes *= 64)
+		spawn<VectorCompare<Ordering> >(first, bytes);
+	if (limit == (size_t(1) << 30))
+		spawn<VectorCompare<Ordering> >(first, limit);
+}
+
+// n * 2 КиБ, но не больше 2 ГиБ: при n по умолчанию буфер в 2 ГиБ
+template <bool Default>
+static void	spawn_fill(bool & first, size_t n)
+{
+	size_t	limit = size_t(2) << 30;
+
+	spawn<VectorFill<Default> >(first, n < limit / 2048 ? n * 2048 : limit);
+}
+
+int	main(int argc, char ** argv)
+{
+	size_t	n = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_COUNT;
+	size_t	quadratic = n < QUADRATIC_COUNT ? n : QUADRATIC_COUNT;
+	bool	first = true;
+
+	bool	hardware = ft::perf::counters().hardware();
+
+	printf("{\n  \"library\": \"%s\",\n  \"seed\": %d,\n  \"count\": %zu,\n  \"timer_overhead_ns\": %llu,\n"
+		"  \"hardware_counters\": %s,\n  \"results\": [\n",
+		LIBRARY, SEED, n, static_cast<unsigned long long>(timer_overhead_ns()), hardware ? "true" : "false");
+
+	spawn<VectorPushBack>(first, n);
+	spawn<VectorInsert>(first, quadratic);
+	spawn<VectorErase>(first, quadratic);
+	spawn<VectorIterate>(first, n);
+	spawn<VectorSnapshot<int> >(first, n);
+	spawn<VectorSnapshot<std::string> >(first, n);
+	spawn<VectorFromMap>(first, n);
+	spawn<VectorFromStream>(first, n);
+	spawn_fill<false>(first, n);
+#if TEST_STL
+	spawn_fill<true>(first, n);
+#endif
+	spawn_compare<false>(first, n);
+	spawn_compare<true>(first, n);
+	spawn<SortInts<false> >(first, n);
+	spawn<SortInts<true> >(first, n);
+	spawn<SortRecords<false> >(first, n);
+	spawn<SortRecords<true> >(first, n);
+	spawn_map<MapInsert>(first, n);
+	spawn_map<MapFind>(first, n);
+	spawn_map<MapErase>(first, n);
+	spawn<MapIterate>(first, n);
+	spawn<MapBuildInsert>(first, n);
+	spawn<MapScan<SCAN_ITERATOR> >(first, n);
+	spawn<CopyThen<ft::map<int, int>, false> >(first, n);
+	spawn<CopyThen<ft::map<int, int>, true> >(first, n);
+	spawn<MapScan<SCAN_ITERATOR_RANGE> >(first, n);
+#if TEST_STL
+	spawn<MapScan<SCAN_FOR_EACH> >(first, n);
+	spawn<MapScan<SCAN_FOR_EACH_RANGE> >(first, n);
+	spawn<CopyThen<ft::cow_map<int, int>, false> >(first, n);
+	spawn<CopyThen<ft::cow_map<int, int>, true> >(first, n);
+#endif
+	spawn<ShardRebalance<REBALANCE_ERASE_INSERT> >(first, n);
+#if TEST_STL
+	spawn<ShardRebalance<REBALANCE_EXTRACT> >(first, n);
+	spawn<ShardRebalance<REBALANCE_MERGE> >(first, n);
+#endif
+	spawn<MapSetOp<SET_UNION, false> >(first, n);
+	spawn<MapSetOp<SET_UNION, true> >(first, n);
+	spawn<MapSetOp<SET_INTERSECTION, false> >(first, n);
+	spawn<MapSetOp<SET_INTERSECTION, true> >(first, n);
+	spawn<MapSetOp<SET_DIFFERENCE, false> >(first, n);
+	spawn<MapSetOp<SET_DIFFERENCE, true> >(first, n);
+	spawn<MapSetOp<SET_SYMMETRIC_DIFFERENCE, false> >(first, n);
+	spawn<MapSetOp<SET_SYMMETRIC_DIFFERENCE, true> >(first, n);
+	spawn<StackPush>(first, n);
+	spawn<StackPop>(first, n);
+	spawn<StackBacking<std::deque<int>, false> >(first, n);
+	spawn<StackBacking<std::deque<int>, true> >(first, n);
+	spawn<StackBacking<ft::vector<int>, false> >(first, n);
+	spawn<StackBacking<ft::vector<int>, true> >(first, n);
+#if TEST_STL
+	spawn<StackBacking<ft::deque<int>, false> >(first, n);
+	spawn<StackBacking<ft::deque<int>, true> >(first, n);
+#endif
+	spawn<StackParser<std::deque<int>, false> >(first, n);
+	spawn<StackParser<ft::vector<int>, false> >(first, n);
+#if TEST_STL
+	spawn<StackParser<ft::vector<int>, true> >(first, n);
+	spawn<StackParser<ft::deque<int>, false> >(first, n);
+	spawn<StackParser<ft::deque<int>, true> >(first, n);
+#endif
+	spawn_scaling<StackContention<STACK_MUTEX> >(first, n, 64);
+#if TEST_STL
+	spawn_scaling<StackContention<STACK_LOCK_FREE> >(first, n, 64);
+	spawn_scaling<StackContention<STACK_LOCAL_CACHE> >(first, n, 64);
+#endif
+	spawn<RequestChurnStd>(first, n);
+#if TEST_STL
+	spawn<RequestChurnArena>(first, n);
+	spawn<RequestChurnPool>(first, n);
+#endif
+	spawn_map<KeyInsert<ft::set<int> > >(first, n);
+	spawn_map<KeyInsert<ft::map<int, char> > >(first, n);
+	spawn_map<KeyInsert<ft::set<long> > >(first, n);
+	spawn_map<KeyInsert<ft::map<long, char> > >(first, n);
+	spawn_map<KeyFind<ft::set<int> > >(first, n);
+	spawn_map<KeyFind<ft::map<int, char> > >(first, n);
+	spawn<IntervalScan>(first, quadratic, quadratic);
+	spawn<VectorRandomRead<std::allocator<int> > >(first, n);
+	spawn<VectorRandomRead<ft::mmap_allocator<int> > >(first, n);
+	spawn<VectorRandomRead<ft::hugepage_allocator<int> > >(first, n);
+#if TEST_STL
+	spawn<IntervalOverlapping>(first, quadratic, quadratic);
+	spawn<IntervalOverlapping>(first, n, n);
+	spawn<IntervalStabbing>(first, n, n);
+	spawn<RecordsStartup<true, true> >(first, n);
+	spawn<RecordsStartup<true, false> >(first, n);
+	spawn<RecordsStartup<false, true> >(first, n);
+	spawn<RecordsStartup<false, false> >(first, n);
+	spawn<RecordsScan<true, true> >(first, n);
+	spawn<RecordsScan<true, false> >(first, n);
+	spawn<RecordsScan<false, false> >(first, n);
+	spawn_scaling<ParallelReduce>(first, n, ft::parallel::hardware_concurrency());
+	spawn_scaling<ParallelTransform>(first, n, ft::parallel::hardware_concurrency());
+	spawn_scaling<MapBuild>(first, n, ft::parallel::hardware_concurrency());
+#endif
+
+	printf("\n  ]\n}\n");
+	return (0);
+}
@@ -0,0 +1,337 @@
+#ifndef CONCURRENT_STACK_HPP
+# define CONCURRENT_STACK_HPP
+
+# include <cstddef>
+# include <memory>
+# include <new>
+# include <stdint.h>
+
+namespace ft
+{
+	// Lock-free стек Трайбера.
+	//
+	// Узлы живут в сегментах, которые принадлежат стеку и освобождаются только
+	// в деструкторе, поэтому чтение next у узла, который уже сняли и переиспользовали,
+	// безопасно по памяти. Голова - 64-битное слово {тег:32, индекс узла + 1:32},
+	// тег растет при каждой замене, так что устаревший CAS (ABA) не проходит.
+	// Освобожденные узлы лежат во втором таком же стеке и переиспользуются;
+	// local_cache дает потоку собственный запас узлов без обращений к общему списку
+	template <typename T, class Alloc = std::allocator<T> >
+	class concurrent_stack
+	{
+		public:
+			typedef				T										value_type;
+			typedef				Alloc									allocator_type;
+			typedef typename	allocator_type::const_reference			const_reference;
+			typedef typename	allocator_type::size_type				size_type;
+
+		private:
+			struct _node
+			{
+				T			value;
+				uint32_t	next;
+			};
+
+			typedef typename	Alloc::template rebind<_node>::other	_node_allocator_type;
+
+			static const uint32_t	_base_shift = 6;
+			static const uint32_t	_segments_count = 26;
+			static const uint32_t	_nil = 0;
+
+			_node_allocator_type	_allocator;
+			_node *					_segments[_segments_count];
+			uint64_t				_head;
+			char					_pad_head[64 - sizeof(uint64_t)];
+			uint64_t				_free;
+			char					_pad_free[64 - sizeof(uint64_t)];
+			uint32_t				_allocated;
+
+			concurrent_stack(const concurrent_stack &);
+			concurrent_stack &	operator=(const concurrent_stack &);
+
+			static uint32_t	_index(uint64_t word)	{ return (static_cast<uint32_t>(word)); };
+			static uint64_t	_tag(uint64_t word)		{ return (word >> 32); };
+
+			static uint64_t	_word(uint64_t tag, uint32_t index)
+			{
+				return ((tag << 32) | index);
+			};
+
+			// Сегмент k содержит 64 << k узлов, адрес узла считается без блокировок
+			_node *	_at(uint32_t ref)	const
+			{
+				uint64_t	v = static_cast<uint64_t>(ref - 1) + (1u << _base_shift);
+				uint32_t	k = 63 - __builtin_clzll(v) - _base_shift;
+				_node *		segment = __atomic_load_n(&this->_segments[k], __ATOMIC_ACQUIRE);
+
+				return (segment + (v - (static_cast<uint64_t>(1) << (k + _base_shift))));
+			};
+
+			uint32_t	_next(uint32_t ref)	const
+			{
+				return (__atomic_load_n(&this->_at(ref)->next, __ATOMIC_RELAXED));
+			};
+
+			void	_setNext(uint32_t ref, uint32_t next)
+			{
+				__atomic_store_n(&this->_at(ref)->next, next, __ATOMIC_RELAXED);
+			};
+
+			// Новый узел из еще не тронутой части сегментов
+			uint32_t	_freshNode(void)
+			{
+				uint32_t	i = __atomic_fetch_add(&this->_allocated, 1, __ATOMIC_RELAXED);
+				uint64_t	v = static_cast<uint64_t>(i) + (1u << _base_shift);
+				uint32_t	k = 63 - __builtin_clzll(v) - _base_shift;
+
+				if (k >= _segments_count)
+					throw std::bad_alloc();
+
+				if (!__atomic_load_n(&this->_segments[k], __ATOMIC_ACQUIRE))
+				{
+					size_type	count = static_cast<size_type>(1) << (k + _base_shift);
+					_node *		segment = this->_allocator.allocate(count);
+					_node *		expected = NULL;
+
+					if (!__atomic_compare_exchange_n(&this->_segments[k], &expected, segment,
+						false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+						this->_allocator.deallocate(segment, count);
+				}
+
+				return (i + 1);
+			};
+
+			// Кладет готовую цепочку first..last одним CAS
+			void	_pushChain(uint64_t * list, uint32_t first, uint32_t last)
+			{
+				uint64_t	head = __atomic_load_n(list, __ATOMIC_RELAXED);
+
+				do
+					this->_setNext(last, _index(head));
+				while (!__atomic_compare_exchange_n(list, &head, _word(_tag(head) + 1, first),
+					true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+			};
+
+			// Снимает до max узлов одним CAS, возвращает первый и пишет количество в taken.
+			// Пока CAS не прошел, цепочка могла поменяться - это ловит тег
+			uint32_t	_popChain(uint64_t * list, size_type max, size_type & taken)
+			{
+				uint64_t	head = __atomic_load_n(list, __ATOMIC_ACQUIRE);
+				uint32_t	after;
+
+				do
+				{
+					taken = 0;
+					after = _index(head);
+					while (after != _nil && taken < max)
+					{
+						after = this->_next(after);
+						taken++;
+					}
+				}
+				while (taken && !__atomic_compare_exchange_n(list, &head, _word(_tag(head) + 1, after),
+					true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+				return (taken ? _index(head) : _nil);
+			};
+
+			uint32_t	_acquireNode(void)
+			{
+				size_type	taken;
+				uint32_t	ref = this->_popChain(&this->_free, 1, taken);
+
+				return (ref == _nil ? this->_freshNode() : ref);
+			};
+
+			void	_construct(uint32_t ref, const_reference val)
+			{
+				::new (static_cast<void *>(&this->_at(ref)->value)) T(val);
+			};
+
+			void	_moveOut(uint32_t ref, T & out)
+			{
+				T &	value = this->_at(ref)->value;
+
+				out = value;
+				value.~T();
+			};
+
+		public:
+			class local_cache;
+			friend class local_cache;
+
+			// Личный запас свободных узлов одного потока. Пополняется и сбрасывается
+			// пачками, остаток возвращается в стек в деструкторе
+			class local_cache
+			{
+				friend class concurrent_stack;
+
+				static const size_type	_capacity = 64;
+
+				concurrent_stack &	_owner;
+				uint32_t			_nodes[_capacity];
+				size_type			_count;
+
+				local_cache(const local_cache &);
+				local_cache &	operator=(const local_cache &);
+
+				uint32_t	_take(void)
+				{
+					if (!this->_count)
+					{
+						size_type	taken;
+						uint32_t	ref = this->_owner._popChain(&this->_owner._free, _capacity / 2, taken);
+
+						for (; taken--; ref = this->_owner._next(ref))
+							this->_nodes[this->_count++] = ref;
+						if (!this->_count)
+							return (this->_owner._freshNode());
+					}
+
+					return (this->_nodes[--this->_count]);
+				};
+
+				void	_give(uint32_t ref)
+				{
+					if (this->_count == _capacity)
+						this->_spill(_capacity / 2);
+					this->_nodes[this->_count++] = ref;
+				};
+
+				void	_spill(size_type n)
+				{
+					if (!n)
+						return ;
+
+					uint32_t	first = this->_nodes[this->_count - n];
+
+					for (size_type i = this->_count - n; i + 1 < this->_count; i++)
+						this->_owner._setNext(this->_nodes[i], this->_nodes[i + 1]);
+					this->_owner._pushChain(&this->_owner._free, first, this->_nodes[this->_count - 1]);
+					this->_count -= n;
+				};
+
+				public:
+					explicit local_cache(concurrent_stack & owner) : _owner(owner), _count(0) {};
+
+					~local_cache()
+					{
+						this->_spill(this->_count);
+					};
+			};
+
+			explicit concurrent_stack(const allocator_type & alloc = allocator_type())
+				: _allocator(alloc), _head(0), _free(0), _allocated(0)
+			{
+				for (uint32_t k = 0; k < _segments_count; k++)
+					this->_segments[k] = NULL;
+			};
+
+			// Не потокобезопасен: к этому моменту все потоки должны закончить работу
+			~concurrent_stack()
+			{
+				T	buf;
+
+				while (this->try_pop(buf))
+					;
+				for (uint32_t k = 0; k < _segments_count; k++)
+					if (this->_segments[k])
+						this->_allocator.deallocate(this->_segments[k], static_cast<size_type>(1) << (k + _base_shift));
+			};
+
+			bool	empty(void)	const
+			{
+				return (_index(__atomic_load_n(&this->_head, __ATOMIC_ACQUIRE)) == _nil);
+			};
+
+			void	push(const_reference val)
+			{
+				uint32_t	ref = this->_acquireNode();
+
+				this->_construct(ref, val);
+				this->_pushChain(&this->_head, ref, ref);
+			};
+
+			void	push(const_reference val, local_cache & cache)
+			{
+				uint32_t	ref = cache._take();
+
+				this->_construct(ref, val);
+				this->_pushChain(&this->_head, ref, ref);
+			};
+
+			bool	try_pop(T & out)
+			{
+				size_type	taken;
+				uint32_t	ref = this->_popChain(&this->_head, 1, taken);
+
+				if (ref == _nil)
+					return (false);
+
+				this->_moveOut(ref, out);
+				this->_pushChain(&this->_free, ref, ref);
+				return (true);
+			};
+
+			bool	try_pop(T & out, local_cache & cache)
+			{
+				size_type	taken;
+				uint32_t	ref = this->_popChain(&this->_head, 1, taken);
+
+				if (ref == _nil)
+					return (false);
+
+				this->_moveOut(ref, out);
+				cache._give(ref);
+				return (true);
+			};
+
+			// Вся пачка собирается локально и публикуется одним CAS;
+			// верхним окажется последний элемент диапазона, как при последовательных push
+			template <typename InputIterator>
+			void	push_many(InputIterator first, InputIterator last)
+			{
+				uint32_t	top = _nil;
+				uint32_t	bottom = _nil;
+
+				for (; first != last; ++first)
+				{
+					uint32_t	ref = this->_acquireNode();
+
+					this->_construct(ref, *first);
+					this->_setNext(ref, top);
+					if (bottom == _nil)
+						bottom = ref;
+					top = ref;
+				}
+
+				if (top != _nil)
+					this->_pushChain(&this->_head, top, bottom);
+			};
+
+			// Снимает до max элементов одним CAS и пишет их в out сверху вниз
+			template <typename OutputIterator>
+			size_type	pop_many(OutputIterator out, size_type max)
+			{
+				size_type	taken;
+				uint32_t	first = this->_popChain(&this->_head, max, taken);
+				uint32_t	last = first;
+				T			buf;
+
+				for (size_type i = 0; i < taken; i++)
+				{
+					if (i)
+						last = this->_next(last);
+					this->_moveOut(last, buf);
+					*out++ = buf;
+				}
+
+				if (taken)
+					this->_pushChain(&this->_free, first, last);
+
+				return (taken);
+			};
+	};
+};
+
+#endif
@@ -0,0 +1,624 @@
+#ifndef COW_MAP_HPP
+# define COW_MAP_HPP
+
+# include <climits>
+# include <cstddef>
+# include <algorithm>
+# include <functional>
+# include <iterator>
+# include <memory>
+# include <stdexcept>
+# include "pair.hpp"
+
+namespace ft
+{
+	// Узел без ссылки на родителя, поэтому одно поддерево может висеть сразу
+	// в нескольких деревьях. refs - число ссылок на узел (детских указателей
+	// и корней), меняется атомарно
+	template <typename T>
+	struct cow_node
+	{
+		T				value;
+		cow_node *		left;
+		cow_node *		right;
+		std::size_t		refs;
+		int				height;
+
+		cow_node(const T & value, cow_node * left, cow_node * right, int height)
+			: value(value), left(left), right(right), refs(1), height(height)
+		{};
+	};
+
+	// Отображение с копированием при записи: копия делит дерево с оригиналом
+	// за O(1), а запись копирует только узлы, которые меняет. Дерево AVL:
+	// балансировка трогает лишь путь к ключу и, при удалении, братьев на нем
+	// с их детьми, так что первая запись после копии - O(log n) новых узлов.
+	// Значения меняются только через assign/insert/erase, итераторы константные.
+	// Копии можно читать и менять из разных потоков, один объект - нет
+	template <typename Key, typename T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::pair<const Key, T> > >
+	class cow_map
+	{
+		// Тесты (tests/test.hpp) проверяют баланс и разделение дерева
+		friend struct _test_access;
+
+		public:
+			typedef				Key																key_type;
+			typedef				T																mapped_type;
+			typedef				ft::pair<const Key, T>											value_type;
+			typedef				Compare															key_compare;
+			typedef				Alloc															allocator_type;
+			typedef	typename	allocator_type::const_reference									const_reference;
+			typedef	typename	allocator_type::const_pointer									const_pointer;
+			typedef typename	allocator_type::size_type										size_type;
+			typedef				std::ptrdiff_t													difference_type;
+
+		private:
+			typedef				cow_node<value_type>											Node;
+			typedef typename	Alloc::template rebind<Node>::other								node_allocator;
+
+			// Высота AVL не больше 1.44 * log2(size + 2)
+			static const size_type	_max_depth = 3 * sizeof(size_type) * CHAR_BIT / 2;
+
+		public:
+			// ++ без ссылки на родителя: при правом ребенке - спуск влево, иначе
+			// поиск от корня, O(log n). Инвалидируется любой записью в свой map
+			class const_iterator
+			{
+				friend class cow_map;
+
+				public:
+					typedef				std::ptrdiff_t							difference_type;
+					typedef				ft::pair<const Key, T>					value_type;
+					typedef				const value_type *						pointer;
+					typedef				const value_type &						reference;
+					typedef				std::bidirectional_iterator_tag			iterator_category;
+
+				private:
+					const cow_map *		_map;
+					const Node *		_node;
+
+					const_iterator(const cow_map * map, const Node * node) : _map(map), _node(node) {};
+
+				public:
+					const_iterator(void) : _map(NULL), _node(NULL) {};
+
+					reference	operator*(void)	const
+					{
+						return (this->_node->value);
+					};
+
+					pointer	operator->(void)	const
+					{
+						return (&this->_node->value);
+					};
+
+					const_iterator &	operator++(void)
+					{
+						this->_node = this->_map->_next(this->_node, true);
+						return (*this);
+					};
+
+					const_iterator	operator++(int)
+					{
+						const_iterator	old(*this);
+
+						++*this;
+						return (old);
+					};
+
+					const_iterator &	operator--(void)
+					{
+						this->_node = this->_map->_next(this->_node, false);
+						return (*this);
+					};
+
+					const_iterator	operator--(int)
+					{
+						const_iterator	old(*this);
+
+						--*this;
+						return (old);
+					};
+
+					bool	operator==(const const_iterator & rhd)	const
+					{
+						return (this->_node == rhd._node);
+					};
+
+					bool	operator!=(const const_iterator & rhd)	const
+					{
+						return (this->_node != rhd._node);
+					};
+			};
+
+			typedef				const_iterator													iterator;
+
+		private:
+			key_compare		_comparator;
+			node_allocator	_allocator;
+			Node *			_root;
+			size_type		_size;
+
+			static int	_height(const Node * node)
+			{
+				return (node ? node->height : 0);
+			};
+
+			static void	_update(Node * node)
+			{
+				int	left = _height(node->left);
+				int	right = _height(node->right);
+
+				node->height = 1 + (left < right ? right : left);
+			};
+
+			static Node *	_acquire(Node * node)
+			{
+				if (node)
+					__atomic_add_fetch(&node->refs, 1, __ATOMIC_RELAXED);
+				return (node);
+			};
+
+			void	_free(Node * node)
+			{
+				this->_allocator.destroy(node);
+				this->_allocator.deallocate(node, 1);
+			};
+
+			void	_release(Node * node)
+			{
+				while (node && !__atomic_sub_fetch(&node->refs, 1, __ATOMIC_ACQ_REL))
+				{
+					Node *	right = node->right;
+
+					this->_release(node->left);
+					this->_free(node);
+					node = right;
+				}
+			};
+
+			Node *	_create(const value_type & val, Node * left, Node * right, int height)
+			{
+				Node *	node = this->_allocator.allocate(1);
+
+				try
+				{
+					this->_allocator.construct(node, Node(val, left, right, height));
+				}
+				catch (...)
+				{
+					this->_allocator.deallocate(node, 1);
+					throw;
+				}
+				return (node);
+			};
+
+			// Узел по ссылке link становится единоличным: общий заменяется копией,
+			// детям которой добавляется по ссылке. Бросает только до изменений
+			void	_own(Node *& link)
+			{
+				Node *	node = link;
+
+				if (!node || __atomic_load_n(&node->refs, __ATOMIC_ACQUIRE) == 1)
+					return ;
+
+				Node *	copy = this->_create(node->value, node->left, node->right, node->height);
+
+				_acquire(copy->left);
+				_acquire(copy->right);
+				link = copy;
+				this->_release(node);
+			};
+
+			// Брат узла на пути удаления и его дети - все, что кроме пути может
+			// понадобиться повороту
+			void	_ownSibling(Node *& link)
+			{
+				this->_own(link);
+				if (link)
+				{
+					this->_own(link->left);
+					this->_own(link->right);
+				}
+			};
+
+			const Node *	_findNode(const key_type & key)	const
+			{
+				const Node *	node = this->_root;
+
+				while (node)
+				{
+					if (this->_comparator(key, node->value.first))
+						node = node->left;
+					else if (this->_comparator(node->value.first, key))
+						node = node->right;
+					else
+						return (node);
+				}
+				return (NULL);
+			};
+
+			const Node *	_bound(const key_type & key, bool upper)	const
+			{
+				const Node *	node = this->_root;
+				const Node *	result = NULL;
+
+				while (node)
+				{
+					if (upper ? this->_comparator(key, node->value.first) : !this->_comparator(node->value.first, key))
+					{
+						result = node;
+						node = node->left;
+					}
+					else
+						node = node->right;
+				}
+				return (result);
+			};
+
+			const Node *	_edge(bool right)	const
+			{
+				const Node *	node = this->_root;
+
+				while (node && (right ? node->right : node->left))
+					node = right ? node->right : node->left;
+				return (node);
+			};
+
+			// Соседний по порядку узел; от end() назад - последний
+			const Node *	_next(const Node * node, bool forward)	const
+			{
+				if (!node)
+					return (forward ? NULL : this->_edge(true));
+
+				const Node *	child = forward ? node->right : node->left;
+
+				if (child)
+				{
+					while (forward ? child->left : child->right)
+						child = forward ? child->left : child->right;
+					return (child);
+				}
+
+				const Node *	cursor = this->_root;
+				const Node *	result = NULL;
+
+				while (cursor != node)
+				{
+					if (forward == this->_comparator(node->value.first, cursor->value.first))
+					{
+						result = cursor;
+						cursor = forward ? cursor->left : cursor->right;
+					}
+					else
+						cursor = forward ? cursor->right : cursor->left;
+				}
+				return (result);
+			};
+
+			Node *	_rotate(Node * node, bool right)
+			{
+				Node *	top = right ? node->left : node->right;
+
+				if (right)
+				{
+					node->left = top->right;
+					top->right = node;
+				}
+				else
+				{
+					node->right = top->left;
+					top->left = node;
+				}
+				_update(node);
+				_update(top);
+				return (top);
+			};
+
+			// Повороты трогают узел, его ребенка с тяжелой стороны и, при двойном
+			// повороте, внука - все они уже единоличные
+			void	_rebalance(Node *& link)
+			{
+				Node *	node = link;
+				int		balance = _height(node->left) - _height(node->right);
+
+				if (balance > 1)
+				{
+					if (_height(node->left->left) < _height(node->left->right))
+						node->left = this->_rotate(node->left, false);
+					link = this->_rotate(node, true);
+				}
+				else if (balance < -1)
+				{
+					if (_height(node->right->right) < _height(node->right->left))
+						node->right = this->_rotate(node->right, true);
+					link = this->_rotate(node, false);
+				}
+				else
+					_update(node);
+			};
+
+		public:
+			explicit cow_map(const key_compare & comp = key_compare(), const allocator_type & alloc = allocator_type())
+				: _comparator(comp), _allocator(alloc), _root(NULL), _size(0)
+			{};
+
+			template <typename InputIter>
+			cow_map(InputIter first, InputIter last, const key_compare & comp = key_compare(), const allocator_type & alloc = allocator_type())
+				: _comparator(comp), _allocator(alloc), _root(NULL), _size(0)
+			{
+				try
+				{
+					this->insert(first, last);
+				}
+				catch (...)
+				{
+					this->clear();
+					throw;
+				}
+			};
+
+			// O(1): дерево общее, пока одна из копий не начнет запись
+			cow_map(const cow_map & src)
+				: _comparator(src._comparator), _allocator(src._allocator), _root(_acquire(src._root)), _size(src._size)
+			{};
+
+			~cow_map()
+			{
+				this->_release(this->_root);
+			};
+
+			cow_map &	operator=(const cow_map & rhd)
+			{
+				Node *	root = _acquire(rhd._root);
+
+				this->_release(this->_root);
+				this->_root = root;
+				this->_size = rhd._size;
+				this->_comparator = rhd._comparator;
+				this->_allocator = rhd._allocator;
+
+				return (*this);
+			};
+
+			const_iterator	begin(void)	const
+			{
+				return (const_iterator(this, this->_edge(false)));
+			};
+
+			const_iterator	end(void)	const
+			{
+				return (const_iterator(this, NULL));
+			};
+
+			bool	empty(void)	const
+			{
+				return (!this->_size);
+			};
+
+			size_type	size(void)	const
+			{
+				return (this->_size);
+			};
+
+			size_type	max_size(void)	const
+			{
+				return (this->_allocator.max_size());
+			};
+
+			const mapped_type &	at(const key_type & key)	const
+			{
+				const Node *	node = this->_findNode(key);
+
+				if (!node)
+					throw std::out_of_range("cow_map");
+				return (node->value.second);
+			};
+
+			const_iterator	find(const key_type & key)	const
+			{
+				return (const_iterator(this, this->_findNode(key)));
+			};
+
+			size_type	count(const key_type & key)	const
+			{
+				return (this->_findNode(key) != NULL);
+			};
+
+			const_iterator	lower_bound(const key_type & key)	const
+			{
+				return (const_iterator(this, this->_bound(key, false)));
+			};
+
+			const_iterator	upper_bound(const key_type & key)	const
+			{
+				return (const_iterator(this, this->_bound(key, true)));
+			};
+
+			// Все, что может бросить (новый узел и копии общих узлов пути), делается
+			// до первого изменения дерева, поэтому при исключении map не меняется
+			ft::pair<const_iterator, bool>	insert(const value_type & val)
+			{
+				const Node *	found = this->_findNode(val.first);
+
+				if (found)
+					return (ft::make_pair(const_iterator(this, found), false));
+
+				Node *		node = this->_create(val, NULL, NULL, 1);
+				Node **		path[_max_depth];
+				size_type	depth = 0;
+				Node **		link = &this->_root;
+
+				try
+				{
+					for (; *link; depth++)
+					{
+						this->_own(*link);
+						path[depth] = link;
+						link = this->_comparator(val.first, (*link)->value.first) ? &(*link)->left : &(*link)->right;
+					}
+				}
+				catch (...)
+				{
+					this->_free(node);
+					throw;
+				}
+				*link = node;
+				this->_size++;
+				while (depth)
+					this->_rebalance(*path[--depth]);
+				return (ft::make_pair(const_iterator(this, node), true));
+			};
+
+			const_iterator	insert(const_iterator, const value_type & val)
+			{
+				return (this->insert(val).first);
+			};
+
+			template <typename InputIter>
+			void	insert(InputIter first, InputIter last)
+			{
+				for (; first != last; ++first)
+					this->insert(*first);
+			};
+
+			// Вставка или замена значения: копируется только путь к ключу
+			const_iterator	assign(const key_type & key, const mapped_type & val)
+			{
+				if (!this->_findNode(key))
+					return (this->insert(value_type(key, val)).first);
+
+				Node **	link = &this->_root;
+
+				for (;;)
+				{
+					this->_own(*link);
+					if (this->_comparator(key, (*link)->value.first))
+						link = &(*link)->left;
+					else if (this->_comparator((*link)->value.first, key))
+						link = &(*link)->right;
+					else
+						break ;
+				}
+				(*link)->value.second = val;
+				return (const_iterator(this, *link));
+			};
+
+			size_type	erase(const key_type & key)
+			{
+				if (!this->_findNode(key))
+					return (0);
+
+				// Сначала единоличными становятся путь к ключу (и к преемнику), а
+				// также братья на нем с детьми; дальше только перестановка ссылок
+				Node **	link = &this->_root;
+
+				for (;;)
+				{
+					this->_own(*link);
+
+					Node *	node = *link;
+					bool	found = !this->_comparator(key, node->value.first) && !this->_comparator(node->value.first, key);
+
+					if (found && !(node->left && node->right))
+						break ;
+
+					bool	right = found || this->_comparator(node->value.first, key);
+
+					this->_ownSibling(right ? node->left : node->right);
+					link = right ? &node->right : &node->left;
+					if (found)
+					{
+						for (; *link; link = &(*link)->left)
+						{
+							this->_own(*link);
+							this->_ownSibling((*link)->right);
+						}
+						break ;
+					}
+				}
+
+				Node **		path[_max_depth];
+				size_type	depth = 0;
+
+				for (link = &this->_root; this->_comparator(key, (*link)->value.first) || this->_comparator((*link)->value.first, key); depth++)
+				{
+					path[depth] = link;
+					link = this->_comparator(key, (*link)->value.first) ? &(*link)->left : &(*link)->right;
+				}
+
+				Node *	victim = *link;
+
+				if (!victim->left || !victim->right)
+					*link = victim->left ? victim->left : victim->right;
+				else
+				{
+					// Преемник встает на место удаляемого узла целиком, без копии значения
+					size_type	at = depth;
+					Node **		min = &victim->right;
+
+					path[depth++] = link;
+					while ((*min)->left)
+					{
+						path[depth++] = min;
+						min = &(*min)->left;
+					}
+
+					Node *	successor = *min;
+
+					*min = successor->right;
+					successor->left = victim->left;
+					successor->right = victim->right;
+					*link = successor;
+					if (depth > at + 1)
+						path[at + 1] = &successor->right;
+				}
+				this->_free(victim);
+				this->_size--;
+				while (depth)
+					this->_rebalance(*path[--depth]);
+				return (1);
+			};
+
+			// Ключ копируется: узел под итератором может освободиться по ходу
+			void	erase(const_iterator position)
+			{
+				key_type	key = position->first;
+
+				this->erase(key);
+			};
+
+			void	clear(void)
+			{
+				this->_release(this->_root);
+				this->_root = NULL;
+				this->_size = 0;
+			};
+
+			void	swap(cow_map & ref)
+			{
+				std::swap(this->_comparator, ref._comparator);
+				std::swap(this->_allocator, ref._allocator);
+				std::swap(this->_root, ref._root);
+				std::swap(this->_size, ref._size);
+			};
+
+			key_compare	key_comp(void)	const
+			{
+				return (this->_comparator);
+			};
+
+			allocator_type	get_allocator(void)	const
+			{
+				return (allocator_type(this->_allocator));
+			};
+	};
+
+	template <typename Key, typename T, class Compare, class Alloc>
+	inline void	swap(cow_map<Key, T, Compare, Alloc> & lhd, cow_map<Key, T, Compare, Alloc> & rhd)
+	{
+		lhd.swap(rhd);
+	};
+};
+
+#endif
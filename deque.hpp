@@ -0,0 +1,500 @@
+#ifndef DEQUE_HPP
+# define DEQUE_HPP
+
+# include <algorithm>
+# include <cstring>
+# include <memory>
+# include <stdexcept>
+# include "algorithm.hpp"
+# include "type_traits.hpp"
+# include "iterator_traits.hpp"
+# include "deque_iterator.hpp"
+# include "reverse_iterator.hpp"
+
+namespace ft
+{
+	// Элементы лежат в чанках фиксированного размера, карта хранит указатели на чанки.
+	// При росте перевыделяется только карта, сами элементы никогда не переезжают.
+	// Опустевшие чанки не освобождаются, а уходят в список запасных и берутся
+	// снова при следующем росте, так что стек, который качается вверх-вниз, не дергает malloc
+	template <typename T, class Alloc = std::allocator<T> >
+	class deque
+	{
+		public:
+			typedef				T																value_type;
+			typedef				Alloc															allocator_type;
+			typedef typename	allocator_type::reference										reference;
+			typedef typename	allocator_type::const_reference									const_reference;
+			typedef typename	allocator_type::pointer											pointer;
+			typedef typename	allocator_type::const_pointer									const_pointer;
+			typedef typename	allocator_type::size_type										size_type;
+
+			typedef				ft::deque_iterator<T, pointer *>								iterator;
+			typedef				ft::deque_iterator<const T, pointer *>							const_iterator;
+			typedef typename	ft::iterator_traits<iterator>::difference_type					difference_type;
+			typedef				ft::reverse_iterator<const_iterator>							const_reverse_iterator;
+			typedef				ft::reverse_iterator<iterator>									reverse_iterator;
+
+		private:
+			typedef typename	allocator_type::template rebind<pointer>::other					_map_allocator_type;
+
+			static const size_type	_shift = iterator::chunk_shift;
+			static const size_type	_chunk_size = size_type(1) << _shift;
+			static const size_type	_mask = _chunk_size - 1;
+
+			allocator_type			_allocator;
+			_map_allocator_type		_map_allocator;
+
+			pointer *	_map;
+			size_type	_map_capacity;
+			size_type	_start;
+			size_type	_size;
+			pointer		_spare;
+
+			// Запасные чанки связаны в список через свои первые байты
+			void	_releaseChunk(size_type chunk)
+			{
+				std::memcpy(static_cast<void *>(this->_map[chunk]), &this->_spare, sizeof(pointer));
+				this->_spare = this->_map[chunk];
+				this->_map[chunk] = NULL;
+			};
+
+			pointer	_chunkAt(size_type chunk)
+			{
+				if (this->_map[chunk])
+					return (this->_map[chunk]);
+
+				if (this->_spare)
+				{
+					this->_map[chunk] = this->_spare;
+					std::memcpy(&this->_spare, static_cast<void *>(this->_spare), sizeof(pointer));
+				}
+				else
+					this->_map[chunk] = this->_allocator.allocate(_chunk_size);
+
+				return (this->_map[chunk]);
+			};
+
+			void	_freeSpare(void)
+			{
+				while (this->_spare)
+				{
+					pointer	next;
+
+					std::memcpy(&next, static_cast<void *>(this->_spare), sizeof(pointer));
+					this->_allocator.deallocate(this->_spare, _chunk_size);
+					this->_spare = next;
+				}
+			};
+
+			// Освобождает место под extra чанков с нужного конца: либо сдвигает живые чанки
+			// к центру текущей карты, либо переносит их в карту вдвое больше
+			void	_growMap(bool at_front, size_type extra = 1)
+			{
+				size_type	first = this->_start >> _shift;
+				size_type	used = this->_size ? ((this->_start + this->_size - 1) >> _shift) - first + 1 : 0;
+				size_type	needed = used + extra;
+				size_type	new_capacity = this->_map_capacity;
+				pointer *	new_map = this->_map;
+
+				if (needed * 2 > this->_map_capacity)
+				{
+					new_capacity = this->_map_capacity * 2;
+					if (new_capacity < needed * 2)
+						new_capacity = needed * 2;
+					if (new_capacity < 8)
+						new_capacity = 8;
+					new_map = this->_map_allocator.allocate(new_capacity);
+					std::fill(new_map, new_map + new_capacity, pointer(NULL));
+				}
+
+				size_type	new_first = (new_capacity - needed) / 2 + (at_front ? extra : 0);
+
+				if (new_map == this->_map)
+				{
+					std::memmove(static_cast<void *>(this->_map + new_first), this->_map + first, used * sizeof(pointer));
+					if (new_first > first)
+						std::fill(this->_map + first, this->_map + std::min(new_first, first + used), pointer(NULL));
+					else
+						std::fill(this->_map + std::max(new_first + used, first), this->_map + first + used, pointer(NULL));
+				}
+				else
+				{
+					std::copy(this->_map + first, this->_map + first + used, new_map + new_first);
+					if (this->_map)
+						this->_map_allocator.deallocate(this->_map, this->_map_capacity);
+					this->_map = new_map;
+					this->_map_capacity = new_capacity;
+				}
+
+				this->_start = (new_first << _shift) + (this->_start & _mask);
+			};
+
+			void	_destroyAll(void)
+			{
+				while (this->_size)
+					this->pop_back();
+			};
+
+			template <typename InputIterator>
+			void	_rangeAppend(InputIterator first, InputIterator last)
+			{
+				for (; first != last; ++first)
+					this->push_back(*first);
+			};
+
+		public:
+			explicit deque(const allocator_type & alloc = allocator_type())
+				: _allocator(alloc), _map_allocator(alloc), _map(NULL), _map_capacity(0), _start(0), _size(0), _spare(NULL)
+			{};
+
+			explicit deque(size_type n, const value_type & val = value_type(), const allocator_type & alloc = allocator_type())
+				: _allocator(alloc), _map_allocator(alloc), _map(NULL), _map_capacity(0), _start(0), _size(0), _spare(NULL)
+			{
+				this->assign(n, val);
+			};
+
+			template <class InputIterator>
+			deque(InputIterator first, InputIterator last, const allocator_type & alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type * = NULL)
+				: _allocator(alloc), _map_allocator(alloc), _map(NULL), _map_capacity(0), _start(0), _size(0), _spare(NULL)
+			{
+				this->_rangeAppend(first, last);
+			};
+
+			deque(const deque & src)
+				: _allocator(src._allocator), _map_allocator(src._map_allocator), _map(NULL), _map_capacity(0), _start(0), _size(0), _spare(NULL)
+			{
+				*this = src;
+			};
+
+			~deque()
+			{
+				this->_destroyAll();
+				this->_freeSpare();
+				if (this->_map)
+					this->_map_allocator.deallocate(this->_map, this->_map_capacity);
+			};
+
+			deque &	operator=(const deque & rhd)
+			{
+				if (this != &rhd)
+					this->assign(rhd.begin(), rhd.end());
+				return (*this);
+			};
+
+			template <typename InputIterator>
+			typename ft::enable_if<!ft::is_integral<InputIterator>::value, void>::type
+				assign(InputIterator first, InputIterator last)
+			{
+				this->clear();
+				this->_rangeAppend(first, last);
+			};
+
+			void	assign(size_type n, const_reference val)
+			{
+				value_type	copy(val);
+
+				this->clear();
+				while (n--)
+					this->push_back(copy);
+			};
+
+			inline allocator_type	get_allocator(void)	const {
+				return (this->_allocator);
+			};
+
+			inline reference	operator[](size_type n) {
+				size_type	index = this->_start + n;
+
+				return (this->_map[index >> _shift][index & _mask]);
+			};
+
+			inline const_reference	operator[](size_type n)	const {
+				size_type	index = this->_start + n;
+
+				return (this->_map[index >> _shift][index & _mask]);
+			};
+
+			reference	at(size_type n) {
+				if (!(n < this->_size))
+					throw std::out_of_range("deque");
+
+				return ((*this)[n]);
+			};
+
+			const_reference	at(size_type n)	const {
+				if (!(n < this->_size))
+					throw std::out_of_range("deque");
+
+				return ((*this)[n]);
+			};
+
+			inline reference	front(void) {
+				return ((*this)[0]);
+			};
+
+			inline const_reference	front(void)	const {
+				return ((*this)[0]);
+			};
+
+			inline reference	back(void) {
+				return ((*this)[this->_size - 1]);
+			};
+
+			inline const_reference	back(void)	const {
+				return ((*this)[this->_size - 1]);
+			};
+
+			inline iterator	begin(void) {
+				return (iterator(this->_map, this->_start));
+			};
+
+			inline const_iterator	begin(void)	const {
+				return (const_iterator(this->_map, this->_start));
+			};
+
+			inline iterator	end(void) {
+				return (iterator(this->_map, this->_start + this->_size));
+			};
+
+			inline const_iterator	end(void)	const {
+				return (const_iterator(this->_map, this->_start + this->_size));
+			};
+
+			inline reverse_iterator	rbegin(void) {
+				return (reverse_iterator(this->end()));
+			};
+
+			inline const_reverse_iterator	rbegin(void)	const {
+				return (const_reverse_iterator(this->end()));
+			};
+
+			inline reverse_iterator	rend(void) {
+				return (reverse_iterator(this->begin()));
+			};
+
+			inline const_reverse_iterator	rend(void)	const {
+				return (const_reverse_iterator(this->begin()));
+			};
+
+			inline const_iterator	cbegin(void)	const {
+				return (this->begin());
+			};
+
+			inline const_iterator	cend(void)	const {
+				return (this->end());
+			};
+
+			inline const_reverse_iterator	crbegin(void)	const {
+				return (this->rbegin());
+			};
+
+			inline const_reverse_iterator	crend(void)	const {
+				return (this->rend());
+			};
+
+			inline bool	empty(void)	const {
+				return (!this->_size);
+			};
+
+			inline size_type	size(void)	const {
+				return (this->_size);
+			};
+
+			inline size_type	max_size(void)	const {
+				return (this->_allocator.max_size());
+			};
+
+			// Заранее готовит карту и запасные чанки, чтобы до n элементов
+			// push_back не выделял память
+			void	reserve(size_type n) {
+				if (n <= this->_size)
+					return ;
+
+				size_type	first = this->_start >> _shift;
+				size_type	used = this->_size ? ((this->_start + this->_size - 1) >> _shift) - first + 1 : 0;
+				size_type	total = ((this->_start + n - 1) >> _shift) - first + 1;
+
+				if (first + total > this->_map_capacity)
+					this->_growMap(false, total - used);
+
+				size_type	missing = total - used;
+
+				for (pointer chunk = this->_spare; chunk && missing; missing--)
+					std::memcpy(&chunk, static_cast<void *>(chunk), sizeof(pointer));
+
+				while (missing--)
+				{
+					pointer	chunk = this->_allocator.allocate(_chunk_size);
+
+					std::memcpy(static_cast<void *>(chunk), &this->_spare, sizeof(pointer));
+					this->_spare = chunk;
+				}
+			};
+
+			// Возвращает запасные чанки аллокатору
+			void	shrink_to_fit(void) {
+				this->_freeSpare();
+			};
+
+			void	clear(void) {
+				this->_destroyAll();
+			};
+
+			void	push_back(const_reference val) {
+				size_type	index = this->_start + this->_size;
+
+				if ((index >> _shift) >= this->_map_capacity)
+				{
+					this->_growMap(false);
+					index = this->_start + this->_size;
+				}
+
+				this->_allocator.construct(this->_chunkAt(index >> _shift) + (index & _mask), val);
+				this->_size++;
+			};
+
+			void	push_front(const_reference val) {
+				if (!this->_start)
+					this->_growMap(true);
+
+				size_type	index = this->_start - 1;
+
+				this->_allocator.construct(this->_chunkAt(index >> _shift) + (index & _mask), val);
+				this->_start--;
+				this->_size++;
+			};
+
+			void	pop_back(void) {
+				if (!this->_size)
+					return ;
+
+				size_type	index = this->_start + --this->_size;
+
+				this->_allocator.destroy(this->_map[index >> _shift] + (index & _mask));
+				if (!(index & _mask) || !this->_size)
+					this->_releaseChunk(index >> _shift);
+			};
+
+			void	pop_front(void) {
+				if (!this->_size)
+					return ;
+
+				size_type	index = this->_start++;
+
+				this->_size--;
+				this->_allocator.destroy(this->_map[index >> _shift] + (index & _mask));
+				if (!(this->_start & _mask) || !this->_size)
+					this->_releaseChunk(index >> _shift);
+			};
+
+			iterator	insert(iterator position, const_reference val) {
+				size_type	idx = position - this->begin();
+
+				this->insert(position, size_type(1), val);
+				return (this->begin() + idx);
+			};
+
+			void	insert(iterator position, size_type n, const_reference val) {
+				size_type	idx = position - this->begin();
+				size_type	old_size = this->_size;
+				value_type	copy(val);
+
+				while (n--)
+					this->push_back(copy);
+				std::rotate(this->begin() + idx, this->begin() + old_size, this->end());
+			};
+
+			template <typename InputIterator>
+			typename ft::enable_if<!ft::is_integral<InputIterator>::value, void>::type
+				insert(iterator position, InputIterator first, InputIterator last) {
+				size_type	idx = position - this->begin();
+				size_type	old_size = this->_size;
+
+				this->_rangeAppend(first, last);
+				std::rotate(this->begin() + idx, this->begin() + old_size, this->end());
+			};
+
+			inline iterator	erase(iterator position) {
+				return (this->erase(position, position + 1));
+			};
+
+			// Сдвигаем меньшую из двух частей
+			iterator	erase(iterator first, iterator last) {
+				size_type	idx = first - this->begin();
+				size_type	n = last - first;
+
+				if (idx < this->_size - idx - n)
+				{
+					std::copy_backward(this->begin(), first, last);
+					while (n--)
+						this->pop_front();
+				}
+				else
+				{
+					std::copy(last, this->end(), first);
+					while (n--)
+						this->pop_back();
+				}
+
+				return (this->begin() + idx);
+			};
+
+			void	resize(size_type n, value_type val = value_type()) {
+				while (this->_size > n)
+					this->pop_back();
+				while (this->_size < n)
+					this->push_back(val);
+			};
+
+			void	swap(deque & src) {
+				std::swap(this->_allocator, src._allocator);
+				std::swap(this->_map_allocator, src._map_allocator);
+				std::swap(this->_map, src._map);
+				std::swap(this->_map_capacity, src._map_capacity);
+				std::swap(this->_start, src._start);
+				std::swap(this->_size, src._size);
+				std::swap(this->_spare, src._spare);
+			};
+	};
+
+	template <typename T, typename Alloc>
+	inline void	swap(deque<T, Alloc> & lhd, deque<T, Alloc> & rhd) {
+		lhd.swap(rhd);
+	};
+
+	template <typename T, typename Alloc>
+	bool	operator==(const deque<T, Alloc> & lhd, const deque<T, Alloc> & rhd) {
+		if (lhd.size() != rhd.size())
+			return (false);
+		return (ft::equal(lhd.begin(), lhd.end(), rhd.begin()));
+	};
+
+	template <typename T, typename Alloc>
+	inline bool	operator!=(const deque<T, Alloc> & lhd, const deque<T, Alloc> & rhd) {
+		return !(lhd == rhd);
+	};
+
+	template <typename T, typename Alloc>
+	inline bool	operator<(const deque<T, Alloc> & lhd, const deque<T, Alloc> & rhd) {
+		return (ft::lexicographical_compare(lhd.begin(), lhd.end(), rhd.begin(), rhd.end()));
+	};
+
+	template <typename T, typename Alloc>
+	inline bool	operator>(const deque<T, Alloc> & lhd, const deque<T, Alloc> & rhd) {
+		return (rhd < lhd);
+	};
+
+	template <typename T, typename Alloc>
+	inline bool	operator<=(const deque<T, Alloc> & lhd, const deque<T, Alloc> & rhd) {
+		return !(rhd < lhd);
+	};
+
+	template <typename T, typename Alloc>
+	inline bool	operator>=(const deque<T, Alloc> & lhd, const deque<T, Alloc> & rhd) {
+		return !(lhd < rhd);
+	};
+};
+
+#endif
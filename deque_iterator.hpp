@@ -0,0 +1,169 @@
+#ifndef DEQUE_ITERATOR
+# define DEQUE_ITERATOR
+
+# include "iterator_traits.hpp"
+
+namespace ft
+{
+	// Размер чанка deque в элементах: степень двойки, около 4 КиБ, но не меньше 16,
+	// чтобы крупные элементы (Buffer) не выделялись по одному
+	template <std::size_t Size>
+	struct _deque_chunk_shift
+	{
+		template <std::size_t N, bool Stop = (N <= 1)>
+		struct _log2
+		{
+			static const std::size_t	value = 1 + _log2<N / 2>::value;
+		};
+
+		template <std::size_t N>
+		struct _log2<N, true>
+		{
+			static const std::size_t	value = 0;
+		};
+
+		static const std::size_t	_fit = _log2<4096 / Size>::value;
+		static const std::size_t	value = _fit < 4 ? 4 : _fit;
+	};
+
+	// Итератор хранит карту чанков и глобальный индекс элемента:
+	// чанк - index >> shift, позиция в чанке - index & mask
+	template <typename T, typename MapPointer>
+	class deque_iterator
+	{
+		public:
+			typedef				std::random_access_iterator_tag		iterator_category;
+			typedef				T									value_type;
+			typedef				std::ptrdiff_t						difference_type;
+			typedef				T *									pointer;
+			typedef				T &									reference;
+
+			static const std::size_t	chunk_shift = _deque_chunk_shift<sizeof(T)>::value;
+			static const std::size_t	chunk_mask = (std::size_t(1) << chunk_shift) - 1;
+
+		private:
+			MapPointer	_map;
+			std::size_t	_index;
+
+		public:
+			deque_iterator(void) : _map(NULL), _index(0) {};
+			deque_iterator(MapPointer map, std::size_t index) : _map(map), _index(index) {};
+			deque_iterator(const deque_iterator & src) : _map(src._map), _index(src._index) {};
+
+			template <typename U>
+			deque_iterator(const deque_iterator<U, MapPointer> & src) : _map(src.map()), _index(src.index()) {};
+
+			~deque_iterator() {};
+
+			deque_iterator &	operator=(const deque_iterator & rhd)
+			{
+				this->_map = rhd._map;
+				this->_index = rhd._index;
+				return (*this);
+			};
+
+			MapPointer	map(void)	const { return (this->_map); };
+			std::size_t	index(void)	const { return (this->_index); };
+
+			reference	operator*(void)	const
+			{
+				return (this->_map[this->_index >> chunk_shift][this->_index & chunk_mask]);
+			};
+
+			pointer	operator->(void)	const { return (&**this); };
+
+			reference	operator[](difference_type n)	const
+			{
+				std::size_t	index = this->_index + n;
+
+				return (this->_map[index >> chunk_shift][index & chunk_mask]);
+			};
+
+			deque_iterator &	operator++(void)
+			{
+				this->_index++;
+				return (*this);
+			};
+
+			deque_iterator	operator++(int)
+			{
+				return (deque_iterator(this->_map, this->_index++));
+			};
+
+			deque_iterator &	operator--(void)
+			{
+				this->_index--;
+				return (*this);
+			};
+
+			deque_iterator	operator--(int)
+			{
+				return (deque_iterator(this->_map, this->_index--));
+			};
+
+			deque_iterator &	operator+=(difference_type n)
+			{
+				this->_index += n;
+				return (*this);
+			};
+
+			deque_iterator &	operator-=(difference_type n)
+			{
+				this->_index -= n;
+				return (*this);
+			};
+
+			deque_iterator	operator+(difference_type n)	const { return (deque_iterator(this->_map, this->_index + n)); };
+			deque_iterator	operator-(difference_type n)	const { return (deque_iterator(this->_map, this->_index - n)); };
+	};
+
+	template <typename TL, typename TR, typename M>
+	inline bool	operator==(deque_iterator<TL, M> const & lhd, deque_iterator<TR, M> const & rhd)
+	{
+		return (lhd.index() == rhd.index());
+	};
+
+	template <typename TL, typename TR, typename M>
+	inline bool	operator!=(deque_iterator<TL, M> const & lhd, deque_iterator<TR, M> const & rhd)
+	{
+		return (lhd.index() != rhd.index());
+	};
+
+	template <typename TL, typename TR, typename M>
+	inline bool	operator<(deque_iterator<TL, M> const & lhd, deque_iterator<TR, M> const & rhd)
+	{
+		return (lhd.index() < rhd.index());
+	};
+
+	template <typename TL, typename TR, typename M>
+	inline bool	operator<=(deque_iterator<TL, M> const & lhd, deque_iterator<TR, M> const & rhd)
+	{
+		return (lhd.index() <= rhd.index());
+	};
+
+	template <typename TL, typename TR, typename M>
+	inline bool	operator>(deque_iterator<TL, M> const & lhd, deque_iterator<TR, M> const & rhd)
+	{
+		return (lhd.index() > rhd.index());
+	};
+
+	template <typename TL, typename TR, typename M>
+	inline bool	operator>=(deque_iterator<TL, M> const & lhd, deque_iterator<TR, M> const & rhd)
+	{
+		return (lhd.index() >= rhd.index());
+	};
+
+	template <typename TL, typename TR, typename M>
+	inline typename deque_iterator<TL, M>::difference_type	operator-(deque_iterator<TL, M> const & lhd, deque_iterator<TR, M> const & rhd)
+	{
+		return (static_cast<std::ptrdiff_t>(lhd.index() - rhd.index()));
+	};
+
+	template <typename T, typename M>
+	inline deque_iterator<T, M>	operator+(typename deque_iterator<T, M>::difference_type n, deque_iterator<T, M> const & rhd)
+	{
+		return (rhd + n);
+	};
+}
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef INTERVAL_MAP_HPP
+# define INTERVAL_MAP_HPP
+
+# include <functional>
+# include <memory>
+# include "pair.hpp"
+# include "iterator_traits.hpp"
+# include "RBTree.hpp"
+
+namespace ft
+{
+	// Дополнение для интервального дерева: в узле хранится наибольший правый
+	// конец интервалов его поддерева. Compare должен быть без состояния
+	template <typename Bound, class Compare>
+	struct interval_augment
+	{
+		static const bool	enabled = true;
+
+		struct data
+		{
+			Bound	max_high;
+
+			data(void) : max_high() {};
+		};
+
+		template <class Node>
+		static void	update(Node * node)
+		{
+			Compare	less;
+
+			node->max_high = node->value.first.second;
+			if (node->left && less(node->max_high, node->left->max_high))
+				node->max_high = node->left->max_high;
+			if (node->right && less(node->max_high, node->right->max_high))
+				node->max_high = node->right->max_high;
+		};
+	};
+
+	// Мультиотображение замкнутых интервалов [lo, hi] -> T, упорядоченных по (lo, hi).
+	// Запросы пересечения спускаются только в поддеревья, где max_high >= lo,
+	// и обрываются, как только lo узла больше hi запроса
+	template <typename Bound, typename T, class Compare = std::less<Bound>,
+		class Alloc = std::allocator<ft::pair<const ft::pair<Bound, Bound>, T> > >
+	class interval_map
+	{
+		// Тесты (tests/test.hpp) проверяют инварианты дерева и max_high
+		friend struct _test_access;
+
+		public:
+			typedef				Bound														bound_type;
+			typedef				ft::pair<Bound, Bound>										key_type;
+			typedef				T															mapped_type;
+			typedef				ft::pair<const key_type, T>									value_type;
+			typedef				Compare														bound_compare;
+			typedef				Alloc														allocator_type;
+			typedef typename	allocator_type::size_type									size_type;
+
+			class value_compare : public std::binary_function<value_type, value_type, bool>
+			{
+				friend class interval_map;
+
+				protected:
+					bound_compare	_less;
+
+				public:
+					value_compare(bound_compare less = bound_compare()) : _less(less) {};
+
+					bool	operator()(const value_type & lhd, const value_type & rhd)	const
+					{
+						if (this->_less(lhd.first.first, rhd.first.first))
+							return (true);
+						if (this->_less(rhd.first.first, lhd.first.first))
+							return (false);
+						return (this->_less(lhd.first.second, rhd.first.second));
+					};
+			};
+
+		private:
+			typedef				interval_augment<Bound, Compare>											Augment;
+			typedef				RedBlackTree<value_type, value_compare, allocator_type, Augment>			Tree;
+			typedef typename	Tree::Node																	Node;
+
+		public:
+			typedef typename	Tree::iterator												iterator;
+			typedef typename	Tree::const_iterator										const_iterator;
+			typedef typename	Tree::reverse_iterator										reverse_iterator;
+			typedef typename	Tree::const_reverse_iterator								const_reverse_iterator;
+			typedef typename	ft::iterator_traits<iterator>::difference_type				difference_type;
+
+		private:
+			bound_compare	_less;
+			Tree			_tree;
+
+			// Обход по порядку с отсечением: слева есть пересечение, только если
+			// max_high левого поддерева >= lo; правее узла с lo > hi ничего нет
+			template <class OutputIter>
+			void	_collect(Node * node, const Bound & lo, const Bound & hi, OutputIter & out)	const
+			{
+				while (node)
+				{
+					if (node->left && !this->_less(node->left->max_high, lo))
+						this->_collect(node->left, lo, hi, out);
+					if (this->_less(hi, node->value.first.first))
+						return ;
+					if (!this->_less(node->value.first.second, lo))
+						*out++ = const_iterator(node, this->_tree.root);
+					node = node->right;
+					if (node && this->_less(node->max_high, lo))
+						return ;
+				}
+			};
+
+		public:
+			explicit interval_map(const bound_compare & comp = bound_compare(), const allocator_type & alloc = allocator_type())
+				: _less(comp), _tree(Tree(alloc, value_compare(comp)))
+			{};
+
+			interval_map(const interval_map & src)
+				: _less(src._less), _tree(src._tree)
+			{};
+
+			~interval_map() {};
+
+			interval_map &	operator=(const interval_map & rhd)
+			{
+				if (this == &rhd)
+					return (*this);
+				this->_less = rhd._less;
+				this->_tree = rhd._tree;
+
+				return (*this);
+			};
+
+			iterator	begin(void)
+			{
+				return (this->_tree.begin());
+			};
+
+			const_iterator	begin(void)	const
+			{
+				return (this->_tree.cbegin());
+			};
+
+			iterator	end(void)
+			{
+				return (this->_tree.end());
+			};
+
+			const_iterator	end(void)	const
+			{
+				return (this->_tree.cend());
+			};
+
+			bool	empty(void)	const
+			{
+				return (!this->_tree.size);
+			};
+
+			size_type	size(void)	const
+			{
+				return (this->_tree.size);
+			};
+
+			// Одинаковые интервалы допускаются и идут в порядке вставки
+			iterator	insert(const value_type & val)
+			{
+				return (this->_tree.insert_multi(val));
+			};
+
+			iterator	insert(const Bound & lo, const Bound & hi, const mapped_type & val)
+			{
+				return (this->insert(value_type(key_type(lo, hi), val)));
+			};
+
+			void	erase(iterator position)
+			{
+				this->_tree.erase(position.current);
+			};
+
+			void	clear(void)
+			{
+				this->_tree.clear();
+			};
+
+			void	swap(interval_map & ref)
+			{
+				this->_tree.swap(ref._tree);
+			};
+
+			// Пишет в out const_iterator на каждый интервал, пересекающий [lo, hi],
+			// в порядке (lo, hi). O(log n + k) на типичных данных, O(k log n) в худшем случае
+			template <class OutputIter>
+			OutputIter	overlapping(const Bound & lo, const Bound & hi, OutputIter out)	const
+			{
+				if (this->_tree.root && !this->_less(this->_tree.root->max_high, lo))
+					this->_collect(this->_tree.root, lo, hi, out);
+				return (out);
+			};
+
+			// Интервалы, содержащие точку
+			template <class OutputIter>
+			OutputIter	stabbing(const Bound & point, OutputIter out)	const
+			{
+				return (this->overlapping(point, point, out));
+			};
+
+			// Есть ли хоть одно пересечение: один спуск, O(log n)
+			bool	overlaps(const Bound & lo, const Bound & hi)	const
+			{
+				Node *	node = this->_tree.root;
+
+				while (node)
+				{
+					if (!this->_less(hi, node->value.first.first) && !this->_less(node->value.first.second, lo))
+						return (true);
+					if (node->left && !this->_less(node->left->max_high, lo))
+						node = node->left;
+					else
+						node = node->right;
+				}
+				return (false);
+			};
+
+			allocator_type	get_allocator(void)	const
+			{
+				return (this->_tree.allocator);
+			};
+
+			tree_stats	stats(void)	const
+			{
+				return (this->_tree.stats());
+			};
+	};
+};
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef ITERATOR_TRAITS
 # define ITERATOR_TRAITS
 
+# include <cstddef>
+# include <iterator>
+
 namespace ft
 {
 	template <class Iterator>
@@ -2,18 +2,186 @@
 # define MAP_HPP
 
 # include <functional>
+# include <iosfwd>
 # include <memory>
 # include <stdexcept>
+# include <climits>
 # include "reverse_iterator.hpp"
 # include "pair.hpp"
 # include "iterator_traits.hpp"
 # include "RBTree.hpp"
+# include "memory_usage.hpp"
+# include "vector.hpp"
+# include "aggregate.hpp"
 
 namespace ft
 {
-	template <typename Key, typename T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::pair<const Key, T> > >
+	// Тег для конструктора из диапазона, уже отсортированного по ключам без повторов
+	struct sorted_unique_t {};
+
+	static const sorted_unique_t	sorted_unique = sorted_unique_t();
+
+	// Итератор по массиву указателей, отдающий сами значения
+	template <typename T>
+	class _indirect_iterator
+	{
+		public:
+			typedef				T								value_type;
+			typedef				std::ptrdiff_t					difference_type;
+			typedef				const T *						pointer;
+			typedef				const T &						reference;
+			typedef				std::forward_iterator_tag		iterator_category;
+
+		private:
+			const T * const *	_cursor;
+
+		public:
+			explicit _indirect_iterator(const T * const * cursor) : _cursor(cursor) {};
+
+			reference	operator*(void)	const
+			{
+				return (**this->_cursor);
+			};
+
+			pointer	operator->(void)	const
+			{
+				return (*this->_cursor);
+			};
+
+			_indirect_iterator &	operator++(void)
+			{
+				++this->_cursor;
+				return (*this);
+			};
+
+			_indirect_iterator	operator++(int)
+			{
+				_indirect_iterator	old(*this);
+
+				++this->_cursor;
+				return (old);
+			};
+
+			bool	operator==(const _indirect_iterator & rhd)	const
+			{
+				return (this->_cursor == rhd._cursor);
+			};
+
+			bool	operator!=(const _indirect_iterator & rhd)	const
+			{
+				return (this->_cursor != rhd._cursor);
+			};
+	};
+
+	// Узел, вынутый из map через extract: владеет памятью, пока его не вставят
+	// обратно. Копирование передает владение, как std::auto_ptr (в C++98 нет
+	// перемещения), поэтому handle можно вернуть из функции по значению
+	template <typename Key, typename T, class NodeAlloc>
+	class map_node_handle
+	{
+		public:
+			typedef				Key										key_type;
+			typedef				T										mapped_type;
+			typedef				NodeAlloc								allocator_type;
+			typedef typename	NodeAlloc::value_type					Node;
+
+		private:
+			mutable Node *	_node;
+			allocator_type	_allocator;
+
+			void	_reset(void)
+			{
+				if (!this->_node)
+					return ;
+				this->_allocator.destroy(this->_node);
+				this->_allocator.deallocate(this->_node, 1);
+				this->_node = NULL;
+			};
+
+		public:
+			map_node_handle(void) : _node(NULL), _allocator() {};
+
+			map_node_handle(Node * node, const allocator_type & alloc) : _node(node), _allocator(alloc) {};
+
+			map_node_handle(const map_node_handle & src) : _node(src._node), _allocator(src._allocator)
+			{
+				src._node = NULL;
+			};
+
+			~map_node_handle()
+			{
+				this->_reset();
+			};
+
+			map_node_handle &	operator=(const map_node_handle & rhd)
+			{
+				if (this == &rhd)
+					return (*this);
+				this->_reset();
+				this->_node = rhd._node;
+				this->_allocator = rhd._allocator;
+				rhd._node = NULL;
+
+				return (*this);
+			};
+
+			bool	empty(void)	const
+			{
+				return (!this->_node);
+			};
+
+			const key_type &	key(void)	const
+			{
+				return (this->_node->value.first);
+			};
+
+			mapped_type &	mapped(void)	const
+			{
+				return (this->_node->value.second);
+			};
+
+			allocator_type	get_allocator(void)	const
+			{
+				return (this->_allocator);
+			};
+
+			// Отдает узел и перестает им владеть
+			Node *	release(void)
+			{
+				Node *	node = this->_node;
+
+				this->_node = NULL;
+				return (node);
+			};
+
+			Node *	get(void)	const
+			{
+				return (this->_node);
+			};
+	};
+
+	// map::build_parallel, определена в parallel_build.hpp
+	template <class Map>
+	struct _map_parallel_build;
+
+	// Тела map::save/load - в snapshot.hpp, как и у vector
+	template <class Map>
+	void	_save_map(const Map & map, std::ostream & out);
+
+	template <class Map>
+	void	_load_map(Map & map, std::istream & in);
+
+	// Monoid (см. aggregate.hpp) включает свертку по поддеревьям и map::aggregate
+	template <typename Key, typename T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::pair<const Key, T> >,
+		class Monoid = no_aggregate>
 	class map
 	{
+		// Тесты (tests/test.hpp) проверяют инварианты дерева
+		friend struct _test_access;
+
+		friend struct _map_parallel_build<map>;
+
+		friend void	_load_map<>(map & map, std::istream & in);
 
 		public:
 			typedef				Key															key_type;
@@ -51,19 +219,64 @@ namespace ft
 			};
 
 		private:
-			typedef				RedBlackTree <value_type, value_compare, allocator_type>	Tree;
+			typedef				RedBlackTree <value_type, value_compare, allocator_type,
+									typename _map_augment<Monoid>::type>				Tree;
+			typedef typename	Tree::Node													Node;
+			typedef				_map_access<Monoid, Tree, T>								_access;
+			typedef typename	_access::mapped_reference									_mapped_reference;
 
 		public:
-			typedef typename	Tree::iterator												iterator;
+			typedef typename	_access::iterator											iterator;
 			typedef typename	Tree::const_iterator										const_iterator;
-			typedef typename	Tree::reverse_iterator										reverse_iterator;
+			typedef typename	_access::reverse_iterator									reverse_iterator;
 			typedef typename	Tree::const_reverse_iterator								const_reverse_iterator;
 			typedef typename	ft::iterator_traits<iterator>::difference_type				difference_type;
+			typedef				map_node_handle<Key, T, typename Tree::allocator_type>		node_type;
+			typedef typename	Monoid::result_type											aggregate_type;
 
 		private:
 			key_compare		_comparator;
 			Tree			_tree;
 
+			static aggregate_type	_aggregateOf(const Node * node)
+			{
+				return (node ? node->aggregate : Monoid::identity());
+			};
+
+			// Высота красно-черного дерева не больше 2 * log2(size + 1)
+			static const size_type	_max_depth = 2 * sizeof(size_type) * CHAR_BIT;
+
+			// Обход по порядку на явном стеке без итераторов и подъемов к родителю.
+			// lo/hi == NULL - граница не задана. fn возвращает false, чтобы остановиться
+			template <typename Ref, class Function>
+			void	_visit(const key_type * lo, const key_type * hi, Function & fn)	const
+			{
+				Node *		stack[_max_depth];
+				size_type	top = 0;
+
+				for (Node * node = this->_tree.root; node; )
+				{
+					if (lo && this->_comparator(node->value.first, *lo))
+						node = node->right;
+					else
+					{
+						stack[top++] = node;
+						node = node->left;
+					}
+				}
+				while (top)
+				{
+					Node *	node = stack[--top];
+
+					if (hi && this->_comparator(*hi, node->value.first))
+						return ;
+					if (!fn(static_cast<Ref>(node->value)))
+						return ;
+					for (node = node->right; node; node = node->left)
+						stack[top++] = node;
+				}
+			};
+
 		public:
 
 			explicit map(const key_compare & comp = key_compare(), const allocator_type & alloc = allocator_type())
@@ -78,6 +291,18 @@ namespace ft
 					this->_tree.insert(*first);
 			};
 
+			// Строит дерево за O(n) без insert; если ключи не строго возрастают
+			// в порядке comp, бросает std::invalid_argument
+			template <typename ForwardIter>
+			map(sorted_unique_t, ForwardIter first, ForwardIter last, const key_compare & comp = key_compare(),
+				const allocator_type & alloc = allocator_type())
+				:	_comparator(key_compare(comp)), _tree(Tree(alloc, this->_comparator))
+			{
+				_iterator_source<ForwardIter, value_type>	source(first);
+
+				this->_tree.build_sorted(source, std::distance(first, last));
+			};
+
 			map(const map & src)
 				: _comparator(src._comparator), _tree(src._tree)
 			{};
@@ -92,7 +317,8 @@ namespace ft
 				return (*this);
 			};
 
-			mapped_type &	operator[](const key_type & key)
+			// С Monoid ссылка только для чтения: менять значение - через assign
+			_mapped_reference	operator[](const key_type & key)
 			{
 				iterator	founded = this->find(key);
 
@@ -124,7 +350,7 @@ namespace ft
 
 			reverse_iterator	rbegin(void)
 			{
-				return (this->_tree.rbegin());
+				return (reverse_iterator(this->end()));
 			};
 
 			const_reverse_iterator	rbegin(void)	const
@@ -134,7 +360,7 @@ namespace ft
 
 			reverse_iterator	rend(void)
 			{
-				return (this->_tree.rend());
+				return (reverse_iterator(this->begin()));
 			};
 
 			const_reverse_iterator	rend(void)	const
@@ -177,7 +403,7 @@ namespace ft
 				return (this->_tree.allocator.max_size());
 			};
 
-			mapped_type &	at(const key_type & key)
+			_mapped_reference	at(const key_type & key)
 			{
 				iterator	founded = this->find(key);
 
@@ -221,19 +447,77 @@ namespace ft
 
 			size_type	erase(const key_type & key)
 			{
-				iterator	founded = this->find(key);
-
-				if (founded == this->end())
-					return (0);
-				
-				this->_tree.erase(founded.current);
-				return (1);
+				return (this->_tree.erase(value_type(key, mapped_type())));
 			};
 
 			void	erase(iterator first, iterator last)
 			{
-				for (; first != last; first++)
-					this->erase(first);
+				while (first != last)
+					this->erase(first++);
+			};
+
+			// extract/insert(node_type &)/merge переносят узлы между map без
+			// выделения памяти, если аллокаторы равны; иначе значение копируется
+			node_type	extract(iterator position)
+			{
+				return (node_type(this->_tree.extract(position.current), this->_tree.allocator));
+			};
+
+			node_type	extract(const key_type & key)
+			{
+				Node *	found = this->_tree.find_node(value_type(key, mapped_type()));
+
+				if (!found)
+					return (node_type());
+				return (node_type(this->_tree.extract(found), this->_tree.allocator));
+			};
+
+			// При совпадении ключа узел остается в node
+			ft::pair<iterator, bool>	insert(node_type & node)
+			{
+				if (node.empty())
+					return (ft::make_pair(this->end(), false));
+				if (!(node.get_allocator() == this->_tree.allocator))
+				{
+					ft::pair<iterator, bool>	inserted = this->insert(node.get()->value);
+
+					if (inserted.second)
+						node = node_type();
+					return (inserted);
+				}
+
+				ft::pair<iterator, bool>	inserted = this->_tree.insert_node(node.get());
+
+				if (inserted.second)
+					node.release();
+				return (inserted);
+			};
+
+			iterator	insert(iterator, node_type & node)
+			{
+				return (this->insert(node).first);
+			};
+
+			// Забирает из source все узлы с ключами, которых здесь нет
+			void	merge(map & source)
+			{
+				if (&source == this)
+					return ;
+
+				iterator	last = source.end();
+				iterator	it = source.begin();
+				bool		same_allocator = source._tree.allocator == this->_tree.allocator;
+
+				while (it != last)
+				{
+					Node *	node = it.current;
+
+					++it;
+					if (same_allocator)
+						this->_tree.insert_node(node, &source._tree);
+					else if (this->_tree.insert(node->value).second)
+						source._tree.erase(node);
+				}
 			};
 
 			void	swap(map & ref)
@@ -268,7 +552,7 @@ namespace ft
 
 			size_type	count(const key_type & key)	const
 			{
-				return (this->find(key) != this->end());
+				return (this->_tree.count(value_type(key, mapped_type())));
 			};
 
 			iterator	lower_bound(const key_type & key)
@@ -301,10 +585,323 @@ namespace ft
 				return (ft::make_pair(this->lower_bound(key), this->upper_bound(key)));
 			};
 
+			// Как std::for_each, но fn(value_type &) возвращает bool: false - стоп
+			// (с Monoid - fn(const value_type &)). Возвращает fn, чтобы можно было
+			// забрать его состояние
+			template <class Function>
+			Function	for_each(Function fn)
+			{
+				this->template _visit<typename iterator::reference>(NULL, NULL, fn);
+				return (fn);
+			};
+
+			template <class Function>
+			Function	for_each(Function fn)	const
+			{
+				this->template _visit<const value_type &>(NULL, NULL, fn);
+				return (fn);
+			};
+
+			// То же по ключам из [lo, hi]
+			template <class Function>
+			Function	for_each_in_range(const key_type & lo, const key_type & hi, Function fn)
+			{
+				this->template _visit<typename iterator::reference>(&lo, &hi, fn);
+				return (fn);
+			};
+
+			template <class Function>
+			Function	for_each_in_range(const key_type & lo, const key_type & hi, Function fn)	const
+			{
+				this->template _visit<const value_type &>(&lo, &hi, fn);
+				return (fn);
+			};
+
+			// С Monoid operator[], at, итераторы и for_each дают значения только
+			// для чтения: значение меняет assign, он же пересчитывает свертки.
+			// refresh(it) пересчитывает их вдоль пути от it к корню
+			void	refresh(iterator position)
+			{
+				this->_tree.refresh(position.current);
+			};
+
+			iterator	assign(const key_type & key, const mapped_type & val)
+			{
+				iterator	position = this->insert(value_type(key, val)).first;
+
+				position.current->value.second = val;
+				this->refresh(position);
+				return (position);
+			};
+
+			// Свертка Monoid по всем значениям за O(1): хранится в корне
+			aggregate_type	aggregate(void)	const
+			{
+				return (_aggregateOf(this->_tree.root));
+			};
+
+			// Свертка по ключам из [lo, hi] в порядке ключей за O(log n):
+			// от узла-развилки два спуска, на каждом шаге берется готовая
+			// свертка целого поддерева, лежащего внутри диапазона
+			aggregate_type	aggregate(const key_type & lo, const key_type & hi)	const
+			{
+				Node *	split = this->_tree.root;
+
+				while (split)
+				{
+					if (this->_comparator(split->value.first, lo))
+						split = split->right;
+					else if (this->_comparator(hi, split->value.first))
+						split = split->left;
+					else
+						break ;
+				}
+				if (!split)
+					return (Monoid::identity());
+
+				aggregate_type	left = Monoid::identity();
+				aggregate_type	right = Monoid::identity();
+
+				for (Node * node = split->left; node; )
+				{
+					if (this->_comparator(node->value.first, lo))
+						node = node->right;
+					else
+					{
+						left = Monoid::combine(Monoid::combine(Monoid::lift(node->value.second), _aggregateOf(node->right)), left);
+						node = node->left;
+					}
+				}
+				for (Node * node = split->right; node; )
+				{
+					if (this->_comparator(hi, node->value.first))
+						node = node->left;
+					else
+					{
+						right = Monoid::combine(right, Monoid::combine(_aggregateOf(node->left), Monoid::lift(node->value.second)));
+						node = node->right;
+					}
+				}
+				return (Monoid::combine(Monoid::combine(left, Monoid::lift(split->value.second)), right));
+			};
+
 			allocator_type	get_allocator(void)	const
 			{
 				return (this->_tree.allocator);
 			};
+
+			// Счетчики дерева (живые только при -DFT_RBTREE_STATS) и его текущая форма
+			tree_stats	stats(void)	const
+			{
+				return (this->_tree.stats());
+			};
+
+			void	reset_stats(void)
+			{
+				this->_tree.reset_stats();
+			};
+
+			// Накладные расходы узла - ссылки, цвет и выравнивание вокруг value_type
+			memory_usage_info	memory_usage(void)	const
+			{
+				memory_usage_info	info;
+
+				info.payload_bytes = this->_tree.size * sizeof(value_type);
+				info.overhead_bytes = sizeof(*this)
+					+ this->_tree.size * (sizeof(typename Tree::Node) - sizeof(value_type));
+				return (info);
+			};
+
+			// Пары пишутся в порядке ключей, формат - в snapshot.hpp (нужно подключить)
+			void	save(std::ostream & out)	const
+			{
+				_save_map(*this, out);
+			};
+
+			// При ошибке бросает snapshot_error, содержимое map не меняется
+			void	load(std::istream & in)
+			{
+				_load_map(*this, in);
+			};
+
+			// Замена содержимого несортированным диапазоном в threads потоков
+			// (вместе с вызывающим, 0 - по числу ядер): параллельные сортировка
+			// с удалением повторов и сборка поддеревьев. Из равных ключей остается
+			// первый, как при insert. Аллокатор должен быть потокобезопасным.
+			// Тело - в parallel_build.hpp, его нужно подключить
+			template <class InputIter>
+			void	build_parallel(InputIter first, InputIter last, std::size_t threads = 0)
+			{
+				_map_parallel_build<map>::build(*this, first, last, threads);
+			};
+	};
+
+	template <typename Key, typename T, class Compare, class Alloc, class Monoid>
+	inline std::size_t	_map_log2(const map<Key, T, Compare, Alloc, Monoid> & m)
+	{
+		std::size_t	k = 1;
+
+		while ((std::size_t(1) << k) < m.size())
+			k++;
+		return (k);
+	};
+
+	// Слияние двух обходов по порядку: берет элементы только из a, только из b
+	// и из обоих (тогда значение из a) и строит сбалансированный результат за O(n + m)
+	template <typename Key, typename T, class Compare, class Alloc, class Monoid>
+	map<Key, T, Compare, Alloc, Monoid>	_map_merge(const map<Key, T, Compare, Alloc, Monoid> & a, const map<Key, T, Compare, Alloc, Monoid> & b,
+		bool only_a, bool only_b, bool both)
+	{
+		typedef typename	map<Key, T, Compare, Alloc, Monoid>::value_type		value_type;
+		typedef typename	map<Key, T, Compare, Alloc, Monoid>::const_iterator	const_iterator;
+
+		Compare						less = a.key_comp();
+		ft::vector<const value_type *>	out;
+		const_iterator				first_a = a.begin();
+		const_iterator				last_a = a.end();
+		const_iterator				first_b = b.begin();
+		const_iterator				last_b = b.end();
+
+		out.reserve((only_a || both ? a.size() : 0) + (only_b ? b.size() : 0));
+		while (first_a != last_a && first_b != last_b)
+		{
+			if (less(first_a->first, first_b->first))
+			{
+				if (only_a)
+					out.push_back(&*first_a);
+				++first_a;
+			}
+			else if (less(first_b->first, first_a->first))
+			{
+				if (only_b)
+					out.push_back(&*first_b);
+				++first_b;
+			}
+			else
+			{
+				if (both)
+					out.push_back(&*first_a);
+				++first_a;
+				++first_b;
+			}
+		}
+		for (; only_a && first_a != last_a; ++first_a)
+			out.push_back(&*first_a);
+		for (; only_b && first_b != last_b; ++first_b)
+			out.push_back(&*first_b);
+
+		return (map<Key, T, Compare, Alloc, Monoid>(sorted_unique, _indirect_iterator<value_type>(out.data()),
+			_indirect_iterator<value_type>(out.data() + out.size()), less, a.get_allocator()));
+	};
+
+	// Элементы small, которые есть (или которых нет) в large: m поисков по O(log n).
+	// Значения при совпадении ключей берутся из values_from_large
+	template <typename Key, typename T, class Compare, class Alloc, class Monoid>
+	map<Key, T, Compare, Alloc, Monoid>	_map_probe(const map<Key, T, Compare, Alloc, Monoid> & small, const map<Key, T, Compare, Alloc, Monoid> & large,
+		bool keep_found, bool values_from_large)
+	{
+		typedef typename	map<Key, T, Compare, Alloc, Monoid>::value_type		value_type;
+		typedef typename	map<Key, T, Compare, Alloc, Monoid>::const_iterator	const_iterator;
+
+		ft::vector<const value_type *>	out;
+		const_iterator				last_small = small.end();
+		const_iterator				last_large = large.end();
+
+		out.reserve(small.size());
+		for (const_iterator it = small.begin(); it != last_small; ++it)
+		{
+			const_iterator	found = large.find(it->first);
+
+			if ((found != last_large) == keep_found)
+				out.push_back(values_from_large && keep_found ? &*found : &*it);
+		}
+
+		return (map<Key, T, Compare, Alloc, Monoid>(sorted_unique, _indirect_iterator<value_type>(out.data()),
+			_indirect_iterator<value_type>(out.data() + out.size()), small.key_comp(), small.get_allocator()));
+	};
+
+	// Копия большей map (без сравнений) плюс по одной операции на элемент меньшей
+	template <typename Key, typename T, class Compare, class Alloc, class Monoid>
+	inline bool	_map_skewed(const map<Key, T, Compare, Alloc, Monoid> & small, const map<Key, T, Compare, Alloc, Monoid> & large)
+	{
+		return (small.size() * _map_log2(large) < large.size());
+	};
+
+	enum _map_patch_mode
+	{
+		_patch_insert,		// добавить отсутствующие
+		_patch_assign,		// добавить или перезаписать значение
+		_patch_erase,		// удалить присутствующие
+		_patch_toggle		// удалить присутствующие, добавить отсутствующие
+	};
+
+	// Один именованный результат на функцию, иначе GCC не уберет копию при возврате
+	template <typename Key, typename T, class Compare, class Alloc, class Monoid>
+	map<Key, T, Compare, Alloc, Monoid>	_map_patch(const map<Key, T, Compare, Alloc, Monoid> & large, const map<Key, T, Compare, Alloc, Monoid> & small,
+		_map_patch_mode mode)
+	{
+		typedef typename	map<Key, T, Compare, Alloc, Monoid>::const_iterator	const_iterator;
+
+		map<Key, T, Compare, Alloc, Monoid>	result(large);
+		const_iterator				last = small.end();
+
+		for (const_iterator it = small.begin(); it != last; ++it)
+		{
+			if (mode == _patch_erase)
+				result.erase(it->first);
+			else if (mode == _patch_toggle && result.erase(it->first))
+				continue ;
+			else if (mode == _patch_assign)
+				result.assign(it->first, it->second);
+			else
+				result.insert(*it);
+		}
+		return (result);
+	};
+
+	// Объединение, пересечение и разности ключей двух map; при совпадении ключей
+	// значение берется из a. Обычно это слияние двух обходов со сборкой
+	// сбалансированного результата за O(n + m). Если одна сторона намного меньше,
+	// большая копируется целиком, а меньшая вносится по элементу за O(m log n);
+	// пересечение и a \ b при маленькой a вообще не трогают большую map, кроме поиска
+	template <typename Key, typename T, class Compare, class Alloc, class Monoid>
+	map<Key, T, Compare, Alloc, Monoid>	map_union(const map<Key, T, Compare, Alloc, Monoid> & a, const map<Key, T, Compare, Alloc, Monoid> & b)
+	{
+		if (_map_skewed(b, a))
+			return (_map_patch(a, b, _patch_insert));
+		if (_map_skewed(a, b))
+			return (_map_patch(b, a, _patch_assign));
+		return (_map_merge(a, b, true, true, true));
+	};
+
+	template <typename Key, typename T, class Compare, class Alloc, class Monoid>
+	map<Key, T, Compare, Alloc, Monoid>	map_intersection(const map<Key, T, Compare, Alloc, Monoid> & a, const map<Key, T, Compare, Alloc, Monoid> & b)
+	{
+		if (_map_skewed(a, b))
+			return (_map_probe(a, b, true, false));
+		if (_map_skewed(b, a))
+			return (_map_probe(b, a, true, true));
+		return (_map_merge(a, b, false, false, true));
+	};
+
+	template <typename Key, typename T, class Compare, class Alloc, class Monoid>
+	map<Key, T, Compare, Alloc, Monoid>	map_difference(const map<Key, T, Compare, Alloc, Monoid> & a, const map<Key, T, Compare, Alloc, Monoid> & b)
+	{
+		if (_map_skewed(a, b))
+			return (_map_probe(a, b, false, false));
+		if (_map_skewed(b, a))
+			return (_map_patch(a, b, _patch_erase));
+		return (_map_merge(a, b, true, false, false));
+	};
+
+	template <typename Key, typename T, class Compare, class Alloc, class Monoid>
+	map<Key, T, Compare, Alloc, Monoid>	map_symmetric_difference(const map<Key, T, Compare, Alloc, Monoid> & a, const map<Key, T, Compare, Alloc, Monoid> & b)
+	{
+		if (_map_skewed(b, a))
+			return (_map_patch(a, b, _patch_toggle));
+		if (_map_skewed(a, b))
+			return (_map_patch(b, a, _patch_toggle));
+		return (_map_merge(a, b, true, true, false));
 	};
 };
 
@@ -0,0 +1,361 @@
+#ifndef MAPPED_VECTOR_HPP
+# define MAPPED_VECTOR_HPP
+
+# include <cerrno>
+# include <cstring>
+# include <stdexcept>
+# include <string>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include "type_traits.hpp"
+# include "iterator_traits.hpp"
+# include "vector_iterator.hpp"
+# include "reverse_iterator.hpp"
+
+namespace ft
+{
+	// Вектор записей фиксированного размера поверх файла: открытие - O(1),
+	// страницы подгружаются ядром при первом обращении. Файл хранит ровно
+	// size() записей без заголовка, запас емкости отрезается при close()
+	template <typename T>
+	class mapped_vector
+	{
+		public:
+			typedef typename	ft::enable_if<ft::is_trivially_copyable<T>::value, T>::type	value_type;
+			typedef				value_type &										reference;
+			typedef				const value_type &									const_reference;
+			typedef				value_type *										pointer;
+			typedef				const value_type *									const_pointer;
+			typedef				std::size_t											size_type;
+
+			typedef				ft::vector_iterator<pointer>						iterator;
+			typedef				ft::vector_iterator<const_pointer>					const_iterator;
+			typedef typename	ft::iterator_traits<iterator>::difference_type		difference_type;
+			typedef				ft::reverse_iterator<const_iterator>				const_reverse_iterator;
+			typedef				ft::reverse_iterator<iterator>						reverse_iterator;
+
+			enum open_mode
+			{
+				read_only,
+				read_write,
+				truncate
+			};
+
+		private:
+			int			_fd;
+			bool		_writable;
+			pointer		_values;
+			size_type	_size;
+			size_type	_capacity;
+
+			mapped_vector(const mapped_vector &);
+			mapped_vector &	operator=(const mapped_vector &);
+
+			static void	_fail(const std::string & what)
+			{
+				throw std::runtime_error("mapped_vector: " + what + ": " + std::strerror(errno));
+			};
+
+			// Ошибка после открытия файла: дескриптор закрывается до исключения
+			void	_failOpen(const std::string & what)
+			{
+				int	error = errno;
+
+				this->_close(false);
+				errno = error;
+				_fail(what);
+			};
+
+			// Состояние сбрасывается до отчета об ошибке, так что повторный close()
+			// ничего не делает. Из деструктора вызывается с report = false и не бросает
+			void	_close(bool report)
+			{
+				int			fd = this->_fd;
+				bool		writable = this->_writable;
+				pointer		values = this->_values;
+				size_type	size = this->_size;
+				size_type	capacity = this->_capacity;
+				int			error = 0;
+
+				if (fd == -1)
+					return ;
+
+				this->_fd = -1;
+				this->_writable = false;
+				this->_values = NULL;
+				this->_size = 0;
+				this->_capacity = 0;
+
+				if (values)
+				{
+					if (writable)
+						msync(values, size * sizeof(value_type), MS_SYNC);
+					munmap(values, capacity * sizeof(value_type));
+				}
+				if (writable && capacity != size && ftruncate(fd, size * sizeof(value_type)) == -1)
+					error = errno;
+
+				::close(fd);
+
+				if (error && report)
+				{
+					errno = error;
+					_fail("ftruncate");
+				}
+			};
+
+			void	_checkWritable(void)	const
+			{
+				if (!this->_writable)
+					throw std::logic_error("mapped_vector: opened read-only");
+			};
+
+			// Файл растет через ftruncate, отображение - через mremap без копирования
+			void	_remap(size_type new_capacity)
+			{
+				size_t	old_length = this->_capacity * sizeof(value_type);
+				size_t	new_length = new_capacity * sizeof(value_type);
+
+				if (ftruncate(this->_fd, new_length) == -1)
+					_fail("ftruncate");
+
+				void *	ptr;
+
+				if (!this->_values)
+					ptr = mmap(NULL, new_length, PROT_READ | PROT_WRITE, MAP_SHARED, this->_fd, 0);
+				else
+					ptr = mremap(this->_values, old_length, new_length, MREMAP_MAYMOVE);
+
+				if (ptr == MAP_FAILED)
+					_fail("mmap");
+
+				this->_values = static_cast<pointer>(ptr);
+				this->_capacity = new_capacity;
+			};
+
+		public:
+			mapped_vector(void)
+				: _fd(-1), _writable(false), _values(NULL), _size(0), _capacity(0)
+			{};
+
+			explicit mapped_vector(const char * path, open_mode mode = read_write)
+				: _fd(-1), _writable(false), _values(NULL), _size(0), _capacity(0)
+			{
+				this->open(path, mode);
+			};
+
+			~mapped_vector()
+			{
+				this->_close(false);
+			};
+
+			void	open(const char * path, open_mode mode = read_write)
+			{
+				int			flags = mode == read_only ? O_RDONLY : O_RDWR | O_CREAT;
+				struct stat	st;
+
+				this->close();
+
+				if (mode == truncate)
+					flags |= O_TRUNC;
+				if ((this->_fd = ::open(path, flags, 0644)) == -1)
+					_fail(std::string("open ") + path);
+				if (fstat(this->_fd, &st) == -1)
+					this->_failOpen("fstat");
+
+				this->_writable = mode != read_only;
+				this->_size = st.st_size / sizeof(value_type);
+				this->_capacity = this->_size;
+
+				if (!this->_size)
+					return ;
+
+				void *	ptr = mmap(NULL, this->_size * sizeof(value_type),
+					this->_writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, this->_fd, 0);
+
+				if (ptr == MAP_FAILED)
+					this->_failOpen("mmap");
+
+				this->_values = static_cast<pointer>(ptr);
+			};
+
+			// Сбрасывает записи на диск и отрезает неиспользованную емкость
+			void	close(void)
+			{
+				this->_close(true);
+			};
+
+			inline bool	is_open(void)	const {
+				return (this->_fd != -1);
+			};
+
+			void	flush(bool async = false) {
+				if (this->_values && this->_writable
+					&& msync(this->_values, this->_size * sizeof(value_type), async ? MS_ASYNC : MS_SYNC) == -1)
+					_fail("msync");
+			};
+
+			// Подсказка ядру о характере доступа (MADV_SEQUENTIAL для сканов, MADV_RANDOM для поиска)
+			void	advise(int advice) {
+				if (this->_values)
+					madvise(this->_values, this->_capacity * sizeof(value_type), advice);
+			};
+
+			inline reference	operator[](size_type n) {
+				return (this->_values[n]);
+			};
+
+			inline const_reference	operator[](size_type n)	const {
+				return (this->_values[n]);
+			};
+
+			reference	at(size_type n) {
+				if (!(n < this->_size))
+					throw std::out_of_range("mapped_vector");
+
+				return (this->_values[n]);
+			};
+
+			const_reference	at(size_type n)	const {
+				if (!(n < this->_size))
+					throw std::out_of_range("mapped_vector");
+
+				return (this->_values[n]);
+			};
+
+			inline iterator	begin(void) {
+				return (iterator(this->_values));
+			};
+
+			inline const_iterator	begin(void)	const {
+				return (const_iterator(this->_values));
+			};
+
+			inline iterator	end(void) {
+				return (iterator(this->_values + this->_size));
+			};
+
+			inline const_iterator	end(void)	const {
+				return (const_iterator(this->_values + this->_size));
+			};
+
+			inline reverse_iterator	rbegin(void) {
+				return (reverse_iterator(this->end()));
+			};
+
+			inline const_reverse_iterator	rbegin(void)	const {
+				return (const_reverse_iterator(this->end()));
+			};
+
+			inline reverse_iterator	rend(void) {
+				return (reverse_iterator(this->begin()));
+			};
+
+			inline const_reverse_iterator	rend(void)	const {
+				return (const_reverse_iterator(this->begin()));
+			};
+
+			inline reference	front(void) {
+				return (*this->_values);
+			};
+
+			inline const_reference	front(void)	const {
+				return (*this->_values);
+			};
+
+			inline reference	back(void) {
+				return (this->_values[this->_size - 1]);
+			};
+
+			inline const_reference	back(void)	const {
+				return (this->_values[this->_size - 1]);
+			};
+
+			inline pointer	data(void) {
+				return (this->_values);
+			};
+
+			inline const_pointer	data(void)	const {
+				return (this->_values);
+			};
+
+			inline size_type	size(void)	const {
+				return (this->_size);
+			};
+
+			inline size_type	capacity(void)	const {
+				return (this->_capacity);
+			};
+
+			inline bool	empty(void)	const {
+				return (!this->_size);
+			};
+
+			inline size_type	max_size(void)	const {
+				return (size_type(-1) / sizeof(value_type));
+			};
+
+			void	reserve(size_type n) {
+				this->_checkWritable();
+				if (n <= this->_capacity)
+					return ;
+				this->_remap(n);
+			};
+
+			// Новые записи заполняются нулями (так ftruncate расширяет файл)
+			void	resize(size_type n) {
+				size_type	stale_end = n < this->_capacity ? n : this->_capacity;
+
+				this->_checkWritable();
+				if (n > this->_size && stale_end > this->_size)
+					std::memset(static_cast<void *>(this->_values + this->_size), 0, (stale_end - this->_size) * sizeof(value_type));
+				if (n > this->_capacity)
+					this->_remap(n);
+				this->_size = n;
+			};
+
+			void	push_back(const_reference val) {
+				this->_checkWritable();
+				if (this->_size == this->_capacity)
+					this->_remap(this->_capacity * 2 + !this->_capacity);
+				this->_values[this->_size++] = val;
+			};
+
+			void	pop_back(void) {
+				if (this->_size)
+					this->_size--;
+			};
+
+			void	clear(void) {
+				this->_size = 0;
+			};
+
+			void	swap(mapped_vector & src) {
+				int			fd_buf = src._fd;
+				bool		writable_buf = src._writable;
+				pointer		values_buf = src._values;
+				size_type	size_buf = src._size;
+				size_type	capacity_buf = src._capacity;
+
+				src._fd = this->_fd;
+				src._writable = this->_writable;
+				src._values = this->_values;
+				src._size = this->_size;
+				src._capacity = this->_capacity;
+				this->_fd = fd_buf;
+				this->_writable = writable_buf;
+				this->_values = values_buf;
+				this->_size = size_buf;
+				this->_capacity = capacity_buf;
+			};
+	};
+
+	template <typename T>
+	inline void	swap(mapped_vector<T> & lhd, mapped_vector<T> & rhd) {
+		lhd.swap(rhd);
+	};
+};
+
+#endif
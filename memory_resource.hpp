@@ -0,0 +1,561 @@
+#ifndef MEMORY_RESOURCE_HPP
+# define MEMORY_RESOURCE_HPP
+
+# include <cstddef>
+# include <cstdlib>
+# include <functional>
+# include <new>
+# include "vector.hpp"
+# include "map.hpp"
+
+namespace ft
+{
+	// Источник памяти с виртуальным интерфейсом: контейнеры с polymorphic_allocator
+	// имеют один тип, а откуда берется память, решается во время выполнения
+	class memory_resource
+	{
+		public:
+			static const std::size_t	max_align = __BIGGEST_ALIGNMENT__;
+
+			virtual ~memory_resource() {};
+
+			void *	allocate(std::size_t bytes, std::size_t alignment = max_align)
+			{
+				return (this->do_allocate(bytes, alignment));
+			};
+
+			void	deallocate(void * p, std::size_t bytes, std::size_t alignment = max_align)
+			{
+				this->do_deallocate(p, bytes, alignment);
+			};
+
+			bool	is_equal(const memory_resource & other)	const
+			{
+				return (this->do_is_equal(other));
+			};
+
+		protected:
+			virtual void *	do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+			virtual void	do_deallocate(void * p, std::size_t bytes, std::size_t alignment) = 0;
+
+			virtual bool	do_is_equal(const memory_resource & other)	const
+			{
+				return (this == &other);
+			};
+	};
+
+	inline bool	operator==(const memory_resource & lhd, const memory_resource & rhd)
+	{
+		return (&lhd == &rhd || lhd.is_equal(rhd));
+	};
+
+	inline bool	operator!=(const memory_resource & lhd, const memory_resource & rhd)
+	{
+		return !(lhd == rhd);
+	};
+
+	// operator new/delete, для выравнивания сверх max_align - posix_memalign
+	class _new_delete_resource : public memory_resource
+	{
+		protected:
+			void *	do_allocate(std::size_t bytes, std::size_t alignment)
+			{
+				if (alignment <= max_align)
+					return (::operator new(bytes));
+
+				void *	p;
+
+				if (posix_memalign(&p, alignment, bytes))
+					throw std::bad_alloc();
+				return (p);
+			};
+
+			void	do_deallocate(void * p, std::size_t, std::size_t alignment)
+			{
+				if (alignment <= max_align)
+					::operator delete(p);
+				else
+					free(p);
+			};
+
+			bool	do_is_equal(const memory_resource & other)	const
+			{
+				return (dynamic_cast<const _new_delete_resource *>(&other) != NULL);
+			};
+	};
+
+	inline memory_resource *	new_delete_resource(void)
+	{
+		static _new_delete_resource	resource;
+
+		return (&resource);
+	};
+
+	inline memory_resource *&	_default_resource(void)
+	{
+		static memory_resource *	resource = new_delete_resource();
+
+		return (resource);
+	};
+
+	inline memory_resource *	get_default_resource(void)
+	{
+		return (__atomic_load_n(&_default_resource(), __ATOMIC_ACQUIRE));
+	};
+
+	// Возвращает прежний ресурс; NULL возвращает new_delete_resource
+	inline memory_resource *	set_default_resource(memory_resource * resource)
+	{
+		if (!resource)
+			resource = new_delete_resource();
+		return (__atomic_exchange_n(&_default_resource(), resource, __ATOMIC_ACQ_REL));
+	};
+
+	inline std::size_t	_align_up(std::size_t value, std::size_t alignment)
+	{
+		return ((value + alignment - 1) & ~(alignment - 1));
+	};
+
+	// Арена: выделение - сдвиг указателя, deallocate ничего не делает, вся память
+	// возвращается разом в release() или деструкторе. Каждый следующий блок у upstream
+	// вдвое больше предыдущего. Не потокобезопасна
+	class monotonic_buffer_resource : public memory_resource
+	{
+		private:
+			struct _chunk
+			{
+				_chunk *	next;
+				std::size_t	size;
+				std::size_t	alignment;
+			};
+
+			static const std::size_t	_default_size = 1024;
+
+			memory_resource *	_upstream;
+			void *				_initial_buffer;
+			std::size_t			_initial_size;
+			char *				_current;
+			std::size_t			_remaining;
+			std::size_t			_first_size;
+			std::size_t			_next_size;
+			_chunk *			_chunks;
+
+			monotonic_buffer_resource(const monotonic_buffer_resource &);
+			monotonic_buffer_resource &	operator=(const monotonic_buffer_resource &);
+
+			void	_grow(std::size_t bytes, std::size_t alignment)
+			{
+				std::size_t	header = _align_up(sizeof(_chunk), alignment);
+				std::size_t	size = this->_next_size;
+
+				if (size < header + bytes)
+					size = header + bytes;
+				if (alignment < max_align)
+					alignment = max_align;
+
+				_chunk *	chunk = static_cast<_chunk *>(this->_upstream->allocate(size, alignment));
+
+				chunk->next = this->_chunks;
+				chunk->size = size;
+				chunk->alignment = alignment;
+				this->_chunks = chunk;
+				this->_current = reinterpret_cast<char *>(chunk) + header;
+				this->_remaining = size - header;
+				this->_next_size = size * 2;
+			};
+
+		protected:
+			void *	do_allocate(std::size_t bytes, std::size_t alignment)
+			{
+				if (!bytes)
+					bytes = 1;
+
+				std::size_t	padding = (alignment - reinterpret_cast<std::size_t>(this->_current) % alignment) % alignment;
+
+				if (!this->_current || padding + bytes > this->_remaining)
+				{
+					this->_grow(bytes, alignment);
+					padding = 0;
+				}
+
+				void *	p = this->_current + padding;
+
+				this->_current += padding + bytes;
+				this->_remaining -= padding + bytes;
+				return (p);
+			};
+
+			void	do_deallocate(void *, std::size_t, std::size_t) {};
+
+		public:
+			explicit monotonic_buffer_resource(memory_resource * upstream = get_default_resource())
+				: _upstream(upstream), _initial_buffer(NULL), _initial_size(0),
+				_current(NULL), _remaining(0), _first_size(_default_size), _next_size(_default_size), _chunks(NULL)
+			{};
+
+			explicit monotonic_buffer_resource(std::size_t initial_size, memory_resource * upstream = get_default_resource())
+				: _upstream(upstream), _initial_buffer(NULL), _initial_size(0),
+				_current(NULL), _remaining(0), _first_size(initial_size ? initial_size : 1),
+				_next_size(_first_size), _chunks(NULL)
+			{};
+
+			// Сначала расходуется buffer (например, массив на стеке), затем upstream
+			monotonic_buffer_resource(void * buffer, std::size_t size, memory_resource * upstream = get_default_resource())
+				: _upstream(upstream), _initial_buffer(buffer), _initial_size(size),
+				_current(static_cast<char *>(buffer)), _remaining(size), _first_size(size ? size * 2 : _default_size),
+				_next_size(_first_size), _chunks(NULL)
+			{};
+
+			~monotonic_buffer_resource()
+			{
+				this->release();
+			};
+
+			void	release(void)
+			{
+				while (this->_chunks)
+				{
+					_chunk *	next = this->_chunks->next;
+
+					this->_upstream->deallocate(this->_chunks, this->_chunks->size, this->_chunks->alignment);
+					this->_chunks = next;
+				}
+				this->_current = static_cast<char *>(this->_initial_buffer);
+				this->_remaining = this->_initial_size;
+				this->_next_size = this->_first_size;
+			};
+
+			memory_resource *	upstream_resource(void)	const
+			{
+				return (this->_upstream);
+			};
+	};
+
+	// Пулы блоков размером 2^k (от 8 байт до largest_pooled_block) со списками
+	// свободных блоков; блоки нарезаются из кусков upstream, число блоков в куске
+	// растет вдвое до max_blocks_per_chunk. Крупные запросы идут в upstream напрямую,
+	// но тоже учитываются, чтобы release() вернул все. Не потокобезопасен
+	class unsynchronized_pool_resource : public memory_resource
+	{
+		public:
+			static const std::size_t	default_max_blocks_per_chunk = 1024;
+			static const std::size_t	default_largest_pooled_block = 4096;
+
+		private:
+			static const std::size_t	_min_shift = 3;
+			static const std::size_t	_pools_count = 13;	// 8 .. 32 КиБ
+
+			struct _free_block
+			{
+				_free_block *	next;
+			};
+
+			struct _chunk
+			{
+				_chunk *	next;
+				std::size_t	size;
+				std::size_t	alignment;
+			};
+
+			struct _pool
+			{
+				_free_block *	free;
+				char *			current;
+				char *			end;
+				std::size_t		next_blocks;
+			};
+
+			// Заголовок крупного блока, список двусвязный для удаления за O(1)
+			struct _large
+			{
+				_large *	prev;
+				_large *	next;
+				std::size_t	size;
+				std::size_t	alignment;
+			};
+
+			memory_resource *	_upstream;
+			std::size_t			_max_blocks_per_chunk;
+			std::size_t			_largest_pooled_block;
+			_pool				_pools[_pools_count];
+			_chunk *			_chunks;
+			_large *			_large_blocks;
+
+			unsynchronized_pool_resource(const unsynchronized_pool_resource &);
+			unsynchronized_pool_resource &	operator=(const unsynchronized_pool_resource &);
+
+			static std::size_t	_poolIndex(std::size_t bytes)
+			{
+				std::size_t	k = 0;
+
+				while ((std::size_t(1) << (k + _min_shift)) < bytes)
+					k++;
+				return (k);
+			};
+
+			static std::size_t	_largeHeader(std::size_t alignment)
+			{
+				return (_align_up(sizeof(_large), alignment));
+			};
+
+			void	_refill(_pool & pool, std::size_t block)
+			{
+				std::size_t	alignment = block < max_align ? max_align : block;
+				std::size_t	header = _align_up(sizeof(_chunk), alignment);
+				std::size_t	size = header + pool.next_blocks * block;
+				_chunk *	chunk = static_cast<_chunk *>(this->_upstream->allocate(size, alignment));
+
+				chunk->next = this->_chunks;
+				chunk->size = size;
+				chunk->alignment = alignment;
+				this->_chunks = chunk;
+				pool.current = reinterpret_cast<char *>(chunk) + header;
+				pool.end = reinterpret_cast<char *>(chunk) + size;
+				if (pool.next_blocks < this->_max_blocks_per_chunk)
+					pool.next_blocks *= 2;
+			};
+
+			void	_reset(void)
+			{
+				for (std::size_t i = 0; i < _pools_count; i++)
+				{
+					this->_pools[i].free = NULL;
+					this->_pools[i].current = NULL;
+					this->_pools[i].end = NULL;
+					this->_pools[i].next_blocks = 16;
+				}
+				this->_chunks = NULL;
+				this->_large_blocks = NULL;
+			};
+
+		protected:
+			void *	do_allocate(std::size_t bytes, std::size_t alignment)
+			{
+				std::size_t	block = bytes < alignment ? alignment : bytes;
+
+				if (block <= this->_largest_pooled_block)
+				{
+					std::size_t	index = _poolIndex(block);
+					_pool &		pool = this->_pools[index];
+
+					block = std::size_t(1) << (index + _min_shift);
+					if (pool.free)
+					{
+						_free_block *	p = pool.free;
+
+						pool.free = p->next;
+						return (p);
+					}
+					if (pool.current == pool.end)
+						this->_refill(pool, block);
+
+					void *	p = pool.current;
+
+					pool.current += block;
+					return (p);
+				}
+
+				if (alignment < max_align)
+					alignment = max_align;
+
+				std::size_t	header = _largeHeader(alignment);
+				_large *	large = static_cast<_large *>(this->_upstream->allocate(header + bytes, alignment));
+
+				large->prev = NULL;
+				large->next = this->_large_blocks;
+				large->size = header + bytes;
+				large->alignment = alignment;
+				if (this->_large_blocks)
+					this->_large_blocks->prev = large;
+				this->_large_blocks = large;
+				return (reinterpret_cast<char *>(large) + header);
+			};
+
+			void	do_deallocate(void * p, std::size_t bytes, std::size_t alignment)
+			{
+				std::size_t	block = bytes < alignment ? alignment : bytes;
+
+				if (block <= this->_largest_pooled_block)
+				{
+					_pool &			pool = this->_pools[_poolIndex(block)];
+					_free_block *	node = static_cast<_free_block *>(p);
+
+					node->next = pool.free;
+					pool.free = node;
+					return ;
+				}
+
+				if (alignment < max_align)
+					alignment = max_align;
+
+				_large *	large = reinterpret_cast<_large *>(static_cast<char *>(p) - _largeHeader(alignment));
+
+				if (large->prev)
+					large->prev->next = large->next;
+				else
+					this->_large_blocks = large->next;
+				if (large->next)
+					large->next->prev = large->prev;
+				this->_upstream->deallocate(large, large->size, large->alignment);
+			};
+
+		public:
+			explicit unsynchronized_pool_resource(memory_resource * upstream = get_default_resource(),
+				std::size_t max_blocks_per_chunk = default_max_blocks_per_chunk,
+				std::size_t largest_pooled_block = default_largest_pooled_block)
+				: _upstream(upstream), _max_blocks_per_chunk(max_blocks_per_chunk),
+				_largest_pooled_block(largest_pooled_block)
+			{
+				std::size_t	limit = std::size_t(1) << (_pools_count - 1 + _min_shift);
+
+				if (this->_largest_pooled_block > limit)
+					this->_largest_pooled_block = limit;
+				this->_reset();
+			};
+
+			~unsynchronized_pool_resource()
+			{
+				this->release();
+			};
+
+			void	release(void)
+			{
+				while (this->_chunks)
+				{
+					_chunk *	next = this->_chunks->next;
+
+					this->_upstream->deallocate(this->_chunks, this->_chunks->size, this->_chunks->alignment);
+					this->_chunks = next;
+				}
+				while (this->_large_blocks)
+				{
+					_large *	next = this->_large_blocks->next;
+
+					this->_upstream->deallocate(this->_large_blocks, this->_large_blocks->size, this->_large_blocks->alignment);
+					this->_large_blocks = next;
+				}
+				this->_reset();
+			};
+
+			memory_resource *	upstream_resource(void)	const
+			{
+				return (this->_upstream);
+			};
+	};
+
+	// Аллокатор поверх memory_resource: тип контейнера не зависит от источника памяти
+	template <typename T>
+	class polymorphic_allocator
+	{
+		public:
+			typedef				T						value_type;
+			typedef				T *						pointer;
+			typedef				const T *				const_pointer;
+			typedef				T &						reference;
+			typedef				const T &				const_reference;
+			typedef				std::size_t				size_type;
+			typedef				std::ptrdiff_t			difference_type;
+
+			template <typename U>
+			struct rebind
+			{
+				typedef	polymorphic_allocator<U>	other;
+			};
+
+		private:
+			memory_resource *	_resource;
+
+		public:
+			polymorphic_allocator(void) : _resource(get_default_resource()) {};
+
+			polymorphic_allocator(memory_resource * resource) : _resource(resource) {};
+
+			polymorphic_allocator(const polymorphic_allocator & src) : _resource(src._resource) {};
+
+			template <typename U>
+			polymorphic_allocator(const polymorphic_allocator<U> & src) : _resource(src.resource()) {};
+
+			~polymorphic_allocator() {};
+
+			polymorphic_allocator &	operator=(const polymorphic_allocator & rhd)
+			{
+				this->_resource = rhd._resource;
+				return (*this);
+			};
+
+			memory_resource *	resource(void)	const
+			{
+				return (this->_resource);
+			};
+
+			pointer	address(reference x)	const
+			{
+				return (&x);
+			};
+
+			const_pointer	address(const_reference x)	const
+			{
+				return (&x);
+			};
+
+			pointer	allocate(size_type n, const void * hint = 0)
+			{
+				(void)hint;
+				if (n > this->max_size())
+					throw std::bad_alloc();
+				return (static_cast<pointer>(this->_resource->allocate(n * sizeof(T), __alignof__(T))));
+			};
+
+			void	deallocate(pointer p, size_type n)
+			{
+				if (p)
+					this->_resource->deallocate(p, n * sizeof(T), __alignof__(T));
+			};
+
+			size_type	max_size(void)	const
+			{
+				return (size_type(-1) / sizeof(T));
+			};
+
+			void	construct(pointer p, const_reference val)
+			{
+				::new (static_cast<void *>(p)) T(val);
+			};
+
+			void	destroy(pointer p)
+			{
+				p->~T();
+			};
+	};
+
+	template <typename T, typename U>
+	inline bool	operator==(const polymorphic_allocator<T> & lhd, const polymorphic_allocator<U> & rhd)
+	{
+		return (*lhd.resource() == *rhd.resource());
+	};
+
+	template <typename T, typename U>
+	inline bool	operator!=(const polymorphic_allocator<T> & lhd, const polymorphic_allocator<U> & rhd)
+	{
+		return !(lhd == rhd);
+	};
+
+	// В C++98 нет шаблонных псевдонимов, поэтому тип берется через ::type:
+	// ft::pmr::vector<int>::type v(&arena);
+	namespace pmr
+	{
+		template <typename T>
+		struct vector
+		{
+			typedef	ft::vector<T, polymorphic_allocator<T> >	type;
+		};
+
+		template <typename Key, typename T, class Compare = std::less<Key> >
+		struct map
+		{
+			typedef	ft::map<Key, T, Compare, polymorphic_allocator<ft::pair<const Key, T> > >	type;
+		};
+	};
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef MEMORY_USAGE_HPP
+# define MEMORY_USAGE_HPP
+
+# include <cstddef>
+
+namespace ft
+{
+	// Разбивка памяти контейнера: сами элементы, служебные данные
+	// (объект контейнера, ссылки и цвет узлов дерева) и выделенный, но пустой запас
+	struct memory_usage_info
+	{
+		std::size_t	payload_bytes;
+		std::size_t	overhead_bytes;
+		std::size_t	unused_bytes;
+
+		memory_usage_info(void) : payload_bytes(0), overhead_bytes(0), unused_bytes(0) {};
+
+		std::size_t	total_bytes(void)	const
+		{
+			return (this->payload_bytes + this->overhead_bytes + this->unused_bytes);
+		};
+	};
+};
+
+#endif
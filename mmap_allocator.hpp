@@ -0,0 +1,273 @@
+#ifndef MMAP_ALLOCATOR_HPP
+# define MMAP_ALLOCATOR_HPP
+
+# include <cstddef>
+# include <cstring>
+# include <new>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+
+namespace ft
+{
+	// Флаги для mmap_allocator/hugepage_allocator, комбинируются через |
+	enum
+	{
+		MMAP_DEFAULT			= 0,
+		MMAP_POPULATE			= 1,	// сразу подгрузить страницы (MAP_POPULATE)
+		MMAP_TRANSPARENT_HUGE	= 2,	// выровнять по 2 МиБ и попросить THP (MADV_HUGEPAGE)
+		MMAP_EXPLICIT_HUGE		= 4		// MAP_HUGETLB, при неудаче - откат на THP
+	};
+
+	// Низкоуровневая работа с отображениями, общая для всех типов элементов
+	struct _mmap_region
+	{
+		static const size_t	huge_page_size = 2 * 1024 * 1024;
+
+		static size_t	roundUp(size_t bytes, size_t to)
+		{
+			return ((bytes + to - 1) / to * to);
+		};
+
+		// Длина, которую надо будет передать в munmap: зависит только от размера и флагов,
+		// поэтому deallocate восстанавливает ее без хранения заголовка
+		static size_t	mappedLength(size_t bytes, int flags)
+		{
+			if (flags & (MMAP_TRANSPARENT_HUGE | MMAP_EXPLICIT_HUGE))
+				return (roundUp(bytes, huge_page_size));
+			return (roundUp(bytes, static_cast<size_t>(sysconf(_SC_PAGESIZE))));
+		};
+
+		static void *	map(size_t bytes, int flags, int numa_node)
+		{
+			size_t	length = mappedLength(bytes, flags);
+			int		populate = (flags & MMAP_POPULATE) && numa_node < 0 ? MAP_POPULATE : 0;
+			void *	ptr = MAP_FAILED;
+
+			if (flags & MMAP_EXPLICIT_HUGE)
+				ptr = mmap(NULL, length, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+
+			if (ptr == MAP_FAILED && (flags & (MMAP_TRANSPARENT_HUGE | MMAP_EXPLICIT_HUGE)))
+				ptr = mapAligned(length, populate);
+			else if (ptr == MAP_FAILED)
+				ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | populate, -1, 0);
+
+			if (ptr == MAP_FAILED)
+				throw std::bad_alloc();
+
+			if (numa_node >= 0)
+				bindToNode(ptr, length, numa_node, flags & MMAP_POPULATE);
+
+			return (ptr);
+		};
+
+		static void	unmap(void * ptr, size_t bytes, int flags)
+		{
+			munmap(ptr, mappedLength(bytes, flags));
+		};
+
+		// THP складывает только выровненные 2 МиБ участки: берем с запасом и обрезаем края
+		static void *	mapAligned(size_t length, int populate)
+		{
+			char *	raw = static_cast<char *>(mmap(NULL, length + huge_page_size, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+
+			if (raw == reinterpret_cast<char *>(MAP_FAILED))
+				return (MAP_FAILED);
+
+			char *	aligned = reinterpret_cast<char *>(roundUp(reinterpret_cast<size_t>(raw), huge_page_size));
+
+			if (aligned != raw)
+				munmap(raw, aligned - raw);
+			if (aligned + length != raw + length + huge_page_size)
+				munmap(aligned + length, raw + huge_page_size - aligned);
+
+# ifdef MADV_HUGEPAGE
+			madvise(aligned, length, MADV_HUGEPAGE);
+# endif
+			if (populate)
+				prefault(aligned, length);
+
+			return (aligned);
+		};
+
+		// mbind должен случиться до первого касания, поэтому MAP_POPULATE тут не годится
+		static void	bindToNode(void * ptr, size_t length, int numa_node, bool populate)
+		{
+# ifdef SYS_mbind
+			const int		mpol_bind = 2;
+			unsigned long	nodemask[4];
+
+			if (numa_node < static_cast<int>(sizeof(nodemask) * 8))
+			{
+				std::memset(nodemask, 0, sizeof(nodemask));
+				nodemask[numa_node / (sizeof(unsigned long) * 8)] |= 1UL << (numa_node % (sizeof(unsigned long) * 8));
+				syscall(SYS_mbind, ptr, length, mpol_bind, nodemask, sizeof(nodemask) * 8, 0);
+			}
+# else
+			(void)numa_node;
+# endif
+			if (populate)
+				prefault(ptr, length);
+		};
+
+		static void	prefault(void * ptr, size_t length)
+		{
+# ifdef MADV_POPULATE_WRITE
+			if (!madvise(ptr, length, MADV_POPULATE_WRITE))
+				return ;
+# endif
+			size_t	page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+			for (size_t offset = 0; offset < length; offset += page)
+				static_cast<volatile char *>(ptr)[offset] = 0;
+		};
+	};
+
+	// Большие блоки берутся прямо у ядра через mmap, мелкие (узлы дерева и т.п.)
+	// ниже threshold уходят в operator new, чтобы не тратить страницу на узел
+	template <typename T>
+	class mmap_allocator
+	{
+		public:
+			typedef				T						value_type;
+			typedef				T *						pointer;
+			typedef				const T *				const_pointer;
+			typedef				T &						reference;
+			typedef				const T &				const_reference;
+			typedef				std::size_t				size_type;
+			typedef				std::ptrdiff_t			difference_type;
+
+			template <typename U>
+			struct rebind
+			{
+				typedef	mmap_allocator<U>	other;
+			};
+
+			static const size_type	default_threshold = 64 * 1024;
+
+			int			flags;
+			int			numa_node;
+			size_type	threshold;
+
+			explicit mmap_allocator(int flags = MMAP_TRANSPARENT_HUGE, int numa_node = -1, size_type threshold = default_threshold)
+				: flags(flags), numa_node(numa_node), threshold(threshold)
+			{};
+
+			mmap_allocator(const mmap_allocator & src)
+				: flags(src.flags), numa_node(src.numa_node), threshold(src.threshold)
+			{};
+
+			template <typename U>
+			mmap_allocator(const mmap_allocator<U> & src)
+				: flags(src.flags), numa_node(src.numa_node), threshold(src.threshold)
+			{};
+
+			~mmap_allocator() {};
+
+			mmap_allocator &	operator=(const mmap_allocator & rhd)
+			{
+				this->flags = rhd.flags;
+				this->numa_node = rhd.numa_node;
+				this->threshold = rhd.threshold;
+
+				return (*this);
+			};
+
+			pointer	address(reference x)	const
+			{
+				return (&x);
+			};
+
+			const_pointer	address(const_reference x)	const
+			{
+				return (&x);
+			};
+
+			pointer	allocate(size_type n, const void * hint = 0)
+			{
+				size_type	bytes = n * sizeof(T);
+
+				(void)hint;
+				if (n > this->max_size())
+					throw std::bad_alloc();
+				if (bytes < this->threshold)
+					return (static_cast<pointer>(::operator new(bytes)));
+
+				return (static_cast<pointer>(_mmap_region::map(bytes, this->flags, this->numa_node)));
+			};
+
+			void	deallocate(pointer p, size_type n)
+			{
+				size_type	bytes = n * sizeof(T);
+
+				if (!p)
+					return ;
+				if (bytes < this->threshold)
+					::operator delete(p);
+				else
+					_mmap_region::unmap(p, bytes, this->flags);
+			};
+
+			size_type	max_size(void)	const
+			{
+				return (size_type(-1) / sizeof(T));
+			};
+
+			void	construct(pointer p, const_reference val)
+			{
+				::new (static_cast<void *>(p)) T(val);
+			};
+
+			void	destroy(pointer p)
+			{
+				p->~T();
+			};
+	};
+
+	// То же самое, но по умолчанию с явными huge pages и порогом в одну большую страницу
+	template <typename T>
+	class hugepage_allocator : public mmap_allocator<T>
+	{
+		public:
+			typedef typename	mmap_allocator<T>::size_type	size_type;
+
+			template <typename U>
+			struct rebind
+			{
+				typedef	hugepage_allocator<U>	other;
+			};
+
+			explicit hugepage_allocator(int flags = MMAP_EXPLICIT_HUGE | MMAP_TRANSPARENT_HUGE, int numa_node = -1,
+				size_type threshold = _mmap_region::huge_page_size)
+				: mmap_allocator<T>(flags, numa_node, threshold)
+			{};
+
+			hugepage_allocator(const hugepage_allocator & src)
+				: mmap_allocator<T>(src)
+			{};
+
+			template <typename U>
+			hugepage_allocator(const hugepage_allocator<U> & src)
+				: mmap_allocator<T>(src)
+			{};
+
+			~hugepage_allocator() {};
+	};
+
+	// Память одного аллокатора можно вернуть через другой, если совпадают правила отображения
+	template <typename T, typename U>
+	inline bool	operator==(const mmap_allocator<T> & lhd, const mmap_allocator<U> & rhd)
+	{
+		return (lhd.flags == rhd.flags && lhd.threshold == rhd.threshold);
+	};
+
+	template <typename T, typename U>
+	inline bool	operator!=(const mmap_allocator<T> & lhd, const mmap_allocator<U> & rhd)
+	{
+		return !(lhd == rhd);
+	};
+};
+
+#endif
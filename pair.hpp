@@ -25,6 +25,7 @@ namespace ft {
 			{
 				this->first = rhd.first;
 				this->second = rhd.second;
+				return (*this);
 			};
 
 			void swap(pair &other)
@@ -57,7 +58,7 @@ namespace ft {
 	template <typename T1, typename T2>
 	inline bool	operator<(pair<T1, T2> const & lhd, pair<T1, T2> const & rhd)
 	{
-		return (lhd.first < rhd.first || (!(lhd.first > rhd.first) && lhd.second == rhd.second));
+		return (lhd.first < rhd.first || (!(rhd.first < lhd.first) && lhd.second < rhd.second));
 	};
 
 	template <typename T1, typename T2>
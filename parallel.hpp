@@ -0,0 +1,572 @@
+#ifndef PARALLEL_HPP
+# define PARALLEL_HPP
+
+# include <cstddef>
+# include <algorithm>
+# include <new>
+# include <stdexcept>
+# include <pthread.h>
+# include <unistd.h>
+# include "algorithm.hpp"
+# include "vector.hpp"
+
+// Параллельные for_each/transform/reduce/fill/copy для диапазонов с произвольным
+// доступом (ft::vector и указатели). Нужна сборка с -pthread
+namespace ft
+{
+	namespace parallel
+	{
+		inline std::size_t	hardware_concurrency(void)
+		{
+			long	n = sysconf(_SC_NPROCESSORS_ONLN);
+
+			return (n > 0 ? static_cast<std::size_t>(n) : 1);
+		};
+
+		// Пул потоков, который выполняет одну задачу за раз: диапазон [0, n) режется
+		// на куски по grain, потоки (и вызывающий тоже) разбирают их атомарным счетчиком
+		class thread_pool
+		{
+			private:
+				typedef void	(*_function)(void *, std::size_t, std::size_t);
+
+				pthread_mutex_t		_mutex;
+				pthread_mutex_t		_run_mutex;
+				pthread_cond_t		_wake;
+				pthread_cond_t		_done;
+				pthread_t *			_threads;
+				std::size_t			_count;
+				unsigned long		_generation;
+				bool				_stop;
+
+				_function			_fn;
+				void *				_ctx;
+				std::size_t			_n;
+				std::size_t			_grain;
+				std::size_t			_next;
+				std::size_t			_active;
+				bool				_failed;
+
+				thread_pool(const thread_pool &);
+				thread_pool &	operator=(const thread_pool &);
+
+				// Вложенный вызов из тела задачи выполняется последовательно, а не ждет сам себя
+				static bool &	_insideTask(void)
+				{
+					static __thread bool	inside = false;
+
+					return (inside);
+				};
+
+				static void *	_trampoline(void * self)
+				{
+					static_cast<thread_pool *>(self)->_loop();
+					return (NULL);
+				};
+
+				// Если тело бросило, оставшиеся куски никто не берет
+				void	_work(void)
+				{
+					std::size_t	begin;
+
+					_insideTask() = true;
+					try
+					{
+						while ((begin = __atomic_fetch_add(&this->_next, this->_grain, __ATOMIC_RELAXED)) < this->_n)
+							this->_fn(this->_ctx, begin, begin + this->_grain < this->_n ? begin + this->_grain : this->_n);
+					}
+					catch (...)
+					{
+						_insideTask() = false;
+						__atomic_store_n(&this->_next, this->_n, __ATOMIC_RELAXED);
+						throw ;
+					}
+					_insideTask() = false;
+				};
+
+				// Ждет потоки пула и освобождает run; true - тело бросило в потоке пула
+				bool	_finish(void)
+				{
+					bool	failed;
+
+					pthread_mutex_lock(&this->_mutex);
+					while (this->_active)
+						pthread_cond_wait(&this->_done, &this->_mutex);
+					failed = this->_failed;
+					this->_failed = false;
+					pthread_mutex_unlock(&this->_mutex);
+					pthread_mutex_unlock(&this->_run_mutex);
+					return (failed);
+				};
+
+				void	_loop(void)
+				{
+					unsigned long	seen = 0;
+
+					pthread_mutex_lock(&this->_mutex);
+					for (;;)
+					{
+						while (!this->_stop && this->_generation == seen)
+							pthread_cond_wait(&this->_wake, &this->_mutex);
+						if (this->_stop)
+							break ;
+						seen = this->_generation;
+						pthread_mutex_unlock(&this->_mutex);
+
+						// Флаг превращается в runtime_error в вызывающем потоке
+						try
+						{
+							this->_work();
+						}
+						catch (...)
+						{
+							__atomic_store_n(&this->_failed, true, __ATOMIC_RELAXED);
+						}
+
+						pthread_mutex_lock(&this->_mutex);
+						if (!--this->_active)
+							pthread_cond_signal(&this->_done);
+					}
+					pthread_mutex_unlock(&this->_mutex);
+				};
+
+				template <typename Body>
+				static void	_invoke(void * ctx, std::size_t begin, std::size_t end)
+				{
+					(*static_cast<Body *>(ctx))(begin, end);
+				};
+
+			public:
+				// threads - общее число исполнителей вместе с вызывающим потоком
+				explicit thread_pool(std::size_t threads = hardware_concurrency())
+					: _threads(NULL), _count(0), _generation(0), _stop(false),
+					_fn(NULL), _ctx(NULL), _n(0), _grain(1), _next(0), _active(0), _failed(false)
+				{
+					pthread_mutex_init(&this->_mutex, NULL);
+					pthread_mutex_init(&this->_run_mutex, NULL);
+					pthread_cond_init(&this->_wake, NULL);
+					pthread_cond_init(&this->_done, NULL);
+
+					if (threads < 2)
+						return ;
+
+					this->_threads = new pthread_t[threads - 1];
+					for (; this->_count < threads - 1; this->_count++)
+						if (pthread_create(this->_threads + this->_count, NULL, &_trampoline, this))
+							break ;
+				};
+
+				~thread_pool()
+				{
+					pthread_mutex_lock(&this->_mutex);
+					this->_stop = true;
+					pthread_cond_broadcast(&this->_wake);
+					pthread_mutex_unlock(&this->_mutex);
+
+					for (std::size_t i = 0; i < this->_count; i++)
+						pthread_join(this->_threads[i], NULL);
+					delete[] this->_threads;
+
+					pthread_cond_destroy(&this->_done);
+					pthread_cond_destroy(&this->_wake);
+					pthread_mutex_destroy(&this->_run_mutex);
+					pthread_mutex_destroy(&this->_mutex);
+				};
+
+				inline std::size_t	size(void)	const
+				{
+					return (this->_count + 1);
+				};
+
+				// Вызывает body(begin, end) для кусков [0, n) и ждет завершения всех.
+				// Исключение из вызывающего потока пробрасывается как есть, из потока
+				// пула - как runtime_error; в обоих случаях после ожидания всех
+				template <typename Body>
+				void	run(std::size_t n, std::size_t grain, Body & body)
+				{
+					if (!grain)
+						grain = 1;
+					if (!this->_count || n <= grain || _insideTask())
+					{
+						if (n)
+							body(0, n);
+						return ;
+					}
+
+					pthread_mutex_lock(&this->_run_mutex);
+					pthread_mutex_lock(&this->_mutex);
+					this->_fn = &_invoke<Body>;
+					this->_ctx = &body;
+					this->_n = n;
+					this->_grain = grain;
+					this->_next = 0;
+					this->_active = this->_count;
+					this->_generation++;
+					pthread_cond_broadcast(&this->_wake);
+					pthread_mutex_unlock(&this->_mutex);
+
+					try
+					{
+						this->_work();
+					}
+					catch (...)
+					{
+						this->_finish();
+						throw ;
+					}
+					if (this->_finish())
+						throw std::runtime_error("ft::parallel: task failed");
+				};
+		};
+
+		inline thread_pool &	default_pool(void)
+		{
+			static thread_pool	pool;
+
+			return (pool);
+		};
+
+		// Ниже этого числа элементов запуск потоков дороже самой работы
+		static const std::size_t	sequential_threshold = 32768;
+
+		// Кусков в несколько раз больше, чем потоков, чтобы выровнять неравномерную
+		// нагрузку, но не мельче min_grain элементов
+		inline std::size_t	_grain(std::size_t n, const thread_pool & pool, std::size_t min_grain = 4096)
+		{
+			if (n < sequential_threshold || pool.size() < 2)
+				return (n);
+
+			std::size_t	grain = n / (pool.size() * 8);
+
+			return (grain < min_grain ? min_grain : grain);
+		};
+
+		// Исключение из потока пула в C++98 не передать: куски выполняются под try,
+		// а после ожидания всех бросается bad_alloc или runtime_error
+		template <typename Body>
+		struct _guarded_body
+		{
+			Body &	body;
+			int		failure;
+
+			explicit _guarded_body(Body & body) : body(body), failure(0) {};
+
+			void	operator()(std::size_t begin, std::size_t end)
+			{
+				try
+				{
+					this->body(begin, end);
+				}
+				catch (std::bad_alloc &)
+				{
+					__atomic_fetch_or(&this->failure, 1, __ATOMIC_RELAXED);
+				}
+				catch (...)
+				{
+					__atomic_fetch_or(&this->failure, 2, __ATOMIC_RELAXED);
+				}
+			};
+		};
+
+		// pool.run для тел, которые могут бросать: остальные куски доделываются
+		template <typename Body>
+		void	run_guarded(thread_pool & pool, std::size_t n, std::size_t grain, Body & body)
+		{
+			_guarded_body<Body>	guarded(body);
+
+			pool.run(n, grain, guarded);
+			if (guarded.failure & 1)
+				throw std::bad_alloc();
+			if (guarded.failure)
+				throw std::runtime_error("ft::parallel: task failed");
+		};
+
+		template <typename RandomIt, typename Function>
+		struct _for_each_body
+		{
+			RandomIt	first;
+			Function	f;
+
+			_for_each_body(RandomIt first, Function f) : first(first), f(f) {};
+
+			void	operator()(std::size_t begin, std::size_t end)
+			{
+				Function	local = this->f;
+
+				for (RandomIt it = this->first + begin, last = this->first + end; it != last; ++it)
+					local(*it);
+			};
+		};
+
+		template <typename RandomIt, typename OutputIt, typename UnaryOp>
+		struct _transform_body
+		{
+			RandomIt	first;
+			OutputIt	out;
+			UnaryOp		op;
+
+			_transform_body(RandomIt first, OutputIt out, UnaryOp op) : first(first), out(out), op(op) {};
+
+			void	operator()(std::size_t begin, std::size_t end)
+			{
+				OutputIt	dst = this->out + begin;
+
+				for (RandomIt it = this->first + begin, last = this->first + end; it != last; ++it, ++dst)
+					*dst = this->op(*it);
+			};
+		};
+
+		template <typename RandomIt, typename T>
+		struct _fill_body
+		{
+			RandomIt	first;
+			const T &	val;
+
+			_fill_body(RandomIt first, const T & val) : first(first), val(val) {};
+
+			void	operator()(std::size_t begin, std::size_t end)
+			{
+				for (RandomIt it = this->first + begin, last = this->first + end; it != last; ++it)
+					*it = this->val;
+			};
+		};
+
+		template <typename RandomIt, typename OutputIt>
+		struct _copy_body
+		{
+			RandomIt	first;
+			OutputIt	out;
+
+			_copy_body(RandomIt first, OutputIt out) : first(first), out(out) {};
+
+			void	operator()(std::size_t begin, std::size_t end)
+			{
+				OutputIt	dst = this->out + begin;
+
+				for (RandomIt it = this->first + begin, last = this->first + end; it != last; ++it, ++dst)
+					*dst = *it;
+			};
+		};
+
+		// Каждый кусок сворачивается в свою ячейку, ячейки складываются по порядку:
+		// результат не зависит от числа потоков, если op ассоциативна
+		template <typename RandomIt, typename T, typename BinaryOp>
+		struct _reduce_body
+		{
+			RandomIt			first;
+			std::size_t			grain;
+			BinaryOp			op;
+			ft::vector<T> &		partial;
+
+			_reduce_body(RandomIt first, std::size_t grain, BinaryOp op, ft::vector<T> & partial)
+				: first(first), grain(grain), op(op), partial(partial) {};
+
+			// Последовательный run отдает весь диапазон одним вызовом, поэтому
+			// он режется здесь по grain: каждая ячейка partial пишется ровно раз
+			void	operator()(std::size_t begin, std::size_t end)
+			{
+				for (; begin < end; begin += this->grain)
+				{
+					RandomIt	it = this->first + begin;
+					RandomIt	last = this->first + std::min(begin + this->grain, end);
+					T			acc = *it;
+
+					while (++it != last)
+						acc = this->op(acc, *it);
+					this->partial[begin / this->grain] = acc;
+				}
+			};
+		};
+
+		template <typename RandomIt, typename Function>
+		Function	for_each(RandomIt first, RandomIt last, Function f, thread_pool & pool = default_pool())
+		{
+			std::size_t							n = last - first;
+			_for_each_body<RandomIt, Function>	body(first, f);
+
+			run_guarded(pool, n, _grain(n, pool), body);
+			return (f);
+		};
+
+		template <typename RandomIt, typename OutputIt, typename UnaryOp>
+		OutputIt	transform(RandomIt first, RandomIt last, OutputIt out, UnaryOp op, thread_pool & pool = default_pool())
+		{
+			std::size_t										n = last - first;
+			_transform_body<RandomIt, OutputIt, UnaryOp>	body(first, out, op);
+
+			run_guarded(pool, n, _grain(n, pool), body);
+			return (out + n);
+		};
+
+		template <typename RandomIt, typename T>
+		void	fill(RandomIt first, RandomIt last, const T & val, thread_pool & pool = default_pool())
+		{
+			std::size_t				n = last - first;
+			_fill_body<RandomIt, T>	body(first, val);
+
+			run_guarded(pool, n, _grain(n, pool), body);
+		};
+
+		template <typename RandomIt, typename OutputIt>
+		OutputIt	copy(RandomIt first, RandomIt last, OutputIt out, thread_pool & pool = default_pool())
+		{
+			std::size_t						n = last - first;
+			_copy_body<RandomIt, OutputIt>	body(first, out);
+
+			run_guarded(pool, n, _grain(n, pool), body);
+			return (out + n);
+		};
+
+		template <typename RandomIt, typename T, typename BinaryOp>
+		T	reduce(RandomIt first, RandomIt last, T init, BinaryOp op, thread_pool & pool = default_pool())
+		{
+			std::size_t	n = last - first;
+
+			if (!n)
+				return (init);
+
+			std::size_t								grain = _grain(n, pool);
+			// Ячейки только заполняют место: тело перезаписывает каждую, и init
+			// входит в свертку один раз, как бы run ни разбил диапазон
+			ft::vector<T>							partial((n + grain - 1) / grain, T(*first));
+			_reduce_body<RandomIt, T, BinaryOp>		body(first, grain, op, partial);
+
+			run_guarded(pool, n, grain, body);
+			for (std::size_t i = 0; i < partial.size(); i++)
+				init = op(init, partial[i]);
+			return (init);
+		};
+
+		// Соседи уже упорядочены, поэтому равенство - это !(prev < next)
+		template <typename T, typename Less>
+		struct _sorted_equal
+		{
+			Less	less;
+
+			explicit _sorted_equal(Less less) : less(less) {};
+
+			bool	operator()(const T & prev, const T & next)	const
+			{
+				return (!this->less(prev, next));
+			};
+		};
+
+		// Кусок i лежит с begin[i] и занимает length[i] элементов
+		template <typename T, typename Less>
+		struct _sort_unique_body
+		{
+			T *				data;
+			std::size_t *	begin;
+			std::size_t *	length;
+			Less			less;
+
+			_sort_unique_body(T * data, std::size_t * begin, std::size_t * length, Less less)
+				: data(data), begin(begin), length(length), less(less) {};
+
+			void	operator()(std::size_t first, std::size_t last)
+			{
+				for (std::size_t i = first; i < last; i++)
+				{
+					T *	chunk = this->data + this->begin[i];
+
+					ft::stable_sort(chunk, chunk + this->length[i], this->less);
+					this->length[i] = ft::unique(chunk, chunk + this->length[i], _sorted_equal<T, Less>(this->less)) - chunk;
+				}
+			};
+		};
+
+		// Пара кусков 2i и 2i + 1 сливается в dst с началом куска 2i. ft::merge
+		// берет сначала из левого, поэтому из равных остается более ранний
+		template <typename T, typename Less>
+		struct _merge_unique_body
+		{
+			const T *		src;
+			T *				dst;
+			std::size_t		chunks;
+			std::size_t *	begin;
+			std::size_t *	length;
+			Less			less;
+
+			_merge_unique_body(const T * src, T * dst, std::size_t chunks, std::size_t * begin, std::size_t * length, Less less)
+				: src(src), dst(dst), chunks(chunks), begin(begin), length(length), less(less) {};
+
+			void	operator()(std::size_t first, std::size_t last)
+			{
+				for (std::size_t i = first; i < last; i++)
+				{
+					std::size_t	l = 2 * i;
+					std::size_t	r = l + 1;
+					const T *	left = this->src + this->begin[l];
+					T *			out = this->dst + this->begin[l];
+					T *			end;
+
+					if (r < this->chunks)
+						end = ft::merge(left, left + this->length[l], this->src + this->begin[r],
+							this->src + this->begin[r] + this->length[r], out, this->less);
+					else
+						end = std::copy(left, left + this->length[l], out);
+					this->length[l] = ft::unique(out, end, _sorted_equal<T, Less>(this->less)) - out;
+				}
+			};
+		};
+
+		// Устойчивая сортировка с удалением повторов (из равных остается первый):
+		// куски сортируются параллельно, затем сливаются попарно раундами через
+		// буфер того же размера. Возвращает число оставшихся элементов в начале items
+		template <typename T, typename Less>
+		std::size_t	sort_unique(ft::vector<T> & items, Less less, thread_pool & pool = default_pool())
+		{
+			std::size_t	n = items.size();
+			std::size_t	chunks = (n < sequential_threshold) ? 1 : pool.size();
+
+			if (!n)
+				return (0);
+
+			ft::vector<std::size_t>	begin(chunks);
+			ft::vector<std::size_t>	length(chunks);
+
+			for (std::size_t i = 0; i < chunks; i++)
+			{
+				begin[i] = n / chunks * i + (i < n % chunks ? i : n % chunks);
+				length[i] = n / chunks + (i < n % chunks);
+			}
+
+			_sort_unique_body<T, Less>	sort(items.data(), begin.data(), length.data(), less);
+
+			run_guarded(pool, chunks, 1, sort);
+			if (chunks == 1)
+				return (length[0]);
+
+			// Копия, а не vector(n): T не обязан иметь конструктор по умолчанию
+			ft::vector<T>	buffer(items);
+
+			for (; chunks > 1; chunks = (chunks + 1) / 2)
+			{
+				_merge_unique_body<T, Less>	merge(items.data(), buffer.data(), chunks, begin.data(), length.data(), less);
+
+				run_guarded(pool, (chunks + 1) / 2, 1, merge);
+				for (std::size_t i = 0; 2 * i < chunks; i++)
+				{
+					begin[i] = begin[2 * i];
+					length[i] = length[2 * i];
+				}
+				items.swap(buffer);
+			}
+			return (length[0]);
+		};
+
+		template <typename T>
+		struct _plus
+		{
+			T	operator()(const T & lhd, const T & rhd)	const { return (lhd + rhd); };
+		};
+
+		template <typename RandomIt, typename T>
+		T	reduce(RandomIt first, RandomIt last, T init)
+		{
+			return (reduce(first, last, init, _plus<T>()));
+		};
+	};
+};
+
+#endif
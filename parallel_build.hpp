@@ -0,0 +1,188 @@
+#ifndef PARALLEL_BUILD_HPP
+# define PARALLEL_BUILD_HPP
+
+# include <cstddef>
+# include "pair.hpp"
+# include "vector.hpp"
+# include "parallel.hpp"
+# include "RBTree.hpp"
+# include "map.hpp"
+
+// Параллельная сборка RedBlackTree и map::build_parallel. Вынесены сюда,
+// чтобы пользователи map/set не тянули потоки: подключает тот, кто зовет
+// build_parallel
+namespace ft
+{
+	template <class Tree>
+	struct _tree_parallel_build
+	{
+		typedef typename	Tree::Node		Node;
+		typedef typename	Tree::size_type	size_type;
+
+		// Задача: поддерево из n значений с first, которое потом
+		// подвешивается в *slot под parent
+		template <class RandomIter>
+		struct task
+		{
+			RandomIter		first;
+			size_type		n;
+			std::size_t		depth;
+			Node *			parent;
+			Node **			slot;
+		};
+
+		// Куски задач разбирают потоки пула. Узлы пишутся только в свои поддеревья
+		// и в свои слоты верхушки, поэтому гонок нет
+		template <class RandomIter>
+		struct body
+		{
+			Tree *						tree;
+			const task<RandomIter> *	tasks;
+			std::size_t					full;
+
+			void	operator()(std::size_t first, std::size_t last)
+			{
+				for (std::size_t i = first; i < last; i++)
+					subtree(*this->tree, this->tasks[i], this->full);
+			};
+		};
+
+		template <class RandomIter>
+		static void	subtree(Tree & tree, const task<RandomIter> & current, std::size_t full)
+		{
+			typedef typename	Tree::value_type	value_type;
+
+			_iterator_source<RandomIter, value_type>	source(current.first);
+			const value_type *							prev = NULL;
+			Node *										node = tree._buildSorted(source, current.n, current.depth, full, prev);
+
+			*current.slot = node;
+			node->parent = current.parent;
+		};
+
+		// Верхние cut уровней строятся последовательно теми же делениями пополам,
+		// что и в _buildSorted; поддеревья на глубине cut откладываются в tasks
+		template <class RandomIter>
+		static void	spine(Tree & tree, RandomIter first, size_type n, std::size_t depth, std::size_t full, std::size_t cut,
+			Node * parent, Node ** slot, ft::vector<task<RandomIter> > & tasks)
+		{
+			if (!n)
+				return ;
+			if (depth == cut)
+			{
+				task<RandomIter>	pending = { first, n, depth, parent, slot };
+
+				tasks.push_back(pending);
+				return ;
+			}
+
+			size_type	left_size = (n - 1) / 2;
+			Node *		node = tree.allocator.allocate(1);
+
+			try
+			{
+				tree.allocator.construct(node, Node(first[left_size], parent, depth == full));
+			}
+			catch (...)
+			{
+				tree.allocator.deallocate(node, 1);
+				throw;
+			}
+			*slot = node;
+			spine(tree, first, left_size, depth + 1, full, cut, node, &node->left, tasks);
+			spine(tree, first + left_size + 1, n - 1 - left_size, depth + 1, full, cut, node, &node->right, tasks);
+		};
+
+		// Дополнение верхушки считается после того, как подвешены поддеревья
+		template <class Augment>
+		static void	augment_spine(Node * node, std::size_t depth, std::size_t cut)
+		{
+			if (!node || depth >= cut)
+				return ;
+			augment_spine<Augment>(node->left, depth + 1, cut);
+			augment_spine<Augment>(node->right, depth + 1, cut);
+			Augment::update(node);
+		};
+
+		// Как Tree::build_sorted по массиву с произвольным доступом, но на пуле:
+		// верхушка строится сразу, ниже нее около 4 * pool.size() равных поддеревьев
+		// собираются параллельно. Форма и окраска совпадают с build_sorted. Порядок
+		// проверяется только внутри поддеревьев; аллокатор должен быть потокобезопасным
+		template <class RandomIter>
+		static void	build(Tree & tree, RandomIter first, size_type n, ft::parallel::thread_pool & pool)
+		{
+			typedef typename	Tree::augment_type	Augment;
+
+			if (pool.size() < 2 || n < ft::parallel::sequential_threshold)
+			{
+				_iterator_source<RandomIter, typename Tree::value_type>	source(first);
+
+				tree.build_sorted(source, n);
+				return ;
+			}
+
+			std::size_t	full = 0;
+			std::size_t	cut = 0;
+
+			tree.clear();
+			while ((std::size_t(2) << full) - 1 <= n)
+				full++;
+			while ((std::size_t(1) << cut) < 4 * pool.size())
+				cut++;
+
+			ft::vector<task<RandomIter> >	tasks;
+
+			try
+			{
+				spine(tree, first, n, 0, full, cut, NULL, &tree.root, tasks);
+
+				body<RandomIter>	subtrees = { &tree, tasks.data(), full };
+
+				ft::parallel::run_guarded(pool, tasks.size(), 1, subtrees);
+			}
+			catch (...)
+			{
+				tree._destroy(tree.root);
+				tree.root = NULL;
+				throw;
+			}
+			if (Augment::enabled)
+				augment_spine<Augment>(tree.root, 0, cut);
+			tree.size = n;
+		};
+	};
+
+	template <class Map>
+	struct _map_parallel_build
+	{
+		// Изменяемая копия значения для сортировки: ключ в value_type константный
+		typedef				ft::pair<typename Map::key_type, typename Map::mapped_type>	item;
+		typedef typename	Map::Tree													Tree;
+
+		struct item_less
+		{
+			typename Map::key_compare	comp;
+
+			explicit item_less(const typename Map::key_compare & comp) : comp(comp) {};
+
+			bool	operator()(const item & lhd, const item & rhd)	const
+			{
+				return (this->comp(lhd.first, rhd.first));
+			};
+		};
+
+		template <class InputIter>
+		static void	build(Map & map, InputIter first, InputIter last, std::size_t threads)
+		{
+			ft::parallel::thread_pool	pool(threads ? threads : ft::parallel::hardware_concurrency());
+			ft::vector<item>			items(first, last);
+			std::size_t					n = ft::parallel::sort_unique(items, item_less(map._comparator), pool);
+			Tree						tmp(map._tree.allocator, map._tree.comparator);
+
+			_tree_parallel_build<Tree>::build(tmp, items.data(), n, pool);
+			map._tree.swap(tmp);
+		};
+	};
+};
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef PERF_HPP
+# define PERF_HPP
+
+# include <cstring>
+# include <ctime>
+# include <stdint.h>
+# include <unistd.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <linux/perf_event.h>
+
+namespace ft
+{
+	namespace perf
+	{
+		enum counter
+		{
+			CYCLES,
+			INSTRUCTIONS,
+			L1D_MISSES,
+			LLC_MISSES,
+			BRANCH_MISSES,
+			DTLB_MISSES,
+			COUNTER_COUNT
+		};
+
+		inline const char *	counter_name(counter c)
+		{
+			static const char *	names[COUNTER_COUNT] = {
+				"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"
+			};
+
+			return (names[c]);
+		};
+
+		// Результат замера: время есть всегда, счетчик - только если ядро его открыло.
+		// При мультиплексировании значения масштабируются на долю времени, когда счетчик работал
+		struct sample
+		{
+			uint64_t	wall_ns;
+			bool		available[COUNTER_COUNT];
+			uint64_t	values[COUNTER_COUNT];
+
+			sample(void) : wall_ns(0)
+			{
+				std::memset(this->available, 0, sizeof(this->available));
+				std::memset(this->values, 0, sizeof(this->values));
+			};
+		};
+
+		inline uint64_t	now_ns(void)
+		{
+			struct timespec	ts;
+
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec);
+		};
+
+		// Набор аппаратных счетчиков текущего потока (только user space).
+		// Каждый открывается отдельно: без прав (perf_event_paranoid, контейнер)
+		// или без поддержки в PMU недоступные просто пропускаются
+		class counters
+		{
+			private:
+				int			_fds[COUNTER_COUNT];
+				uint64_t	_start;
+
+				counters(const counters &);
+				counters &	operator=(const counters &);
+
+				static uint64_t	_cacheMiss(uint64_t cache)
+				{
+					return (cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+				};
+
+				static int	_open(uint32_t type, uint64_t config)
+				{
+					struct perf_event_attr	attr;
+
+					std::memset(&attr, 0, sizeof(attr));
+					attr.size = sizeof(attr);
+					attr.type = type;
+					attr.config = config;
+					attr.disabled = 1;
+					attr.exclude_kernel = 1;
+					attr.exclude_hv = 1;
+					attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+					return (static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0)));
+				};
+
+			public:
+				counters(void) : _start(0)
+				{
+					this->_fds[CYCLES] = _open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+					this->_fds[INSTRUCTIONS] = _open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+					this->_fds[L1D_MISSES] = _open(PERF_TYPE_HW_CACHE, _cacheMiss(PERF_COUNT_HW_CACHE_L1D));
+					this->_fds[LLC_MISSES] = _open(PERF_TYPE_HW_CACHE, _cacheMiss(PERF_COUNT_HW_CACHE_LL));
+					this->_fds[BRANCH_MISSES] = _open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+					this->_fds[DTLB_MISSES] = _open(PERF_TYPE_HW_CACHE, _cacheMiss(PERF_COUNT_HW_CACHE_DTLB));
+				};
+
+				~counters()
+				{
+					for (int i = 0; i < COUNTER_COUNT; i++)
+						if (this->_fds[i] != -1)
+							close(this->_fds[i]);
+				};
+
+				bool	available(counter c)	const
+				{
+					return (this->_fds[c] != -1);
+				};
+
+				// Хотя бы один аппаратный счетчик открылся
+				bool	hardware(void)	const
+				{
+					for (int i = 0; i < COUNTER_COUNT; i++)
+						if (this->_fds[i] != -1)
+							return (true);
+					return (false);
+				};
+
+				void	start(void)
+				{
+					for (int i = 0; i < COUNTER_COUNT; i++)
+						if (this->_fds[i] != -1)
+						{
+							ioctl(this->_fds[i], PERF_EVENT_IOC_RESET, 0);
+							ioctl(this->_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+						}
+					this->_start = now_ns();
+				};
+
+				sample	stop(void)
+				{
+					sample	result;
+
+					result.wall_ns = now_ns() - this->_start;
+					for (int i = 0; i < COUNTER_COUNT; i++)
+					{
+						uint64_t	data[3];
+
+						if (this->_fds[i] == -1)
+							continue ;
+						ioctl(this->_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+						if (read(this->_fds[i], data, sizeof(data)) != sizeof(data) || !data[2])
+							continue ;
+
+						result.available[i] = true;
+						result.values[i] = data[2] == data[1] ? data[0]
+							: static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+					}
+					return (result);
+				};
+		};
+
+		// Замер области видимости: { ft::perf::scope s(counters, out); ... }
+		class scope
+		{
+			private:
+				counters &	_counters;
+				sample &	_out;
+
+				scope(const scope &);
+				scope &	operator=(const scope &);
+
+			public:
+				scope(counters & c, sample & out) : _counters(c), _out(out)
+				{
+					this->_counters.start();
+				};
+
+				~scope()
+				{
+					this->_out = this->_counters.stop();
+				};
+		};
+	};
+};
+
+#endif
@@ -0,0 +1,461 @@
+#ifndef SET_HPP
+# define SET_HPP
+
+# include <functional>
+# include <memory>
+# include "algorithm.hpp"
+# include "reverse_iterator.hpp"
+# include "pair.hpp"
+# include "iterator_traits.hpp"
+# include "RBTree.hpp"
+# include "memory_usage.hpp"
+
+namespace ft
+{
+	// Общая часть set и multiset: узел хранит только ключ, поиск идет по самому
+	// ключу без сборки value_type. Элементы не изменяемы, поэтому iterator константный
+	template <typename Key, class Compare, class Alloc>
+	class _tree_set
+	{
+		// Тесты (tests/test.hpp) проверяют инварианты дерева
+		friend struct _test_access;
+
+		public:
+			typedef				Key															key_type;
+			typedef				Key															value_type;
+			typedef				Compare														key_compare;
+			typedef				Compare														value_compare;
+			typedef				Alloc														allocator_type;
+			typedef	typename	allocator_type::reference									reference;
+			typedef	typename	allocator_type::const_reference								const_reference;
+			typedef	typename	allocator_type::pointer										pointer;
+			typedef	typename	allocator_type::const_pointer								const_pointer;
+			typedef typename	allocator_type::size_type									size_type;
+
+		protected:
+			typedef				RedBlackTree<value_type, key_compare, allocator_type>		Tree;
+
+		public:
+			typedef typename	Tree::const_iterator										iterator;
+			typedef typename	Tree::const_iterator										const_iterator;
+			typedef typename	Tree::const_reverse_iterator								reverse_iterator;
+			typedef typename	Tree::const_reverse_iterator								const_reverse_iterator;
+			typedef typename	ft::iterator_traits<iterator>::difference_type				difference_type;
+
+		protected:
+			Tree	_tree;
+
+			explicit _tree_set(const key_compare & comp, const allocator_type & alloc)
+				: _tree(Tree(alloc, comp))
+			{};
+
+			_tree_set(const _tree_set & src)
+				: _tree(src._tree)
+			{};
+
+			~_tree_set() {};
+
+			_tree_set &	operator=(const _tree_set & rhd)
+			{
+				this->_tree = rhd._tree;
+
+				return (*this);
+			};
+
+			iterator	_wrap(typename Tree::Node * node)	const
+			{
+				return (iterator(node, this->_tree.root));
+			};
+
+		public:
+			iterator	begin(void)	const
+			{
+				return (this->_tree.cbegin());
+			};
+
+			iterator	end(void)	const
+			{
+				return (this->_tree.cend());
+			};
+
+			reverse_iterator	rbegin(void)	const
+			{
+				return (this->_tree.crbegin());
+			};
+
+			reverse_iterator	rend(void)	const
+			{
+				return (this->_tree.crend());
+			};
+
+			bool	empty(void)	const
+			{
+				return (!this->_tree.size);
+			};
+
+			size_type	size(void)	const
+			{
+				return (this->_tree.size);
+			};
+
+			size_type	max_size(void)	const
+			{
+				return (this->_tree.allocator.max_size());
+			};
+
+			void	erase(iterator position)
+			{
+				this->_tree.erase(position.current);
+			};
+
+			void	erase(iterator first, iterator last)
+			{
+				while (first != last)
+				{
+					iterator	victim = first;
+
+					++first;
+					this->erase(victim);
+				}
+			};
+
+			void	clear(void)
+			{
+				this->_tree.clear();
+			};
+
+			key_compare	key_comp(void)	const
+			{
+				return (this->_tree.comparator);
+			};
+
+			value_compare	value_comp(void)	const
+			{
+				return (this->_tree.comparator);
+			};
+
+			iterator	lower_bound(const key_type & key)	const
+			{
+				return (this->_tree.lower_bound(key));
+			};
+
+			iterator	upper_bound(const key_type & key)	const
+			{
+				return (this->_tree.upper_bound(key));
+			};
+
+			allocator_type	get_allocator(void)	const
+			{
+				return (this->_tree.allocator);
+			};
+
+			tree_stats	stats(void)	const
+			{
+				return (this->_tree.stats());
+			};
+
+			void	reset_stats(void)
+			{
+				this->_tree.reset_stats();
+			};
+
+			memory_usage_info	memory_usage(void)	const
+			{
+				memory_usage_info	info;
+
+				info.payload_bytes = this->_tree.size * sizeof(value_type);
+				info.overhead_bytes = sizeof(*this)
+					+ this->_tree.size * (sizeof(typename Tree::Node) - sizeof(value_type));
+				return (info);
+			};
+	};
+
+	template <typename Key, class Compare = std::less<Key>, class Alloc = std::allocator<Key> >
+	class set : public _tree_set<Key, Compare, Alloc>
+	{
+		private:
+			typedef				_tree_set<Key, Compare, Alloc>		Base;
+
+		public:
+			typedef typename	Base::key_type						key_type;
+			typedef typename	Base::value_type					value_type;
+			typedef typename	Base::key_compare					key_compare;
+			typedef typename	Base::allocator_type				allocator_type;
+			typedef typename	Base::size_type						size_type;
+			typedef typename	Base::iterator						iterator;
+			typedef typename	Base::const_iterator				const_iterator;
+
+			explicit set(const key_compare & comp = key_compare(), const allocator_type & alloc = allocator_type())
+				: Base(comp, alloc)
+			{};
+
+			template <typename InputIter>
+			set(InputIter first, InputIter last, const key_compare & comp = key_compare(), const allocator_type & alloc = allocator_type())
+				: Base(comp, alloc)
+			{
+				this->insert(first, last);
+			};
+
+			set(const set & src)
+				: Base(src)
+			{};
+
+			~set() {};
+
+			set &	operator=(const set & rhd)
+			{
+				Base::operator=(rhd);
+
+				return (*this);
+			};
+
+			ft::pair<iterator, bool>	insert(const value_type & val)
+			{
+				ft::pair<typename Base::Tree::iterator, bool>	inserted = this->_tree.insert(val);
+
+				return (ft::make_pair(this->_wrap(inserted.first.current), inserted.second));
+			};
+
+			iterator	insert(iterator position, const value_type & val)
+			{
+				return (this->_wrap(this->_tree.insert(val, position.current).first.current));
+			};
+
+			template <typename InputIter>
+			void	insert(InputIter first, InputIter last)
+			{
+				for (; first != last; ++first)
+					this->_tree.insert(*first);
+			};
+
+			using	Base::erase;
+
+			size_type	erase(const key_type & key)
+			{
+				return (this->_tree.erase(key));
+			};
+
+			void	swap(set & ref)
+			{
+				this->_tree.swap(ref._tree);
+			};
+
+			iterator	find(const key_type & key)	const
+			{
+				return (this->_tree.find(key));
+			};
+
+			size_type	count(const key_type & key)	const
+			{
+				return (this->_tree.count(key));
+			};
+
+			ft::pair<iterator, iterator>	equal_range(const key_type & key)	const
+			{
+				iterator	first = this->find(key);
+
+				if (first == this->end())
+					return (ft::make_pair(first, first));
+
+				iterator	last = first;
+
+				return (ft::make_pair(first, ++last));
+			};
+	};
+
+	// Равные ключи хранятся в порядке вставки
+	template <typename Key, class Compare = std::less<Key>, class Alloc = std::allocator<Key> >
+	class multiset : public _tree_set<Key, Compare, Alloc>
+	{
+		private:
+			typedef				_tree_set<Key, Compare, Alloc>		Base;
+
+		public:
+			typedef typename	Base::key_type						key_type;
+			typedef typename	Base::value_type					value_type;
+			typedef typename	Base::key_compare					key_compare;
+			typedef typename	Base::allocator_type				allocator_type;
+			typedef typename	Base::size_type						size_type;
+			typedef typename	Base::iterator						iterator;
+			typedef typename	Base::const_iterator				const_iterator;
+
+			explicit multiset(const key_compare & comp = key_compare(), const allocator_type & alloc = allocator_type())
+				: Base(comp, alloc)
+			{};
+
+			template <typename InputIter>
+			multiset(InputIter first, InputIter last, const key_compare & comp = key_compare(), const allocator_type & alloc = allocator_type())
+				: Base(comp, alloc)
+			{
+				this->insert(first, last);
+			};
+
+			multiset(const multiset & src)
+				: Base(src)
+			{};
+
+			~multiset() {};
+
+			multiset &	operator=(const multiset & rhd)
+			{
+				Base::operator=(rhd);
+
+				return (*this);
+			};
+
+			iterator	insert(const value_type & val)
+			{
+				return (this->_wrap(this->_tree.insert_multi(val).current));
+			};
+
+			iterator	insert(iterator, const value_type & val)
+			{
+				return (this->insert(val));
+			};
+
+			template <typename InputIter>
+			void	insert(InputIter first, InputIter last)
+			{
+				for (; first != last; ++first)
+					this->_tree.insert_multi(*first);
+			};
+
+			using	Base::erase;
+
+			size_type	erase(const key_type & key)
+			{
+				ft::pair<iterator, iterator>	range = this->equal_range(key);
+				size_type						erased = 0;
+
+				for (; range.first != range.second; erased++)
+				{
+					iterator	victim = range.first;
+
+					++range.first;
+					this->erase(victim);
+				}
+				return (erased);
+			};
+
+			void	swap(multiset & ref)
+			{
+				this->_tree.swap(ref._tree);
+			};
+
+			// Первый из равных ключей
+			iterator	find(const key_type & key)	const
+			{
+				iterator	found = this->lower_bound(key);
+
+				if (found == this->end() || this->_tree.comparator(key, *found))
+					return (this->end());
+				return (found);
+			};
+
+			size_type	count(const key_type & key)	const
+			{
+				ft::pair<iterator, iterator>	range = this->equal_range(key);
+				size_type						n = 0;
+
+				for (; range.first != range.second; ++range.first)
+					n++;
+				return (n);
+			};
+
+			ft::pair<iterator, iterator>	equal_range(const key_type & key)	const
+			{
+				return (ft::make_pair(this->lower_bound(key), this->upper_bound(key)));
+			};
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline void	swap(set<Key, Compare, Alloc> & lhd, set<Key, Compare, Alloc> & rhd)
+	{
+		lhd.swap(rhd);
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline void	swap(multiset<Key, Compare, Alloc> & lhd, multiset<Key, Compare, Alloc> & rhd)
+	{
+		lhd.swap(rhd);
+	};
+
+	// Сравнение по элементам в порядке обхода, как у std::set
+	template <typename Key, class Compare, class Alloc>
+	bool	operator==(const set<Key, Compare, Alloc> & lhd, const set<Key, Compare, Alloc> & rhd)
+	{
+		if (lhd.size() != rhd.size())
+			return (false);
+		return (ft::equal(lhd.begin(), lhd.end(), rhd.begin()));
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator!=(const set<Key, Compare, Alloc> & lhd, const set<Key, Compare, Alloc> & rhd)
+	{
+		return (!(lhd == rhd));
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator<(const set<Key, Compare, Alloc> & lhd, const set<Key, Compare, Alloc> & rhd)
+	{
+		return (ft::lexicographical_compare(lhd.begin(), lhd.end(), rhd.begin(), rhd.end()));
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator>(const set<Key, Compare, Alloc> & lhd, const set<Key, Compare, Alloc> & rhd)
+	{
+		return (rhd < lhd);
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator<=(const set<Key, Compare, Alloc> & lhd, const set<Key, Compare, Alloc> & rhd)
+	{
+		return (!(rhd < lhd));
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator>=(const set<Key, Compare, Alloc> & lhd, const set<Key, Compare, Alloc> & rhd)
+	{
+		return (!(lhd < rhd));
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	bool	operator==(const multiset<Key, Compare, Alloc> & lhd, const multiset<Key, Compare, Alloc> & rhd)
+	{
+		if (lhd.size() != rhd.size())
+			return (false);
+		return (ft::equal(lhd.begin(), lhd.end(), rhd.begin()));
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator!=(const multiset<Key, Compare, Alloc> & lhd, const multiset<Key, Compare, Alloc> & rhd)
+	{
+		return (!(lhd == rhd));
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator<(const multiset<Key, Compare, Alloc> & lhd, const multiset<Key, Compare, Alloc> & rhd)
+	{
+		return (ft::lexicographical_compare(lhd.begin(), lhd.end(), rhd.begin(), rhd.end()));
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator>(const multiset<Key, Compare, Alloc> & lhd, const multiset<Key, Compare, Alloc> & rhd)
+	{
+		return (rhd < lhd);
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator<=(const multiset<Key, Compare, Alloc> & lhd, const multiset<Key, Compare, Alloc> & rhd)
+	{
+		return (!(rhd < lhd));
+	};
+
+	template <typename Key, class Compare, class Alloc>
+	inline bool	operator>=(const multiset<Key, Compare, Alloc> & lhd, const multiset<Key, Compare, Alloc> & rhd)
+	{
+		return (!(lhd < rhd));
+	};
+};
+
+#endif
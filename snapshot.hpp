@@ -0,0 +1,470 @@
+#ifndef SNAPSHOT_HPP
+# define SNAPSHOT_HPP
+
+# include <cstring>
+# include <istream>
+# include <ostream>
+# include <stdexcept>
+# include <string>
+# include <stdint.h>
+# include "type_traits.hpp"
+# include "pair.hpp"
+
+namespace ft
+{
+	// Формат снимка (версия 1, порядок байт машины):
+	//   заголовок  magic "FTSNAPSH", version, byte_order, kind, key_size, value_size,
+	//              reserved, count (uint64) и контрольная сумма этих полей
+	//   чанки      uint32 длина, данные, uint64 контрольная сумма данных
+	//   конец      чанк нулевой длины
+	// Записи не выровнены по чанкам - чанк это просто кусок потока байт
+	class snapshot_error : public std::runtime_error
+	{
+		public:
+			explicit snapshot_error(const std::string & what)
+				: std::runtime_error("snapshot: " + what)
+			{};
+	};
+
+	struct snapshot_header
+	{
+		enum kind_type
+		{
+			vector_kind = 1,
+			map_kind = 2
+		};
+
+		static const uint32_t		version = 1;
+		static const uint32_t		byte_order = 0x01020304;
+		static const std::size_t	bytes = 48;
+	};
+
+	inline uint64_t	snapshot_checksum(const void * data, std::size_t n)
+	{
+		const unsigned char *	p = static_cast<const unsigned char *>(data);
+		uint64_t				h = 0xcbf29ce484222325ull ^ n;
+
+		for (; n >= 8; n -= 8, p += 8)
+		{
+			uint64_t	word;
+
+			std::memcpy(&word, p, 8);
+			h = (h ^ word) * 0x100000001b3ull;
+			h = (h << 31) | (h >> 33);
+		}
+		for (; n; n--, p++)
+			h = (h ^ *p) * 0x100000001b3ull;
+
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		return (h);
+	};
+
+	// Буферизует запись и режет ее на чанки; крупные куски (вектор тривиальных
+	// значений) идут в поток прямо из памяти контейнера, без копирования в буфер
+	class snapshot_writer
+	{
+		public:
+			static const std::size_t	chunk_size = 1 << 20;
+
+		private:
+			std::ostream &	_out;
+			char *			_buffer;
+			std::size_t		_used;
+
+			snapshot_writer(const snapshot_writer &);
+			snapshot_writer &	operator=(const snapshot_writer &);
+
+			void	_put(const void * data, std::size_t n)
+			{
+				this->_out.write(static_cast<const char *>(data), n);
+				if (!this->_out)
+					throw snapshot_error("write failed");
+			};
+
+			void	_emit(const char * data, std::size_t n)
+			{
+				uint32_t	size = static_cast<uint32_t>(n);
+				uint64_t	checksum = snapshot_checksum(data, n);
+
+				this->_put(&size, sizeof(size));
+				this->_put(data, n);
+				this->_put(&checksum, sizeof(checksum));
+			};
+
+			void	_flush(void)
+			{
+				if (!this->_used)
+					return ;
+				this->_emit(this->_buffer, this->_used);
+				this->_used = 0;
+			};
+
+			void	_writeSlow(const char * src, std::size_t n)
+			{
+				std::size_t	room = chunk_size - this->_used;
+
+				std::memcpy(this->_buffer + this->_used, src, room);
+				this->_used = chunk_size;
+				src += room;
+				n -= room;
+				this->_flush();
+
+				for (; n >= chunk_size; src += chunk_size, n -= chunk_size)
+					this->_emit(src, chunk_size);
+
+				std::memcpy(this->_buffer, src, n);
+				this->_used = n;
+			};
+
+		public:
+			snapshot_writer(std::ostream & out, snapshot_header::kind_type kind,
+				std::size_t key_size, std::size_t value_size, uint64_t count)
+				: _out(out), _buffer(new char[chunk_size]), _used(0)
+			{
+				char		header[snapshot_header::bytes];
+				uint32_t	fields[6] = {
+					snapshot_header::version, snapshot_header::byte_order, static_cast<uint32_t>(kind),
+					static_cast<uint32_t>(key_size), static_cast<uint32_t>(value_size), 0
+				};
+
+				std::memcpy(header, "FTSNAPSH", 8);
+				std::memcpy(header + 8, fields, sizeof(fields));
+				std::memcpy(header + 32, &count, sizeof(count));
+
+				uint64_t	checksum = snapshot_checksum(header, 40);
+
+				std::memcpy(header + 40, &checksum, sizeof(checksum));
+				try
+				{
+					this->_put(header, sizeof(header));
+				}
+				catch (...)
+				{
+					delete [] this->_buffer;
+					throw;
+				}
+			};
+
+			// Без finish() в потоке не будет конечного чанка, и load отвергнет снимок
+			~snapshot_writer()
+			{
+				delete [] this->_buffer;
+			};
+
+			void	write(const void * data, std::size_t n)
+			{
+				if (n <= chunk_size - this->_used)
+				{
+					std::memcpy(this->_buffer + this->_used, data, n);
+					this->_used += n;
+					return ;
+				}
+				this->_writeSlow(static_cast<const char *>(data), n);
+			};
+
+			void	finish(void)
+			{
+				uint32_t	end = 0;
+
+				this->_flush();
+				this->_put(&end, sizeof(end));
+				this->_out.flush();
+				if (!this->_out)
+					throw snapshot_error("write failed");
+			};
+	};
+
+	class snapshot_reader
+	{
+		public:
+			static const std::size_t	max_chunk_size = 64 << 20;
+
+		private:
+			std::istream &	_in;
+			char *			_buffer;
+			std::size_t		_capacity;
+			char *			_pos;
+			char *			_end;
+			uint64_t		_count;
+
+			snapshot_reader(const snapshot_reader &);
+			snapshot_reader &	operator=(const snapshot_reader &);
+
+			void	_get(void * data, std::size_t n)
+			{
+				this->_in.read(static_cast<char *>(data), n);
+				if (static_cast<std::size_t>(this->_in.gcount()) != n)
+					throw snapshot_error("unexpected end of stream");
+			};
+
+			std::size_t	_chunkSize(void)
+			{
+				uint32_t	size;
+
+				this->_get(&size, sizeof(size));
+				if (size > max_chunk_size)
+					throw snapshot_error("corrupted chunk header");
+				return (size);
+			};
+
+			void	_payload(char * dst, std::size_t n)
+			{
+				uint64_t	checksum;
+
+				this->_get(dst, n);
+				this->_get(&checksum, sizeof(checksum));
+				if (checksum != snapshot_checksum(dst, n))
+					throw snapshot_error("checksum mismatch");
+			};
+
+			void	_readSlow(char * dst, std::size_t n)
+			{
+				while (n)
+				{
+					if (this->_pos == this->_end)
+					{
+						std::size_t	size = this->_chunkSize();
+
+						if (!size)
+							throw snapshot_error("fewer records than declared");
+						// Чанк целиком помещается в приемник - читаем прямо туда
+						if (size <= n)
+						{
+							this->_payload(dst, size);
+							dst += size;
+							n -= size;
+							continue ;
+						}
+						if (size > this->_capacity)
+						{
+							delete [] this->_buffer;
+							this->_buffer = NULL;
+							this->_buffer = new char[size];
+							this->_capacity = size;
+						}
+						this->_payload(this->_buffer, size);
+						this->_pos = this->_buffer;
+						this->_end = this->_buffer + size;
+					}
+
+					std::size_t	take = static_cast<std::size_t>(this->_end - this->_pos);
+
+					if (take > n)
+						take = n;
+					std::memcpy(dst, this->_pos, take);
+					this->_pos += take;
+					dst += take;
+					n -= take;
+				}
+			};
+
+		public:
+			snapshot_reader(std::istream & in, snapshot_header::kind_type kind,
+				std::size_t key_size, std::size_t value_size)
+				: _in(in), _buffer(NULL), _capacity(0), _pos(NULL), _end(NULL), _count(0)
+			{
+				char		header[snapshot_header::bytes];
+				uint32_t	fields[6];
+				uint64_t	checksum;
+
+				this->_get(header, sizeof(header));
+				std::memcpy(fields, header + 8, sizeof(fields));
+				std::memcpy(&this->_count, header + 32, sizeof(this->_count));
+				std::memcpy(&checksum, header + 40, sizeof(checksum));
+
+				if (std::memcmp(header, "FTSNAPSH", 8))
+					throw snapshot_error("not a snapshot");
+				if (checksum != snapshot_checksum(header, 40))
+					throw snapshot_error("header checksum mismatch");
+				if (fields[0] > snapshot_header::version)
+					throw snapshot_error("unsupported version");
+				if (fields[1] != snapshot_header::byte_order)
+					throw snapshot_error("byte order mismatch");
+				if (fields[2] != static_cast<uint32_t>(kind))
+					throw snapshot_error("container kind mismatch");
+				if (fields[3] != key_size || fields[4] != value_size)
+					throw snapshot_error("element size mismatch");
+			};
+
+			~snapshot_reader()
+			{
+				delete [] this->_buffer;
+			};
+
+			uint64_t	count(void)	const
+			{
+				return (this->_count);
+			};
+
+			void	read(void * data, std::size_t n)
+			{
+				if (n <= static_cast<std::size_t>(this->_end - this->_pos))
+				{
+					std::memcpy(data, this->_pos, n);
+					this->_pos += n;
+					return ;
+				}
+				this->_readSlow(static_cast<char *>(data), n);
+			};
+
+			// Все данные прочитаны и дальше стоит конечный чанк
+			void	finish(void)
+			{
+				if (this->_pos != this->_end || this->_chunkSize())
+					throw snapshot_error("more records than declared");
+			};
+	};
+
+	// Точка расширения: для своего типа специализируйте
+	//   static void	write(snapshot_writer &, const T &);
+	//   static T		read(snapshot_reader &);
+	// Тривиально копируемые типы и пары из них пишутся как есть
+	template <typename T, typename Enable = void>
+	struct serializer;
+
+	template <typename T>
+	struct serializer<T, typename ft::enable_if<ft::is_trivially_copyable<T>::value>::type>
+	{
+		static void	write(snapshot_writer & out, const T & value)
+		{
+			out.write(&value, sizeof(T));
+		};
+
+		static T	read(snapshot_reader & in)
+		{
+			typename _remove_cv<T>::type	value;
+
+			in.read(&value, sizeof(T));
+			return (value);
+		};
+	};
+
+	template <typename T1, typename T2>
+	struct serializer<ft::pair<T1, T2> >
+	{
+		typedef	serializer<typename _remove_cv<T1>::type>	first_serializer;
+		typedef	serializer<typename _remove_cv<T2>::type>	second_serializer;
+
+		static void	write(snapshot_writer & out, const ft::pair<T1, T2> & value)
+		{
+			first_serializer::write(out, value.first);
+			second_serializer::write(out, value.second);
+		};
+
+		static ft::pair<T1, T2>	read(snapshot_reader & in)
+		{
+			typename _remove_cv<T1>::type	first = first_serializer::read(in);
+
+			return (ft::pair<T1, T2>(first, second_serializer::read(in)));
+		};
+	};
+
+	// vector::save/load (объявлены в vector.hpp). Тривиальные значения пишутся
+	// одним куском прямо из памяти вектора и так же читаются обратно
+	template <class Vector>
+	void	_save_vector_values(snapshot_writer & out, const Vector & vec, ft::true_type)
+	{
+		out.write(vec.data(), vec.size() * sizeof(typename Vector::value_type));
+	};
+
+	template <class Vector>
+	void	_save_vector_values(snapshot_writer & out, const Vector & vec, ft::false_type)
+	{
+		for (typename Vector::size_type i = 0; i < vec.size(); i++)
+			serializer<typename Vector::value_type>::write(out, vec[i]);
+	};
+
+	template <class Vector>
+	void	_load_vector_values(snapshot_reader & in, Vector & vec, typename Vector::size_type n, ft::true_type)
+	{
+		vec.resize_default_init(n);
+		in.read(vec.data(), n * sizeof(typename Vector::value_type));
+	};
+
+	template <class Vector>
+	void	_load_vector_values(snapshot_reader & in, Vector & vec, typename Vector::size_type n, ft::false_type)
+	{
+		vec.reserve(n);
+		while (n--)
+			vec.push_back(serializer<typename Vector::value_type>::read(in));
+	};
+
+	template <class Vector>
+	void	_save_vector(const Vector & vec, std::ostream & out)
+	{
+		typedef typename	Vector::value_type	value_type;
+
+		snapshot_writer	writer(out, snapshot_header::vector_kind, 0, sizeof(value_type), vec.size());
+
+		_save_vector_values(writer, vec, ft::is_trivially_copyable<value_type>());
+		writer.finish();
+	};
+
+	template <class Vector>
+	void	_load_vector(Vector & vec, std::istream & in)
+	{
+		typedef typename	Vector::value_type	value_type;
+
+		snapshot_reader	reader(in, snapshot_header::vector_kind, 0, sizeof(value_type));
+		Vector			tmp(vec.get_allocator());
+
+		_load_vector_values(reader, tmp, reader.count(), ft::is_trivially_copyable<value_type>());
+		reader.finish();
+		vec.swap(tmp);
+	};
+
+	// Источник значений для RedBlackTree::build_sorted
+	template <typename T>
+	class _snapshot_source
+	{
+		private:
+			snapshot_reader &	_in;
+
+		public:
+			explicit _snapshot_source(snapshot_reader & in) : _in(in) {};
+
+			T	operator()(void)
+			{
+				return (serializer<T>::read(this->_in));
+			};
+	};
+
+	// map::save/load (объявлены в map.hpp)
+	template <class Map>
+	void	_save_map(const Map & map, std::ostream & out)
+	{
+		snapshot_writer	writer(out, snapshot_header::map_kind, sizeof(typename Map::key_type),
+			sizeof(typename Map::mapped_type), map.size());
+
+		typename Map::const_iterator	last = map.end();
+
+		for (typename Map::const_iterator it = map.begin(); it != last; ++it)
+			serializer<typename Map::value_type>::write(writer, *it);
+		writer.finish();
+	};
+
+	// Снимок уже отсортирован, поэтому дерево строится за O(n) без insert
+	template <class Map>
+	void	_load_map(Map & map, std::istream & in)
+	{
+		snapshot_reader									reader(in, snapshot_header::map_kind, sizeof(typename Map::key_type),
+			sizeof(typename Map::mapped_type));
+		_snapshot_source<typename Map::value_type>		source(reader);
+		typename Map::Tree								tmp(map._tree.allocator, map._tree.comparator);
+
+		try
+		{
+			tmp.build_sorted(source, reader.count());
+		}
+		catch (std::invalid_argument &)
+		{
+			throw snapshot_error("keys are not in comparator order");
+		}
+		reader.finish();
+		map._tree.swap(tmp);
+	};
+};
+
+#endif
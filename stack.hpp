@@ -2,11 +2,31 @@
 # define STACK_HPP
 
 # include "type_traits.hpp"
-# include "vector.hpp"
+# include "iterator_traits.hpp"
+# include "deque.hpp"
 # include <iostream>
 
 namespace ft {
-template <class T, class Container = vector<T> > 
+// Есть ли у контейнера void reserve(size_type)
+template <typename C>
+struct _has_reserve
+{
+	typedef char	_yes;
+	typedef char	(&_no)[2];
+
+	template <typename U, void (U::*)(typename U::size_type)>
+	struct _check {};
+
+	template <typename U>
+	static _yes	_test(_check<U, &U::reserve> *);
+
+	template <typename U>
+	static _no	_test(...);
+
+	static const bool	value = sizeof(_test<C>(NULL)) == sizeof(_yes);
+};
+
+template <class T, class Container = deque<T> > 
 class stack {
 	public:
 		typedef				Container																				container_type;
@@ -28,6 +48,50 @@ class stack {
 		void	push(const_reference val) { c.push_back(val); };
 		void	pop(void) { c.pop_back(); };
 		void	swap(stack &ref) { this->c.swap(ref.c); };
+
+		// Пачечные операции: контейнеры с произвольным доступом получают один
+		// insert/erase на всю пачку, остальные - цикл push_back/pop_back
+		void	reserve(size_type n) { this->_reserve(n, ft::integral_constant<bool, _has_reserve<Container>::value>()); };
+
+		template <typename InputIterator>
+		void	push_range(InputIterator first, InputIterator last) { this->_push_range(first, last, _category()); };
+
+		void	pop_n(size_type n) { this->_pop_n(n < c.size() ? n : c.size(), _category()); };
+
+		// Копирует n верхних элементов в out, начиная с вершины
+		template <typename OutputIterator>
+		OutputIterator	top_n(size_type n, OutputIterator out) const
+		{
+			typename container_type::const_iterator	it = c.end();
+
+			while (n-- && it != c.begin())
+				*out++ = *--it;
+			return (out);
+		};
+
+	private:
+		typedef typename	ft::iterator_traits<typename container_type::iterator>::iterator_category	_category;
+
+		void	_reserve(size_type n, ft::true_type) { c.reserve(n); };
+		void	_reserve(size_type, ft::false_type) {};
+
+		template <typename InputIterator>
+		void	_push_range(InputIterator first, InputIterator last, std::random_access_iterator_tag) { c.insert(c.end(), first, last); };
+
+		template <typename InputIterator>
+		void	_push_range(InputIterator first, InputIterator last, std::input_iterator_tag)
+		{
+			for (; first != last; ++first)
+				c.push_back(*first);
+		};
+
+		void	_pop_n(size_type n, std::random_access_iterator_tag) { c.erase(c.end() - n, c.end()); };
+
+		void	_pop_n(size_type n, std::input_iterator_tag)
+		{
+			while (n--)
+				c.pop_back();
+		};
 };
 
 template <typename T, typename Container>
@@ -0,0 +1,193 @@
+#include <map>
+#include <string>
+#include <cstdlib>
+
+#include "map.hpp"
+#include "test.hpp"
+
+// Некоммутативный моноид: конкатенация проверяет порядок ключей в свертке
+struct concat_monoid
+{
+	typedef	std::string	result_type;
+
+	static result_type	identity(void)
+	{
+		return (result_type());
+	};
+
+	static result_type	combine(const result_type & lhd, const result_type & rhd)
+	{
+		return (lhd + rhd);
+	};
+
+	static result_type	lift(char value)
+	{
+		return (result_type(1, value));
+	};
+};
+
+typedef ft::map<int, long, std::less<int>, std::allocator<ft::pair<const int, long> >, ft::sum_monoid<long> >	sum_map;
+typedef ft::map<int, char, std::less<int>, std::allocator<ft::pair<const int, char> >, concat_monoid>			concat_map;
+
+template <typename T>
+static bool	is_const(T &)
+{
+	return (false);
+}
+
+template <typename T>
+static bool	is_const(const T &)
+{
+	return (true);
+}
+
+static long	brute_sum(const std::map<int, long> & ref, int lo, int hi)
+{
+	long	sum = 0;
+
+	for (std::map<int, long>::const_iterator it = ref.lower_bound(lo); it != ref.end() && it->first <= hi; ++it)
+		sum += it->second;
+	return (sum);
+}
+
+static void	test_random_updates(void)
+{
+	sum_map					sums;
+	concat_map				text;
+	std::map<int, long>		ref;
+	std::map<int, char>		ref_text;
+
+	for (int op = 0; op < 20000; op++)
+	{
+		int		key = std::rand() % 2000;
+		int		kind = std::rand() % 5;
+
+		if (kind == 0)
+		{
+			CHECK(sums.erase(key) == ref.erase(key));
+			text.erase(key);
+			ref_text.erase(key);
+		}
+		else if (kind < 3)
+		{
+			long	value = std::rand() % 1000 - 500;
+			char	letter = 'a' + std::rand() % 26;
+
+			sums.assign(key, value);
+			ref[key] = value;
+			text.assign(key, letter);
+			ref_text[key] = letter;
+		}
+		else if (kind < 4)
+		{
+			CHECK(sums[key] == ref[key]);
+			text[key];
+			ref_text.insert(std::make_pair(key, char()));
+		}
+		else
+		{
+			int				lo = std::rand() % 2000;
+			int				hi = lo + std::rand() % 400;
+			std::string		expected;
+
+			for (std::map<int, char>::iterator it = ref_text.lower_bound(lo); it != ref_text.end() && it->first <= hi; ++it)
+				expected += it->second;
+			CHECK(sums.aggregate(lo, hi) == brute_sum(ref, lo, hi));
+			CHECK(text.aggregate(lo, hi) == expected);
+			CHECK(sums.aggregate(hi + 1, lo) == 0);
+		}
+	}
+	CHECK(ft::_test_access::valid_tree(sums));
+	CHECK(sums.aggregate() == brute_sum(ref, -1, 2000));
+}
+
+// Перенос узлов и операции над множествами тоже держат свертки в порядке
+static void	test_node_moves(void)
+{
+	sum_map		a;
+	sum_map		b;
+
+	for (int i = 0; i < 1000; i++)
+	{
+		a.assign(i, i);
+		b.assign(i + 500, 1);
+	}
+
+	sum_map::node_type	node = a.extract(10);
+
+	CHECK(a.aggregate() == 499500 - 10);
+	b.insert(node);
+	CHECK(b.aggregate() == 1000 + 10);
+	a.merge(b);
+	CHECK(a.aggregate() == 499500 - 10 + 10 + 500);
+	CHECK(b.aggregate(500, 999) == 500);
+
+	sum_map		joined = ft::map_union(b, a);
+
+	CHECK(joined.aggregate(500, 999) == 500);
+	CHECK(joined.aggregate(1000, 1499) == 500);
+	CHECK(ft::_test_access::valid_tree(joined));
+}
+
+// Считает, с какой константностью for_each передает значения
+struct ReadOnlyVisit
+{
+	int		const_calls;
+	int		mutable_calls;
+
+	ReadOnlyVisit(void) : const_calls(0), mutable_calls(0) {};
+
+	bool	operator()(sum_map::value_type &)
+	{
+		this->mutable_calls++;
+		return (true);
+	};
+
+	bool	operator()(const sum_map::value_type &)
+	{
+		this->const_calls++;
+		return (true);
+	};
+};
+
+// С Monoid доступ к значениям только на чтение, запись - через assign
+static void	test_read_only_access(void)
+{
+	sum_map		sums;
+
+	sums.assign(1, 5);
+	CHECK(is_const(sums[1]));
+	CHECK(is_const(sums.at(1)));
+	CHECK(is_const(sums.begin()->second));
+	CHECK(is_const(sums.rbegin()->second));
+
+	ft::map<int, long>	plain;
+
+	plain[1] = 5;
+	CHECK(!is_const(plain[1]));
+	CHECK(!is_const(plain.begin()->second));
+
+	ReadOnlyVisit	visit = sums.for_each(ReadOnlyVisit());
+
+	CHECK(visit.const_calls == 1 && visit.mutable_calls == 0);
+	sums.assign(2, 6);
+	visit = sums.for_each_in_range(0, 5, ReadOnlyVisit());
+	CHECK(visit.const_calls == 2 && visit.mutable_calls == 0);
+	CHECK(sums.aggregate() == 11);
+	sums.erase(2);
+
+	sum_map::const_iterator	it = sums.find(1);
+
+	CHECK(it == sums.begin() && it->second == 5);
+	sums.assign(1, 7);
+	CHECK(sums.aggregate() == 7);
+}
+
+int	main(void)
+{
+	std::srand(3);
+	test_random_updates();
+	test_node_moves();
+	test_read_only_access();
+	return (test_result("aggregate"));
+}
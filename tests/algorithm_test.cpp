@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <vector>
+#include <cstdlib>
+
+#include "algorithm.hpp"
+#include "vector.hpp"
+#include "test.hpp"
+
+// Запись с ключом и номером во входе: по номеру видно, сохранен ли порядок равных
+struct Record
+{
+	int		key;
+	int		seq;
+};
+
+static bool	operator==(const Record & lhd, const Record & rhd)
+{
+	return (lhd.key == rhd.key && lhd.seq == rhd.seq);
+}
+
+struct KeyLess
+{
+	bool	operator()(const Record & lhd, const Record & rhd)	const
+	{
+		return (lhd.key < rhd.key);
+	};
+};
+
+struct KeyEqual
+{
+	bool	operator()(const Record & lhd, const Record & rhd)	const
+	{
+		return (lhd.key == rhd.key);
+	};
+};
+
+struct KeyOf
+{
+	typedef int		result_type;
+
+	int		operator()(const Record & record)	const
+	{
+		return (record.key);
+	};
+};
+
+static long	key_of(const Record & record)
+{
+	return (record.key);
+}
+
+enum Shape { RANDOM, DUPLICATES, SORTED, REVERSE };
+
+static std::vector<Record>	make_records(Shape shape, std::size_t n)
+{
+	std::vector<Record>	records(n);
+
+	for (std::size_t i = 0; i < n; i++)
+	{
+		int		key = std::rand() - RAND_MAX / 2;
+
+		if (shape == DUPLICATES)
+			key = key % 8;
+		else if (shape == SORTED)
+			key = static_cast<int>(i) - static_cast<int>(n / 2);
+		else if (shape == REVERSE)
+			key = static_cast<int>(n / 2) - static_cast<int>(i);
+		records[i].key = key;
+		records[i].seq = static_cast<int>(i);
+	}
+	return (records);
+}
+
+static const std::size_t	g_sizes[] = { 0, 1, 2, 15, 16, 17, 100, 1023, 1024, 1025, 5000, 100000 };
+static const std::size_t	g_sizes_count = sizeof(g_sizes) / sizeof(g_sizes[0]);
+
+// sort и stable_sort с компаратором на записях: stable_sort совпадает
+// с std::stable_sort, у sort совпадают ключи и набор записей
+static void	test_compare_sorts(void)
+{
+	for (int shape = RANDOM; shape <= REVERSE; shape++)
+		for (std::size_t s = 0; s < g_sizes_count; s++)
+		{
+			std::vector<Record>		expected = make_records(static_cast<Shape>(shape), g_sizes[s]);
+			ft::vector<Record>		stable(expected.begin(), expected.end());
+			std::vector<Record>		unstable(expected);
+
+			std::stable_sort(expected.begin(), expected.end(), KeyLess());
+			ft::stable_sort(stable.begin(), stable.end(), KeyLess());
+			ft::sort(unstable.begin(), unstable.end(), KeyLess());
+			CHECK(std::equal(expected.begin(), expected.end(), stable.begin()));
+
+			bool	same_keys = true;
+
+			for (std::size_t i = 0; i < expected.size(); i++)
+				same_keys = same_keys && unstable[i].key == expected[i].key;
+			CHECK(same_keys);
+
+			// Номера внутри каждой группы равных ключей - та же перестановка
+			std::size_t	group = 0;
+			bool		same_records = true;
+
+			for (std::size_t i = 1; i <= unstable.size(); i++)
+				if (i == unstable.size() || unstable[i].key != unstable[group].key)
+				{
+					std::vector<int>	seqs;
+
+					for (std::size_t j = group; j < i; j++)
+						seqs.push_back(unstable[j].seq);
+					std::sort(seqs.begin(), seqs.end());
+					for (std::size_t j = group; j < i; j++)
+						same_records = same_records && seqs[j - group] == expected[j].seq;
+					group = i;
+				}
+			CHECK(same_records);
+		}
+}
+
+template <typename T>
+static void	check_integral_sort(const std::vector<T> & input)
+{
+	std::vector<T>	expected(input);
+	std::vector<T>	sorted(input);
+	ft::vector<T>	stable(input.begin(), input.end());
+	std::vector<T>	radix(input);
+
+	std::sort(expected.begin(), expected.end());
+	ft::sort(sorted.begin(), sorted.end());
+	ft::stable_sort(stable.begin(), stable.end());
+	ft::radix_sort(radix.begin(), radix.end());
+	CHECK(sorted == expected);
+	CHECK(std::equal(expected.begin(), expected.end(), stable.begin()));
+	CHECK(radix == expected);
+}
+
+// Целые от threshold и выше идут поразрядно: отрицательные, крайние значения
+// и типы разной ширины со знаком и без
+static void	test_integral_sorts(void)
+{
+	for (int shape = RANDOM; shape <= REVERSE; shape++)
+		for (std::size_t s = 0; s < g_sizes_count; s++)
+		{
+			std::vector<Record>		records = make_records(static_cast<Shape>(shape), g_sizes[s]);
+			std::vector<int>		ints;
+			std::vector<long long>	longs;
+			std::vector<unsigned>	unsigneds;
+			std::vector<short>		shorts;
+			std::vector<char>		chars;
+
+			for (std::size_t i = 0; i < records.size(); i++)
+			{
+				int		key = records[i].key;
+
+				ints.push_back(key);
+				longs.push_back(static_cast<long long>(key) * 0x10001LL);
+				unsigneds.push_back(static_cast<unsigned>(key));
+				shorts.push_back(static_cast<short>(key));
+				chars.push_back(static_cast<char>(key));
+			}
+			if (!ints.empty())
+			{
+				ints[ints.size() / 2] = INT_MIN;
+				ints[0] = INT_MAX;
+				longs[longs.size() / 2] = LLONG_MIN;
+			}
+			check_integral_sort(ints);
+			check_integral_sort(longs);
+			check_integral_sort(unsigneds);
+			check_integral_sort(shorts);
+			check_integral_sort(chars);
+		}
+}
+
+// radix_sort по ключу записи устойчив: функтор с result_type и указатель на функцию
+static void	test_radix_key(void)
+{
+	for (int shape = RANDOM; shape <= REVERSE; shape++)
+		for (std::size_t s = 0; s < g_sizes_count; s++)
+		{
+			std::vector<Record>		expected = make_records(static_cast<Shape>(shape), g_sizes[s]);
+			std::vector<Record>		by_functor(expected);
+			ft::vector<Record>		by_pointer(expected.begin(), expected.end());
+
+			std::stable_sort(expected.begin(), expected.end(), KeyLess());
+			ft::radix_sort(by_functor.begin(), by_functor.end(), KeyOf());
+			ft::radix_sort(by_pointer.begin(), by_pointer.end(), &key_of);
+			CHECK(by_functor == expected);
+			CHECK(std::equal(expected.begin(), expected.end(), by_pointer.begin()));
+		}
+}
+
+// merge и unique совпадают с std:: на записях: из равных ключей merge берет
+// сначала левый диапазон, unique оставляет первый из серии
+static void	test_merge_unique(void)
+{
+	for (int shape = RANDOM; shape <= REVERSE; shape++)
+		for (std::size_t s = 0; s + 1 < g_sizes_count; s++)
+		{
+			std::vector<Record>	left = make_records(static_cast<Shape>(shape), g_sizes[s]);
+			std::vector<Record>	right = make_records(DUPLICATES, g_sizes[s + 1] / 3);
+			std::vector<Record>	expected(left.size() + right.size());
+			std::vector<Record>	merged(expected.size());
+
+			std::stable_sort(left.begin(), left.end(), KeyLess());
+			std::stable_sort(right.begin(), right.end(), KeyLess());
+			CHECK(std::merge(left.begin(), left.end(), right.begin(), right.end(), expected.begin(), KeyLess())
+				== expected.end());
+			CHECK(ft::merge(left.begin(), left.end(), right.begin(), right.end(), merged.begin(), KeyLess())
+				== merged.end());
+			CHECK(merged == expected);
+
+			std::vector<Record>	unique(merged);
+			std::size_t			kept = std::unique(expected.begin(), expected.end(), KeyEqual()) - expected.begin();
+
+			CHECK(static_cast<std::size_t>(ft::unique(unique.begin(), unique.end(), KeyEqual()) - unique.begin()) == kept);
+			CHECK(std::equal(expected.begin(), expected.begin() + kept, unique.begin()));
+		}
+
+	int					lhd[] = { 1, 3, 3, 5 };
+	int					rhd[] = { 2, 3, 6 };
+	int					out[7];
+	ft::vector<int>		repeats(out, ft::merge(lhd, lhd + 4, rhd, rhd + 3, out));
+
+	CHECK(repeats.size() == 7 && repeats[0] == 1 && repeats[4] == 3 && repeats[6] == 6);
+	repeats.erase(ft::unique(repeats.begin(), repeats.end()), repeats.end());
+	CHECK(repeats.size() == 5 && repeats[2] == 3 && repeats[3] == 5);
+	CHECK(ft::unique(out, out) == out && ft::merge(lhd, lhd, rhd, rhd, out) == out);
+}
+
+static const std::size_t	g_lengths[] = { 0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100 };
+static const std::size_t	g_lengths_count = sizeof(g_lengths) / sizeof(g_lengths[0]);
+
+// Каждое ядро по отдельности: длины вокруг ширины регистров, различие
+// в первом, среднем и последнем байте или нигде
+static void	check_kernel(ft::_mismatch_kernel::function kernel)
+{
+	for (std::size_t l = 0; l < g_lengths_count; l++)
+	{
+		std::size_t					n = g_lengths[l];
+		// Ровно n байт: ASan поймает чтение за концом
+		std::vector<unsigned char>	lhd(n ? n : 1);
+
+		for (std::size_t i = 0; i < n; i++)
+			lhd[i] = static_cast<unsigned char>(std::rand());
+
+		std::vector<unsigned char>	rhd(lhd);
+
+		CHECK(kernel(&lhd[0], &rhd[0], n) == n);
+		if (!n)
+			continue ;
+
+		std::size_t	positions[] = { 0, n / 2, n - 1 };
+
+		for (int p = 0; p < 3; p++)
+		{
+			rhd[positions[p]] ^= 0x80;
+			CHECK(kernel(&lhd[0], &rhd[0], n) == positions[p]);
+			rhd[positions[p]] ^= 0x80;
+		}
+	}
+}
+
+static void	test_kernels(void)
+{
+	check_kernel(&ft::_mismatch_kernel::scalar);
+#ifdef FT_SIMD_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2"))
+		check_kernel(&ft::_mismatch_kernel::sse2);
+	if (__builtin_cpu_supports("avx2"))
+		check_kernel(&ft::_mismatch_kernel::avx2);
+#endif
+}
+
+// equal и lexicographical_compare на непрерывных диапазонах совпадают с std::
+// на тех же длинах и позициях различия, в том числе для signed char
+// (байт 0x80 меньше 0x7F) и многобайтовых int
+template <typename T>
+static void	check_compare(const std::vector<T> & lhd, const std::vector<T> & rhd)
+{
+	ft::vector<T>	ft_lhd(lhd.begin(), lhd.end());
+	ft::vector<T>	ft_rhd(rhd.begin(), rhd.end());
+	bool			equal = lhd.size() == rhd.size() && std::equal(lhd.begin(), lhd.end(), rhd.begin());
+	bool			less = std::lexicographical_compare(lhd.begin(), lhd.end(), rhd.begin(), rhd.end());
+	bool			greater = std::lexicographical_compare(rhd.begin(), rhd.end(), lhd.begin(), lhd.end());
+
+	if (lhd.size() == rhd.size())
+	{
+		CHECK(ft::equal(ft_lhd.begin(), ft_lhd.end(), ft_rhd.begin()) == equal);
+		CHECK(ft::equal(ft_lhd.data(), ft_lhd.data() + ft_lhd.size(), ft_rhd.data()) == equal);
+		CHECK((ft_lhd == ft_rhd) == equal);
+	}
+	CHECK(ft::lexicographical_compare(ft_lhd.begin(), ft_lhd.end(), ft_rhd.begin(), ft_rhd.end()) == less);
+	CHECK(ft::lexicographical_compare(ft_rhd.begin(), ft_rhd.end(), ft_lhd.begin(), ft_lhd.end()) == greater);
+	CHECK(ft::lexicographical_compare(ft_lhd.data(), ft_lhd.data() + ft_lhd.size(), ft_rhd.data(), ft_rhd.data() + ft_rhd.size()) == less);
+	CHECK((ft_lhd < ft_rhd) == less);
+}
+
+template <typename T>
+static void	test_compare(T low, T high)
+{
+	for (std::size_t l = 0; l < g_lengths_count; l++)
+	{
+		std::size_t		n = g_lengths[l];
+		std::vector<T>	lhd(n);
+
+		for (std::size_t i = 0; i < n; i++)
+			lhd[i] = static_cast<T>(std::rand());
+
+		std::vector<T>	rhd(lhd);
+
+		check_compare(lhd, rhd);
+		if (n)
+		{
+			std::vector<T>	shorter(lhd.begin(), lhd.end() - 1);
+
+			check_compare(lhd, shorter);
+			check_compare(shorter, lhd);
+		}
+		for (std::size_t p = 0; n && p < 3; p++)
+		{
+			std::size_t	position = p == 0 ? 0 : p == 1 ? n / 2 : n - 1;
+			T			saved = rhd[position];
+
+			rhd[position] = lhd[position] == high ? low : high;
+			check_compare(lhd, rhd);
+			check_compare(rhd, lhd);
+			rhd[position] = lhd[position] == low ? high : low;
+			check_compare(lhd, rhd);
+			check_compare(rhd, lhd);
+			rhd[position] = saved;
+		}
+	}
+}
+
+int	main(void)
+{
+	std::srand(36);
+	test_compare_sorts();
+	test_integral_sorts();
+	test_radix_key();
+	test_merge_unique();
+	test_kernels();
+	test_compare<signed char>(-128, 127);
+	test_compare<char>(CHAR_MIN, CHAR_MAX);
+	test_compare<unsigned char>(0, 255);
+	test_compare<int>(INT_MIN, INT_MAX);
+	test_compare<unsigned>(0, UINT_MAX);
+	return (test_result("algorithm"));
+}
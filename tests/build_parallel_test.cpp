@@ -0,0 +1,119 @@
+#include <map>
+#include <vector>
+#include <cstdlib>
+
+#include "map.hpp"
+#include "parallel_build.hpp"
+#include "test.hpp"
+
+// Ключ без конструктора по умолчанию
+class Id
+{
+	private:
+		int		_value;
+
+	public:
+		explicit Id(int value) : _value(value) {};
+
+		int		value(void)	const
+		{
+			return (this->_value);
+		};
+
+		bool	operator<(const Id & rhd)	const
+		{
+			return (this->_value < rhd._value);
+		};
+
+		bool	operator==(const Id & rhd)	const
+		{
+			return (this->_value == rhd._value);
+		};
+};
+
+typedef ft::map<Id, int>	id_map;
+
+static const int	g_count = 200000;
+
+// Перемешанные ключи с повторами; значение - номер позиции, чтобы было видно,
+// какой из равных ключей остался
+static std::vector<ft::pair<Id, int> >	make_input(void)
+{
+	std::vector<ft::pair<Id, int> >	input;
+
+	for (int i = 0; i < g_count; i++)
+		input.push_back(ft::make_pair(Id(std::rand() % (g_count / 2)), i));
+	return (input);
+}
+
+// Из равных ключей остается первый, как при insert; результат совпадает
+// узел в узел с последовательной сборкой из того же отсортированного массива
+static void	test_matches_serial_build(std::size_t threads)
+{
+	std::vector<ft::pair<Id, int> >		input = make_input();
+	std::map<int, int>					first;
+	std::vector<ft::pair<const Id, int> >	sorted;
+
+	for (std::size_t i = 0; i < input.size(); i++)
+		first.insert(std::make_pair(input[i].first.value(), input[i].second));
+	for (std::map<int, int>::iterator it = first.begin(); it != first.end(); ++it)
+		sorted.push_back(ft::pair<const Id, int>(Id(it->first), it->second));
+
+	id_map		parallel;
+	id_map		serial(ft::sorted_unique, sorted.begin(), sorted.end());
+
+	parallel.insert(ft::make_pair(Id(-1), 0));
+	parallel.build_parallel(input.begin(), input.end(), threads);
+
+	CHECK(parallel.size() == first.size());
+	CHECK(ft::_test_access::valid_tree(parallel));
+	CHECK(ft::_test_access::same_nodes(parallel, serial));
+}
+
+static void	test_aggregate_map(void)
+{
+	typedef ft::map<int, long, std::less<int>, std::allocator<ft::pair<const int, long> >, ft::sum_monoid<long> >	sum_map;
+
+	std::vector<ft::pair<int, long> >	input;
+	long								total = 0;
+
+	for (int i = g_count - 1; i >= 0; i--)
+	{
+		input.push_back(ft::make_pair(i, static_cast<long>(i % 10)));
+		total += i % 10;
+	}
+
+	sum_map		sums;
+
+	sums.build_parallel(input.begin(), input.end(), 4);
+	CHECK(sums.size() == static_cast<std::size_t>(g_count));
+	CHECK(sums.aggregate() == total);
+	CHECK(sums.aggregate(10, 19) == 45);
+	CHECK(ft::_test_access::valid_tree(sums));
+}
+
+static void	test_small_and_empty(void)
+{
+	std::vector<ft::pair<Id, int> >	input;
+	id_map								m;
+
+	m.insert(ft::make_pair(Id(1), 1));
+	m.build_parallel(input.begin(), input.end(), 4);
+	CHECK(m.empty());
+
+	input.push_back(ft::make_pair(Id(3), 0));
+	input.push_back(ft::make_pair(Id(3), 1));
+	input.push_back(ft::make_pair(Id(2), 2));
+	m.build_parallel(input.begin(), input.end(), 4);
+	CHECK(m.size() == 2 && m.begin()->first.value() == 2 && m.rbegin()->second == 0);
+}
+
+int	main(void)
+{
+	std::srand(11);
+	test_matches_serial_build(1);
+	test_matches_serial_build(4);
+	test_aggregate_map();
+	test_small_and_empty();
+	return (test_result("build_parallel"));
+}
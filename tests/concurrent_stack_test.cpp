@@ -0,0 +1,137 @@
+#include <iterator>
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+#include "concurrent_stack.hpp"
+#include "test.hpp"
+
+// Аллокатор со счетчиком выделенных узлов: сегменты заводят разные потоки
+template <typename T>
+struct CountingAllocator : public std::allocator<T>
+{
+	template <typename U>
+	struct rebind
+	{
+		typedef CountingAllocator<U>	other;
+	};
+
+	static std::size_t	allocated;
+
+	CountingAllocator(void) {};
+
+	template <typename U>
+	CountingAllocator(const CountingAllocator<U> &) {};
+
+	T *		allocate(std::size_t n)
+	{
+		__atomic_add_fetch(&allocated, n, __ATOMIC_RELAXED);
+		return (std::allocator<T>::allocate(n));
+	};
+};
+
+template <typename T>
+std::size_t	CountingAllocator<T>::allocated = 0;
+
+typedef ft::concurrent_stack<int, CountingAllocator<int> >	int_stack;
+
+static const int	g_threads = 4;
+static const int	g_per_thread = 50000;
+
+static void	test_sequential(void)
+{
+	ft::concurrent_stack<std::string>	stack;
+	std::string							value;
+	std::string							values[] = { "a", "b", "c", "d" };
+
+	CHECK(stack.empty() && !stack.try_pop(value));
+	stack.push("x");
+	stack.push_many(values, values + 4);
+	CHECK(!stack.empty());
+
+	std::vector<std::string>	top;
+
+	CHECK(stack.pop_many(std::back_inserter(top), 3) == 3);
+	CHECK(top.size() == 3 && top[0] == "d" && top[1] == "c" && top[2] == "b");
+	CHECK(stack.try_pop(value) && value == "a");
+	CHECK(stack.try_pop(value) && value == "x");
+	CHECK(stack.empty() && stack.pop_many(std::back_inserter(top), 3) == 0);
+
+	// Остаток разрушает деструктор стека
+	stack.push(std::string(100, 'y'));
+}
+
+struct Worker
+{
+	int_stack *			stack;
+	int					id;
+	std::vector<int>	popped;
+};
+
+// Каждый поток кладет свои значения вперемешку тремя способами
+// и сразу снимает что попадется, так что узлы постоянно переходят из рук в руки
+static void *	run_worker(void * arg)
+{
+	Worker &				worker = *static_cast<Worker *>(arg);
+	int_stack::local_cache	cache(*worker.stack);
+	int						value;
+
+	for (int i = 0; i < g_per_thread; i += 4)
+	{
+		int		base = worker.id * g_per_thread + i;
+		int		batch[2] = { base + 2, base + 3 };
+
+		worker.stack->push(base);
+		worker.stack->push(base + 1, cache);
+		worker.stack->push_many(batch, batch + 2);
+		if (worker.stack->try_pop(value, cache))
+			worker.popped.push_back(value);
+		if (worker.stack->try_pop(value))
+			worker.popped.push_back(value);
+		worker.stack->pop_many(std::back_inserter(worker.popped), 2);
+	}
+	return (NULL);
+}
+
+// Каждое значение снято ровно один раз, а живых элементов не больше
+// g_threads * 4, поэтому освобожденные узлы переиспользуются
+static void	test_concurrent(void)
+{
+	int_stack			stack;
+	pthread_t			threads[g_threads];
+	Worker				workers[g_threads];
+	std::vector<int>	seen(g_threads * g_per_thread, 0);
+
+	CountingAllocator<int>::allocated = 0;
+	for (int t = 0; t < g_threads; t++)
+	{
+		workers[t].stack = &stack;
+		workers[t].id = t;
+		pthread_create(&threads[t], NULL, run_worker, &workers[t]);
+	}
+	for (int t = 0; t < g_threads; t++)
+		pthread_join(threads[t], NULL);
+
+	int		value;
+
+	while (stack.try_pop(value))
+		seen[value]++;
+	for (int t = 0; t < g_threads; t++)
+		for (std::size_t i = 0; i < workers[t].popped.size(); i++)
+			seen[workers[t].popped[i]]++;
+
+	bool	once = true;
+
+	for (std::size_t i = 0; i < seen.size(); i++)
+		once = once && seen[i] == 1;
+	CHECK(once);
+	CHECK(stack.empty());
+	CHECK(CountingAllocator<int>::allocated < 4096);
+}
+
+int	main(void)
+{
+	test_sequential();
+	test_concurrent();
+	return (test_result("concurrent_stack"));
+}
@@ -0,0 +1,360 @@
+#include <map>
+#include <new>
+#include <pthread.h>
+#include <cstdlib>
+
+#include "cow_map.hpp"
+#include "tracking_allocator.hpp"
+#include "test.hpp"
+
+typedef ft::cow_map<int, int>	int_map;
+typedef std::map<int, int>		std_map;
+
+template <class Map>
+static bool	same(const Map & ft, const std_map & std)
+{
+	if (ft.size() != std.size())
+		return (false);
+
+	typename Map::const_iterator	it = ft.begin();
+
+	for (std_map::const_iterator jt = std.begin(); jt != std.end(); ++it, ++jt)
+		if (it->first != jt->first || it->second != jt->second)
+			return (false);
+	return (it == ft.end());
+}
+
+// Несколько копий с общими поддеревьями и их эталоны: запись в одну копию
+// не видна в остальных, после каждой записи AVL в порядке
+static void	test_random_copies(void)
+{
+	static const int	copies = 8;
+	int_map				maps[copies];
+	std_map				refs[copies];
+
+	for (int op = 0; op < 40000; op++)
+	{
+		int		i = std::rand() % copies;
+		int		key = std::rand() % 1000;
+		int		kind = std::rand() % 10;
+
+		if (kind < 3)
+		{
+			CHECK(maps[i].insert(ft::make_pair(key, op)).second == refs[i].insert(std::make_pair(key, op)).second);
+			CHECK(maps[i].at(key) == refs[i][key]);
+		}
+		else if (kind < 5)
+		{
+			maps[i].assign(key, op);
+			refs[i][key] = op;
+		}
+		else if (kind < 7)
+			CHECK(maps[i].erase(key) == refs[i].erase(key));
+		else if (kind < 8)
+		{
+			int_map::const_iterator	it = maps[i].lower_bound(key);
+
+			if (it != maps[i].end())
+			{
+				refs[i].erase(it->first);
+				maps[i].erase(it);
+			}
+		}
+		else if (kind < 9)
+		{
+			int		j = std::rand() % copies;
+
+			maps[j] = maps[i];
+			refs[j] = refs[i];
+			CHECK(ft::_test_access::shares_tree(maps[i], maps[j]));
+		}
+		else
+		{
+			int_map	copy(maps[i]);
+
+			copy.erase(key);
+			copy.assign(key + 1, -1);
+			CHECK(same(maps[i], refs[i]));
+			CHECK(ft::_test_access::valid_avl(copy));
+		}
+		CHECK(ft::_test_access::valid_avl(maps[i]));
+		if (op % 1000 == 0)
+			for (int j = 0; j < copies; j++)
+				CHECK(same(maps[j], refs[j]));
+	}
+	for (int j = 0; j < copies; j++)
+	{
+		CHECK(same(maps[j], refs[j]));
+		CHECK(ft::_test_access::valid_avl(maps[j]));
+	}
+}
+
+// Копия не выделяет ничего, первая запись - узлы одного пути,
+// повторная запись в тот же ключ - ничего
+static void	test_path_copy(void)
+{
+	typedef ft::tracking_allocator<ft::pair<const int, int> >			tracked;
+	typedef ft::cow_map<int, int, std::less<int>, tracked>				tracked_map;
+
+	ft::allocation_stats	stats;
+	tracked_map				original((std::less<int>()), tracked(stats));
+	const std::size_t		n = 100000;
+	const std::size_t		height = 25;
+
+	for (std::size_t i = 0; i < n; i++)
+		original.insert(ft::make_pair(static_cast<int>(i), 0));
+
+	std::size_t	allocations = stats.allocations;
+	tracked_map	copy(original);
+
+	CHECK(stats.allocations == allocations);
+	copy.assign(n / 3, 1);
+	CHECK(stats.allocations - allocations <= height);
+	allocations = stats.allocations;
+	copy.assign(n / 3, 2);
+	CHECK(stats.allocations == allocations);
+	CHECK(original.at(n / 3) == 0 && copy.at(n / 3) == 2);
+
+	tracked_map	second(original);
+
+	allocations = stats.allocations;
+	second.erase(n / 2);
+	CHECK(stats.allocations - allocations <= 3 * height);
+	allocations = stats.allocations;
+	second.insert(ft::make_pair(static_cast<int>(n), 1));
+	CHECK(stats.allocations - allocations <= height + 1);
+	CHECK(original.size() == n && original.count(n / 2) && !original.count(n));
+	CHECK(ft::_test_access::valid_avl(original));
+	CHECK(ft::_test_access::valid_avl(copy));
+	CHECK(ft::_test_access::valid_avl(second));
+}
+
+// Считает копии значений: копия map не копирует ни одного
+struct Counted
+{
+	static int	copies;
+
+	int		value;
+
+	Counted(int value = 0) : value(value) {};
+
+	Counted(const Counted & src) : value(src.value)
+	{
+		copies++;
+	};
+
+	Counted &	operator=(const Counted & rhd)
+	{
+		this->value = rhd.value;
+		return (*this);
+	};
+};
+
+int	Counted::copies = 0;
+
+static void	test_value_copies(void)
+{
+	ft::cow_map<int, Counted>	original;
+
+	for (int i = 0; i < 1000; i++)
+		original.insert(ft::make_pair(i, Counted(i)));
+
+	Counted::copies = 0;
+
+	ft::cow_map<int, Counted>	copy(original);
+	ft::cow_map<int, Counted>	assigned;
+
+	assigned = copy;
+	CHECK(Counted::copies == 0);
+	copy.assign(500, Counted(-1));
+	// Путь AVL из 1000 узлов не длиннее 15, на узел - две копии значения
+	// (временный Node и construct)
+	CHECK(Counted::copies > 0 && Counted::copies <= 2 * 15);
+	CHECK(original.at(500).value == 500 && copy.at(500).value == -1 && assigned.at(500).value == 500);
+}
+
+// Аллокатор, который бросает после g_budget выделений (g_budget < 0 - без ограничений)
+static int	g_budget = -1;
+
+template <typename T>
+struct FailingAllocator : public std::allocator<T>
+{
+	template <typename U>
+	struct rebind
+	{
+		typedef FailingAllocator<U>	other;
+	};
+
+	FailingAllocator(void) {};
+
+	template <typename U>
+	FailingAllocator(const FailingAllocator<U> &) {};
+
+	T *		allocate(std::size_t n, const void * = 0)
+	{
+		if (!g_budget)
+			throw std::bad_alloc();
+		if (g_budget > 0)
+			g_budget--;
+		return (std::allocator<T>::allocate(n));
+	};
+};
+
+typedef ft::cow_map<int, int, std::less<int>, FailingAllocator<ft::pair<const int, int> > >	failing_map;
+
+// Запись в копию падает на каждом возможном выделении по очереди: до успеха
+// копия и оригинал остаются прежними и сбалансированными
+template <class Write>
+static void	check_strong(const failing_map & original, const std_map & ref, Write write, const std_map & expected)
+{
+	for (int budget = 0; ; budget++)
+	{
+		failing_map	copy(original);
+		bool		thrown = false;
+
+		g_budget = budget;
+		try
+		{
+			write(copy);
+		}
+		catch (const std::bad_alloc &)
+		{
+			thrown = true;
+		}
+		g_budget = -1;
+		CHECK(same(original, ref));
+		CHECK(ft::_test_access::valid_avl(copy));
+		if (!thrown)
+		{
+			CHECK(same(copy, expected));
+			break ;
+		}
+		CHECK(same(copy, ref));
+	}
+}
+
+struct Insert
+{
+	int		key;
+
+	void	operator()(failing_map & map)	const
+	{
+		map.insert(ft::make_pair(this->key, -1));
+	};
+};
+
+struct Assign
+{
+	int		key;
+
+	void	operator()(failing_map & map)	const
+	{
+		map.assign(this->key, -1);
+	};
+};
+
+struct Erase
+{
+	int		key;
+
+	void	operator()(failing_map & map)	const
+	{
+		map.erase(this->key);
+	};
+};
+
+static void	test_strong_guarantee(void)
+{
+	failing_map		original;
+	std_map			ref;
+
+	for (int i = 0; i < 500; i += 2)
+	{
+		original.insert(ft::make_pair(i, i));
+		ref[i] = i;
+	}
+
+	std_map	inserted(ref);
+	std_map	assigned(ref);
+	std_map	erased(ref);
+	Insert	insert = { 251 };
+	Assign	assign = { 250 };
+	Erase	erase = { 124 };
+
+	inserted[251] = -1;
+	assigned[250] = -1;
+	erased.erase(124);
+	check_strong(original, ref, insert, inserted);
+	check_strong(original, ref, assign, assigned);
+	check_strong(original, ref, erase, erased);
+}
+
+// Потоки копируют общий map и пишут каждый в свою копию: счетчики ссылок
+// на общих узлах меняются одновременно
+struct Shared
+{
+	const int_map *	base;
+	int				id;
+	bool			ok;
+};
+
+static void *	run_copier(void * arg)
+{
+	Shared &	shared = *static_cast<Shared *>(arg);
+
+	shared.ok = true;
+	for (int round = 0; round < 200; round++)
+	{
+		int_map		copy(*shared.base);
+		int_map		nested;
+		int			key = (shared.id * 200 + round) % 1000;
+
+		copy.assign(key, -shared.id);
+		copy.erase(key + 1);
+		nested = copy;
+		nested.insert(ft::make_pair(2000 + round, 0));
+		shared.ok = shared.ok && copy.at(key) == -shared.id && !copy.count(key + 1)
+			&& shared.base->at(key) == key && nested.size() == copy.size() + 1;
+	}
+	return (NULL);
+}
+
+static void	test_concurrent_copies(void)
+{
+	static const int	threads_count = 4;
+	int_map				base;
+	std_map				ref;
+	pthread_t			threads[threads_count];
+	Shared				shared[threads_count];
+
+	for (int i = 0; i < 1001; i++)
+	{
+		base.insert(ft::make_pair(i, i));
+		ref[i] = i;
+	}
+	for (int t = 0; t < threads_count; t++)
+	{
+		Shared	init = { &base, t, false };
+
+		shared[t] = init;
+		pthread_create(&threads[t], NULL, run_copier, &shared[t]);
+	}
+	for (int t = 0; t < threads_count; t++)
+	{
+		pthread_join(threads[t], NULL);
+		CHECK(shared[t].ok);
+	}
+	CHECK(same(base, ref));
+	CHECK(ft::_test_access::valid_avl(base));
+}
+
+int	main(void)
+{
+	std::srand(17);
+	test_random_copies();
+	test_path_copy();
+	test_value_copies();
+	test_strong_guarantee();
+	test_concurrent_copies();
+	return (test_result("cow_map"));
+}
@@ -0,0 +1,202 @@
+#include <deque>
+#include <cstdlib>
+
+#include "deque.hpp"
+#include "stack.hpp"
+#include "tracking_allocator.hpp"
+#include "test.hpp"
+
+typedef ft::deque<int>		ft_deque;
+typedef std::deque<int>		std_deque;
+
+template <class Deque>
+static bool	same(const Deque & ft, const std_deque & std)
+{
+	if (ft.size() != std.size())
+		return (false);
+	for (std::size_t i = 0; i < std.size(); i++)
+		if (ft[i] != std[i])
+			return (false);
+	return (true);
+}
+
+// Случайные push/pop с обоих концов: размер качается вокруг нескольких чанков
+// (1024 int), так что границы чанков и рост карты проходятся в обе стороны
+static void	test_both_ends(void)
+{
+	ft_deque	ft;
+	std_deque	std;
+
+	for (int op = 0; op < 200000; op++)
+	{
+		int		kind = std::rand() % 9;
+
+		if (kind < 3)
+		{
+			ft.push_back(op);
+			std.push_back(op);
+		}
+		else if (kind < 6)
+		{
+			ft.push_front(op);
+			std.push_front(op);
+		}
+		else if (kind < 7 && !std.empty())
+		{
+			ft.pop_back();
+			std.pop_back();
+		}
+		else if (!std.empty())
+		{
+			ft.pop_front();
+			std.pop_front();
+		}
+		if (!std.empty())
+			CHECK(ft.front() == std.front() && ft.back() == std.back());
+		if (op % 5000 == 0)
+			CHECK(same(ft, std));
+	}
+	CHECK(same(ft, std));
+	while (!std.empty())
+	{
+		ft.pop_front();
+		std.pop_front();
+	}
+	CHECK(ft.empty());
+	ft.pop_back();
+	ft.pop_front();
+	CHECK(ft.empty());
+}
+
+// Элементы не переезжают, когда карта растет с любого конца
+static void	test_stable_references(void)
+{
+	ft_deque	deque;
+
+	deque.push_back(-1);
+
+	const int *	first = &deque.front();
+
+	for (int i = 0; i < 100000; i++)
+	{
+		deque.push_back(i);
+		deque.push_front(-i);
+	}
+	CHECK(first == &deque[100000] && *first == -1);
+	CHECK(deque.size() == 200001 && deque.front() == -99999 && deque.back() == 99999);
+}
+
+typedef ft::tracking_allocator<int>		tracked;
+
+// Стек, который качается вверх-вниз, после первого подъема не выделяет:
+// опустевшие чанки ждут в запасе, shrink_to_fit отдает их
+static void	test_spare_chunks(void)
+{
+	ft::allocation_stats		stats;
+	ft::deque<int, tracked>		deque((tracked(stats)));
+
+	for (int i = 0; i < 10000; i++)
+		deque.push_back(i);
+	while (!deque.empty())
+		deque.pop_back();
+
+	std::size_t	allocations = stats.allocations;
+
+	for (int round = 0; round < 50; round++)
+	{
+		for (int i = 0; i < 10000; i++)
+			deque.push_back(i);
+		CHECK(deque[9999] == 9999);
+		while (!deque.empty())
+			deque.pop_back();
+	}
+	CHECK(stats.allocations == allocations);
+
+	std::size_t	live = stats.live_bytes;
+
+	deque.shrink_to_fit();
+	CHECK(stats.live_bytes < live && stats.deallocations > 0);
+
+	ft::deque<int, tracked>	reserved((tracked(stats)));
+
+	reserved.reserve(5000);
+	allocations = stats.allocations;
+	for (int i = 0; i < 5000; i++)
+		reserved.push_back(i);
+	CHECK(stats.allocations == allocations);
+}
+
+// Арифметика итераторов через границы чанков при начале не с нуля
+static void	test_iterators(void)
+{
+	ft_deque	deque;
+
+	for (int i = 0; i < 3000; i++)
+		deque.push_back(i);
+	for (int i = 1; i <= 1500; i++)
+		deque.push_front(-i);
+
+	ft_deque::iterator			begin = deque.begin();
+	ft_deque::iterator			end = deque.end();
+	ft_deque::const_iterator	cbegin = deque.begin();
+
+	CHECK(end - begin == 4500 && begin - end == -4500);
+	CHECK(*(begin + 1500) == 0 && begin[1499] == -1 && *(end - 1) == 2999);
+	CHECK(*(1024 + begin) == begin[1024] && cbegin == begin && cbegin + 4500 == end);
+	CHECK(begin < end && end > cbegin && begin <= cbegin && end >= begin + 4500);
+
+	ft_deque::iterator	it = begin;
+
+	it += 2047;
+	CHECK(*it == 547 && *it++ == 547 && *it == 548);
+	it -= 1000;
+	CHECK(*it == -452 && *--it == -453 && *it-- == -453 && *it == -454);
+
+	long	sum = 0;
+
+	for (ft_deque::const_iterator jt = deque.begin(); jt != deque.end(); ++jt)
+		sum += *jt;
+	CHECK(sum == 2999L * 3000 / 2 - 1500L * 1501 / 2);
+
+	ft_deque::reverse_iterator	rit = deque.rbegin();
+
+	CHECK(*rit == 2999 && rit[4499] == -1500 && deque.rend() - deque.rbegin() == 4500);
+
+	deque.insert(deque.begin() + 2000, 3, 77);
+	CHECK(deque.size() == 4503 && deque[1999] == 499 && deque[2000] == 77 && deque[2003] == 500);
+	deque.erase(deque.begin() + 2000, deque.begin() + 2003);
+	deque.erase(deque.begin() + 10);
+	CHECK(deque.size() == 4499 && deque[10] == -1489 && deque[2000] == 501);
+}
+
+// stack<T> по умолчанию стоит на ft::deque
+static void	test_stack(void)
+{
+	CHECK((ft::is_same<ft::stack<int>::container_type, ft::deque<int> >::value));
+
+	ft::stack<int>	stack;
+	ft::stack<int>	other;
+
+	for (int i = 0; i < 5000; i++)
+		stack.push(i);
+	CHECK(stack.size() == 5000 && stack.top() == 4999);
+	while (stack.size() > 10)
+		stack.pop();
+	CHECK(stack.top() == 9);
+	for (int i = 0; i < 10; i++)
+		other.push(i);
+	CHECK(stack == other && !(stack < other));
+	other.push(0);
+	CHECK(stack != other && stack < other && other > stack);
+}
+
+int	main(void)
+{
+	std::srand(31);
+	test_both_ends();
+	test_stable_references();
+	test_spare_chunks();
+	test_iterators();
+	test_stack();
+	return (test_result("deque"));
+}
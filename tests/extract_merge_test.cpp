@@ -0,0 +1,179 @@
+#include <map>
+#include <cstdlib>
+
+#include "map.hpp"
+#include "tracking_allocator.hpp"
+#include "test.hpp"
+
+typedef ft::tracking_allocator<ft::pair<const int, int> >					tracked;
+typedef ft::map<int, int, std::less<int>, tracked>							tracked_map;
+typedef std::map<int, int>													std_map;
+
+template <class Map>
+static bool	same(const Map & ft, const std_map & std)
+{
+	if (ft.size() != std.size())
+		return (false);
+
+	typename Map::const_iterator	it = ft.begin();
+
+	for (std_map::const_iterator jt = std.begin(); jt != std.end(); ++it, ++jt)
+		if (it->first != jt->first || it->second != jt->second)
+			return (false);
+	return (true);
+}
+
+// Узлы ходят между двумя map с общим аллокатором: ни одного выделения,
+// значение остается по тому же адресу, инварианты держатся после каждого шага
+static void	test_extract_insert(void)
+{
+	ft::allocation_stats	stats;
+	tracked_map				a((std::less<int>()), tracked(stats));
+	tracked_map				b((std::less<int>()), tracked(stats));
+	std_map					ref_a;
+	std_map					ref_b;
+
+	for (int i = 0; i < 2000; i++)
+	{
+		a[i] = i * 10;
+		ref_a[i] = i * 10;
+	}
+
+	std::size_t	allocations = stats.allocations;
+
+	for (int op = 0; op < 20000; op++)
+	{
+		bool			forward = std::rand() % 2;
+		tracked_map &	from = forward ? a : b;
+		tracked_map &	to = forward ? b : a;
+		std_map &		ref_from = forward ? ref_a : ref_b;
+		std_map &		ref_to = forward ? ref_b : ref_a;
+		int				key = std::rand() % 2000;
+		tracked_map::iterator	found = from.find(key);
+
+		if (found == from.end())
+		{
+			CHECK(from.extract(key).empty());
+			continue ;
+		}
+
+		const int *				address = &found->second;
+		tracked_map::node_type	node = std::rand() % 2 ? from.extract(found) : from.extract(key);
+
+		CHECK(!node.empty() && node.key() == key && node.mapped() == ref_from[key]);
+
+		ft::pair<tracked_map::iterator, bool>	inserted = to.insert(node);
+
+		CHECK(inserted.second && node.empty());
+		CHECK(&inserted.first->second == address);
+		ref_to[key] = ref_from[key];
+		ref_from.erase(key);
+		CHECK(ft::_test_access::valid_tree(a));
+		CHECK(ft::_test_access::valid_tree(b));
+	}
+	CHECK(stats.allocations == allocations);
+	CHECK(same(a, ref_a));
+	CHECK(same(b, ref_b));
+}
+
+// При совпадении ключа узел остается в handle и освобождается вместе с ним
+static void	test_insert_conflict(void)
+{
+	ft::allocation_stats	stats;
+	tracked_map				a((std::less<int>()), tracked(stats));
+	tracked_map				b((std::less<int>()), tracked(stats));
+
+	a[1] = 10;
+	b[1] = 20;
+	{
+		tracked_map::node_type	node = a.extract(a.begin());
+		tracked_map::iterator	kept = b.insert(b.end(), node);
+
+		CHECK(kept == b.begin() && kept->second == 20);
+		CHECK(!node.empty() && node.mapped() == 10);
+		CHECK(b[1] == 20 && a.empty());
+	}
+	CHECK(stats.allocations - stats.deallocations == 1);
+}
+
+// merge с общим аллокатором забирает узлы без выделений, конфликтующие
+// остаются в source; с разными аллокаторами значения копируются
+static void	test_merge(bool shared)
+{
+	ft::allocation_stats	stats_a;
+	ft::allocation_stats	stats_b;
+	tracked_map				a((std::less<int>()), tracked(stats_a));
+	tracked_map				b((std::less<int>()), tracked(shared ? stats_a : stats_b));
+	std_map					ref_a;
+	std_map					ref_b;
+
+	for (int i = 0; i < 5000; i++)
+	{
+		int		key = std::rand() % 8000;
+
+		if (std::rand() % 2)
+		{
+			a.insert(ft::make_pair(key, i));
+			ref_a.insert(std::make_pair(key, i));
+		}
+		else
+		{
+			b.insert(ft::make_pair(key, i));
+			ref_b.insert(std::make_pair(key, i));
+		}
+	}
+
+	std::size_t	allocations = stats_a.allocations;
+	std::size_t	deallocations = stats_b.deallocations;
+	std::size_t	size = a.size();
+
+	a.merge(b);
+	for (std_map::iterator it = ref_b.begin(); it != ref_b.end(); )
+		if (ref_a.insert(*it).second)
+			ref_b.erase(it++);
+		else
+			++it;
+
+	CHECK(ft::_test_access::valid_tree(a));
+	CHECK(ft::_test_access::valid_tree(b));
+	CHECK(same(a, ref_a));
+	CHECK(same(b, ref_b));
+	if (shared)
+		CHECK(stats_a.allocations == allocations);
+	else
+	{
+		CHECK(stats_a.allocations == allocations + (a.size() - size));
+		CHECK(stats_b.deallocations == deallocations + (a.size() - size));
+	}
+
+	a.merge(a);
+	CHECK(same(a, ref_a));
+}
+
+// Узел из map с другим аллокатором вставляется копией, handle пустеет
+static void	test_foreign_node(void)
+{
+	ft::allocation_stats	stats_a;
+	ft::allocation_stats	stats_b;
+	tracked_map				a((std::less<int>()), tracked(stats_a));
+	tracked_map				b((std::less<int>()), tracked(stats_b));
+
+	a[5] = 50;
+
+	tracked_map::node_type	node = a.extract(5);
+
+	CHECK(b.insert(node).second && node.empty());
+	CHECK(b[5] == 50 && stats_b.allocations == 1);
+	CHECK(stats_a.allocations == stats_a.deallocations);
+}
+
+int	main(void)
+{
+	std::srand(5);
+	test_extract_insert();
+	test_insert_conflict();
+	test_merge(true);
+	test_merge(false);
+	test_foreign_node();
+	return (test_result("extract_merge"));
+}
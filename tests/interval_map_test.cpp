@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <cstdlib>
+
+#include "interval_map.hpp"
+#include "test.hpp"
+
+typedef ft::interval_map<int, int>	intervals;
+
+struct Entry
+{
+	intervals::iterator	it;
+	int					lo;
+	int					hi;
+	int					id;
+};
+
+// Перебором: номера всех интервалов, пересекающих [lo, hi]
+static std::vector<int>	brute_overlapping(const std::vector<Entry> & entries, int lo, int hi)
+{
+	std::vector<int>	ids;
+
+	for (std::size_t i = 0; i < entries.size(); i++)
+		if (entries[i].lo <= hi && lo <= entries[i].hi)
+			ids.push_back(entries[i].id);
+	std::sort(ids.begin(), ids.end());
+	return (ids);
+}
+
+// Результат идет в порядке (lo, hi); номера сортируются для сравнения с перебором
+static std::vector<int>	found_ids(const intervals & map, int lo, int hi, bool stab)
+{
+	std::vector<intervals::const_iterator>	found;
+	std::vector<int>						ids;
+
+	if (stab)
+		map.stabbing(lo, std::back_inserter(found));
+	else
+		map.overlapping(lo, hi, std::back_inserter(found));
+	for (std::size_t i = 0; i < found.size(); i++)
+	{
+		if (i && found[i]->first < found[i - 1]->first)
+			ids.push_back(-1);
+		ids.push_back(found[i]->second);
+	}
+	std::sort(ids.begin(), ids.end());
+	return (ids);
+}
+
+// Случайные вставки и удаления: после каждого шага - красно-черные инварианты
+// и max_high, запросы сверяются с перебором
+static void	test_random(void)
+{
+	intervals			map;
+	std::vector<Entry>	entries;
+
+	for (int op = 0; op < 20000; op++)
+	{
+		int		kind = std::rand() % 8;
+
+		if (kind < 4 || entries.empty())
+		{
+			int		lo = std::rand() % 10000;
+			Entry	entry = { intervals::iterator(), lo, lo + std::rand() % (kind ? 50 : 2000), op };
+
+			entry.it = map.insert(entry.lo, entry.hi, entry.id);
+			entries.push_back(entry);
+		}
+		else if (kind < 6)
+		{
+			std::size_t	victim = std::rand() % entries.size();
+
+			map.erase(entries[victim].it);
+			entries[victim] = entries.back();
+			entries.pop_back();
+		}
+		else
+		{
+			int		lo = std::rand() % 10100 - 50;
+			int		hi = lo + std::rand() % 100;
+
+			CHECK(found_ids(map, lo, hi, false) == brute_overlapping(entries, lo, hi));
+			CHECK(found_ids(map, lo, lo, true) == brute_overlapping(entries, lo, lo));
+			CHECK(map.overlaps(lo, hi) == !brute_overlapping(entries, lo, hi).empty());
+		}
+		CHECK(map.size() == entries.size());
+		CHECK(ft::_test_access::valid_tree(map));
+		CHECK(ft::_test_access::valid_max_high(map));
+	}
+
+	intervals	copy(map);
+
+	CHECK(ft::_test_access::valid_max_high(copy));
+	CHECK(found_ids(copy, 0, 10100, false) == brute_overlapping(entries, 0, 10100));
+
+	// Присваивание самому себе ничего не теряет
+	intervals &	alias = copy;
+
+	copy = alias;
+	CHECK(copy.size() == entries.size());
+	CHECK(ft::_test_access::valid_tree(copy));
+	CHECK(ft::_test_access::valid_max_high(copy));
+	CHECK(found_ids(copy, 0, 10100, false) == brute_overlapping(entries, 0, 10100));
+}
+
+// Равные интервалы хранятся все, пустые и крайние запросы
+static void	test_edges(void)
+{
+	intervals			map;
+	std::vector<int>	none;
+
+	CHECK(found_ids(map, 0, 10, false) == none);
+	CHECK(!map.overlaps(0, 10));
+
+	map.insert(5, 10, 1);
+	map.insert(5, 10, 2);
+	map.insert(10, 10, 3);
+	map.insert(0, 4, 4);
+
+	int		touching[] = { 1, 2, 3 };
+
+	CHECK(found_ids(map, 10, 20, false) == std::vector<int>(touching, touching + 3));
+	CHECK(found_ids(map, 11, 20, false) == none);
+	CHECK(found_ids(map, 4, 4, true) == std::vector<int>(1, 4));
+	CHECK(map.overlaps(4, 5) && !map.overlaps(11, 100) && !map.overlaps(-5, -1));
+
+	intervals	other;
+
+	other.swap(map);
+	CHECK(map.empty() && other.size() == 4);
+	CHECK(ft::_test_access::valid_max_high(other));
+}
+
+int	main(void)
+{
+	std::srand(13);
+	test_random();
+	test_edges();
+	return (test_result("interval_map"));
+}
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <cstdlib>
+
+#include "map.hpp"
+#include "test.hpp"
+
+typedef ft::map<int, int>	ft_map;
+typedef std::map<int, int>	std_map;
+
+// std::set_* на std::map сравнивают пары целиком, а нужно только по ключу
+struct KeyLess
+{
+	bool	operator()(const std_map::value_type & lhd, const std_map::value_type & rhd)	const
+	{
+		return (lhd.first < rhd.first);
+	};
+};
+
+static bool	same(const ft_map & ft, const std_map & std)
+{
+	if (ft.size() != std.size())
+		return (false);
+
+	ft_map::const_iterator	it = ft.begin();
+
+	for (std_map::const_iterator jt = std.begin(); jt != std.end(); ++it, ++jt)
+		if (it->first != jt->first || it->second != jt->second)
+			return (false);
+	return (it == ft.end());
+}
+
+// Значения у a и b разные: по ним видно, из какой map взят общий ключ
+static void	fill(ft_map & ft, std_map & std, std::size_t n, int range, int sign)
+{
+	while (std.size() < n)
+	{
+		int		key = std::rand() % range;
+
+		ft.insert(ft::make_pair(key, sign * key));
+		std.insert(std::make_pair(key, sign * key));
+	}
+}
+
+// Все четыре операции против std::set_* (при совпадении ключей те же берут
+// значение из первого диапазона) в обоих порядках аргументов
+static void	check_ops(const ft_map & a, const std_map & ref_a, const ft_map & b, const std_map & ref_b)
+{
+	std_map		expected;
+	ft_map		result;
+
+	std::set_union(ref_a.begin(), ref_a.end(), ref_b.begin(), ref_b.end(), std::inserter(expected, expected.end()), KeyLess());
+	result = ft::map_union(a, b);
+	CHECK(same(result, expected) && ft::_test_access::valid_tree(result));
+
+	expected.clear();
+	std::set_intersection(ref_a.begin(), ref_a.end(), ref_b.begin(), ref_b.end(), std::inserter(expected, expected.end()), KeyLess());
+	result = ft::map_intersection(a, b);
+	CHECK(same(result, expected) && ft::_test_access::valid_tree(result));
+
+	expected.clear();
+	std::set_difference(ref_a.begin(), ref_a.end(), ref_b.begin(), ref_b.end(), std::inserter(expected, expected.end()), KeyLess());
+	result = ft::map_difference(a, b);
+	CHECK(same(result, expected) && ft::_test_access::valid_tree(result));
+
+	expected.clear();
+	std::set_symmetric_difference(ref_a.begin(), ref_a.end(), ref_b.begin(), ref_b.end(), std::inserter(expected, expected.end()), KeyLess());
+	result = ft::map_symmetric_difference(a, b);
+	CHECK(same(result, expected) && ft::_test_access::valid_tree(result));
+}
+
+static void	check_sizes(std::size_t n, std::size_t m, int range)
+{
+	ft_map		a;
+	ft_map		b;
+	std_map		ref_a;
+	std_map		ref_b;
+
+	fill(a, ref_a, n, range, 1);
+	fill(b, ref_b, m, range, -1);
+	check_ops(a, ref_a, b, ref_b);
+	check_ops(b, ref_b, a, ref_a);
+}
+
+// Размеры по обе стороны порога m * log2(n) < n: слияние обходов
+// и поэлементная правка копии большей map
+static void	test_against_std(void)
+{
+	std::size_t	sizes[][2] = {
+		{ 0, 0 }, { 0, 1 }, { 1, 1 }, { 0, 1000 }, { 1, 1000 },
+		{ 1000, 1000 }, { 500, 2000 }, { 100, 2000 }, { 10, 2000 },
+		{ 200, 20000 }, { 1000, 20000 }, { 1600, 20000 }
+	};
+
+	for (int i = 0; i < 12; i++)
+	{
+		check_sizes(sizes[i][0], sizes[i][1], static_cast<int>(sizes[i][1]) * 2 + 2);
+		// Малый диапазон ключей: почти все ключи меньшей map есть в большей
+		check_sizes(sizes[i][0], sizes[i][1], static_cast<int>(sizes[i][1]) + 1);
+	}
+}
+
+// Обе ветки действительно выбираются на этих размерах
+static void	test_thresholds(void)
+{
+	ft_map		small;
+	ft_map		large;
+	std_map		ref_small;
+	std_map		ref_large;
+
+	CHECK(!ft::_map_skewed(small, large));
+	fill(large, ref_large, 20000, 40000, 1);
+	fill(small, ref_small, 100, 40000, -1);
+	CHECK(ft::_map_skewed(small, large) && !ft::_map_skewed(large, small));
+	fill(small, ref_small, 2000, 40000, -1);
+	CHECK(!ft::_map_skewed(small, large) && !ft::_map_skewed(large, small));
+	check_ops(small, ref_small, large, ref_large);
+}
+
+int	main(void)
+{
+	std::srand(43);
+	test_against_std();
+	test_thresholds();
+	return (test_result("map_ops"));
+}
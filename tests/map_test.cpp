@@ -0,0 +1,254 @@
+#include <map>
+#include <vector>
+#include <cstdlib>
+
+#include "map.hpp"
+#include "test.hpp"
+
+// Случайные операции над ft::map и std::map с одинаковыми аргументами;
+// после каждой операции проверяются инварианты красно-черного дерева,
+// после каждого раунда - совпадение содержимого в обе стороны обхода
+
+typedef ft::map<int, int>	ft_map;
+typedef std::map<int, int>	std_map;
+
+static bool	same(const ft_map & ft, const std_map & std)
+{
+	if (ft.size() != std.size())
+		return (false);
+
+	ft_map::const_iterator		it = ft.begin();
+	std_map::const_iterator		jt = std.begin();
+
+	for (; jt != std.end(); ++it, ++jt)
+		if (it == ft.end() || it->first != jt->first || it->second != jt->second)
+			return (false);
+	if (it != ft.end())
+		return (false);
+
+	ft_map::const_reverse_iterator	rit = ft.rbegin();
+	std_map::const_reverse_iterator	rjt = std.rbegin();
+
+	for (; rjt != std.rend(); ++rit, ++rjt)
+		if (rit == ft.rend() || rit->first != rjt->first)
+			return (false);
+	return (rit == ft.rend());
+}
+
+static void	random_operation(ft_map & ft, std_map & std, int range, int op)
+{
+	int		key = std::rand() % range;
+	int		kind = std::rand() % 10;
+
+	if (kind < 3)
+		CHECK(ft.insert(ft::make_pair(key, op)).second == std.insert(std::make_pair(key, op)).second);
+	else if (kind < 4)
+	{
+		ft.insert(ft.lower_bound(key), ft::make_pair(key, op));
+		std.insert(std.lower_bound(key), std::make_pair(key, op));
+	}
+	else if (kind < 7)
+		CHECK(ft.erase(key) == std.erase(key));
+	else if (kind < 8)
+	{
+		ft[key] += op;
+		std[key] += op;
+	}
+	else if (kind < 9)
+	{
+		ft_map::iterator	found = ft.find(key);
+
+		CHECK((found == ft.end()) == (std.find(key) == std.end()));
+		if (found != ft.end())
+		{
+			ft.erase(found);
+			std.erase(key);
+		}
+	}
+	else
+	{
+		ft.erase(ft.lower_bound(key), ft.upper_bound(key + range / 16));
+		std.erase(std.lower_bound(key), std.upper_bound(key + range / 16));
+	}
+}
+
+static void	test_random_operations(void)
+{
+	for (int round = 0; round < 200; round++)
+	{
+		ft_map		ft;
+		std_map		std;
+		int			range = 1 + std::rand() % 500;
+
+		for (int op = 0; op < 1000; op++)
+		{
+			random_operation(ft, std, range, op);
+			CHECK(ft::_test_access::valid_tree(ft));
+		}
+		CHECK(same(ft, std));
+
+		for (int key = -1; key <= range; key++)
+		{
+			CHECK(ft.count(key) == std.count(key));
+			CHECK((ft.lower_bound(key) == ft.end()) == (std.lower_bound(key) == std.end()));
+			CHECK((ft.upper_bound(key) == ft.end()) == (std.upper_bound(key) == std.end()));
+		}
+
+		ft_map		copy(ft);
+		ft_map		assigned;
+
+		CHECK(ft::_test_access::valid_tree(copy));
+		CHECK(same(copy, std));
+		assigned.insert(ft::make_pair(range + 1, 0));
+		assigned = copy;
+		CHECK(ft::_test_access::valid_tree(assigned));
+		CHECK(same(assigned, std));
+
+		// Присваивание самому себе не очищает дерево
+		ft_map &	alias = assigned;
+
+		assigned = alias;
+		CHECK(ft::_test_access::valid_tree(assigned));
+		CHECK(same(assigned, std));
+
+		ft_map		swapped;
+
+		swapped.swap(assigned);
+		CHECK(same(swapped, std));
+		CHECK(assigned.empty());
+	}
+}
+
+static void	test_sequential_keys(void)
+{
+	ft_map		ft;
+	std_map		std;
+
+	for (int i = 0; i < 100000; i++)
+	{
+		ft.insert(ft::make_pair(i, i));
+		std.insert(std::make_pair(i, i));
+	}
+	CHECK(ft::_test_access::valid_tree(ft));
+	for (int i = 0; i < 100000; i += 3)
+	{
+		ft.erase(i);
+		std.erase(i);
+	}
+	CHECK(ft::_test_access::valid_tree(ft));
+	CHECK(same(ft, std));
+}
+
+// Записывает ключи по порядку и останавливает обход после limit элементов;
+// неконстантный обход может менять значения, константный - только читает
+struct Visit
+{
+	std::vector<int>	keys;
+	std::size_t			limit;
+	std::size_t			const_calls;
+
+	Visit(std::size_t limit = static_cast<std::size_t>(-1)) : limit(limit), const_calls(0) {};
+
+	bool	operator()(ft_map::value_type & value)
+	{
+		value.second++;
+		this->keys.push_back(value.first);
+		return (this->keys.size() < this->limit);
+	};
+
+	bool	operator()(const ft_map::value_type & value)
+	{
+		this->const_calls++;
+		this->keys.push_back(value.first);
+		return (this->keys.size() < this->limit);
+	};
+};
+
+static std::vector<int>	expected_keys(const std_map & std, int lo, int hi, std::size_t limit)
+{
+	std::vector<int>	keys;
+
+	if (lo > hi)
+		return (keys);
+	for (std_map::const_iterator it = std.lower_bound(lo); it != std.upper_bound(hi) && keys.size() < limit; ++it)
+		keys.push_back(it->first);
+	return (keys);
+}
+
+// for_each и for_each_in_range против обхода std::map: весь диапазон,
+// границы есть в map и нет, lo > hi, остановка после limit элементов
+static void	test_for_each(void)
+{
+	ft_map				ft;
+	std_map				std;
+	const ft_map &		const_ft = ft;
+
+	CHECK(ft.for_each(Visit()).keys.empty());
+	CHECK(const_ft.for_each_in_range(0, 10, Visit()).keys.empty());
+	for (int i = 0; i < 2000; i++)
+	{
+		int		key = std::rand() % 10000;
+
+		ft.insert(ft::make_pair(key, 0));
+		std.insert(std::make_pair(key, 0));
+	}
+
+	Visit	all = ft.for_each(Visit());
+
+	CHECK(all.keys == expected_keys(std, -1, 10000, all.limit) && all.const_calls == 0);
+	for (std_map::iterator it = std.begin(); it != std.end(); ++it)
+		it->second++;
+	CHECK(same(ft, std));
+
+	Visit	read = const_ft.for_each(Visit());
+
+	CHECK(read.keys == all.keys && read.const_calls == std.size());
+	CHECK(same(ft, std));
+
+	std::size_t	limits[] = { 1, 2, 17, std.size() - 1, std.size(), std.size() + 1 };
+
+	for (int l = 0; l < 6; l++)
+	{
+		std::vector<int>	keys = expected_keys(std, -1, 10000, limits[l]);
+
+		CHECK(ft.for_each(Visit(limits[l])).keys == keys);
+		CHECK(const_ft.for_each(Visit(limits[l])).keys == keys);
+		for (std::size_t i = 0; i < keys.size(); i++)
+			std[keys[i]]++;
+	}
+	for (int round = 0; round < 2000; round++)
+	{
+		int				lo = std::rand() % 10400 - 200;
+		int				hi = round % 3 ? lo + std::rand() % 500 : std::rand() % 10400 - 200;
+		std::size_t		limit = round % 4 ? all.limit : std::rand() % 20 + 1;
+
+		if (round % 5 == 0)
+			lo = std.lower_bound(lo) == std.end() ? lo : std.lower_bound(lo)->first;
+		if (round % 7 == 0)
+			hi = lo;
+
+		Visit	range = const_ft.for_each_in_range(lo, hi, Visit(limit));
+
+		CHECK(range.keys == expected_keys(std, lo, hi, limit));
+		CHECK(range.const_calls == range.keys.size());
+	}
+	CHECK(same(ft, std));
+	CHECK(ft.for_each_in_range(5000, 4999, Visit()).keys.empty());
+	CHECK(ft.for_each_in_range(-100, -1, Visit()).keys.empty());
+
+	Visit	middle = ft.for_each_in_range(2500, 7499, Visit());
+
+	for (std_map::iterator it = std.lower_bound(2500); it != std.upper_bound(7499); ++it)
+		it->second++;
+	CHECK(middle.keys == expected_keys(std, 2500, 7499, middle.limit) && middle.const_calls == 0);
+	CHECK(same(ft, std));
+}
+
+int	main(void)
+{
+	std::srand(42);
+	test_random_operations();
+	test_sequential_keys();
+	test_for_each();
+	return (test_result("map"));
+}
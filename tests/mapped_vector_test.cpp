@@ -0,0 +1,65 @@
+#include <stdexcept>
+#include <unistd.h>
+
+#include "mapped_vector.hpp"
+#include "test.hpp"
+
+static const char *	g_path = "tests/mapped_vector_test.data";
+
+static void	test_round_trip(void)
+{
+	{
+		ft::mapped_vector<int>	out(g_path, ft::mapped_vector<int>::truncate);
+
+		for (int i = 0; i < 1000; i++)
+			out.push_back(i * 3);
+		CHECK(out.capacity() > out.size());
+		out.close();
+		CHECK(!out.is_open() && out.size() == 0 && out.data() == NULL);
+		out.close();
+	}
+
+	ft::mapped_vector<int>	in(g_path, ft::mapped_vector<int>::read_only);
+
+	CHECK(in.size() == 1000 && in.capacity() == 1000);
+	for (int i = 0; i < 1000; i++)
+		CHECK(in[i] == i * 3);
+	CHECK_THROWS(in.push_back(0), std::logic_error);
+}
+
+// Каталог открывается и проходит fstat, но не отображается: дескриптор
+// должен закрыться, объект - остаться пустым и пригодным для open()
+static void	test_failed_open(void)
+{
+	ft::mapped_vector<int>	vec;
+
+	CHECK_THROWS(vec.open("tests", ft::mapped_vector<int>::read_only), std::runtime_error);
+	CHECK(!vec.is_open() && vec.size() == 0 && vec.data() == NULL);
+
+	vec.open(g_path, ft::mapped_vector<int>::read_write);
+	CHECK(vec.is_open() && vec.size() == 1000);
+}
+
+// Пустой файл не отображен (_values == NULL): resize только расширяет файл
+static void	test_resize_empty(void)
+{
+	ft::mapped_vector<int>	vec(g_path, ft::mapped_vector<int>::truncate);
+
+	CHECK(vec.size() == 0 && vec.data() == NULL);
+	vec.resize(10);
+	CHECK(vec.size() == 10 && vec.capacity() >= 10);
+	for (int i = 0; i < 10; i++)
+		CHECK(vec[i] == 0);
+	vec.resize(3);
+	vec.resize(5);
+	CHECK(vec.size() == 5 && vec[3] == 0 && vec[4] == 0);
+}
+
+int	main(void)
+{
+	test_round_trip();
+	test_failed_open();
+	test_resize_empty();
+	unlink(g_path);
+	return (test_result("mapped_vector"));
+}
@@ -0,0 +1,240 @@
+#include <map>
+#include <cstdlib>
+
+#include "memory_resource.hpp"
+#include "test.hpp"
+
+// upstream со счетчиками поверх new_delete_resource: освобождение должно
+// приходить с теми же размером и выравниванием, что и выделение
+class CountingResource : public ft::memory_resource
+{
+	public:
+		std::size_t	allocations;
+		std::size_t	live_bytes;
+		std::size_t	last_bytes;
+
+		CountingResource(void) : allocations(0), live_bytes(0), last_bytes(0) {};
+
+	protected:
+		void *	do_allocate(std::size_t bytes, std::size_t alignment)
+		{
+			this->allocations++;
+			this->live_bytes += bytes;
+			this->last_bytes = bytes;
+			return (ft::new_delete_resource()->allocate(bytes, alignment));
+		};
+
+		void	do_deallocate(void * p, std::size_t bytes, std::size_t alignment)
+		{
+			this->live_bytes -= bytes;
+			ft::new_delete_resource()->deallocate(p, bytes, alignment);
+		};
+};
+
+static bool	aligned(void * p, std::size_t alignment)
+{
+	return (reinterpret_cast<std::size_t>(p) % alignment == 0);
+}
+
+// Выравнивание сверх max_align: и из текущего куска, и из нового, и крупным блоком
+static void	test_over_alignment(void)
+{
+	CountingResource						upstream;
+	ft::monotonic_buffer_resource			arena(&upstream);
+	ft::unsynchronized_pool_resource		pool(&upstream);
+	std::size_t								alignments[] = { 64, 256, 4096 };
+
+	for (int i = 0; i < 3; i++)
+	{
+		std::size_t	alignment = alignments[i];
+
+		CHECK(alignment > ft::memory_resource::max_align);
+		for (std::size_t bytes = 1; bytes < 20000; bytes = bytes * 3 + 1)
+		{
+			void *	a = arena.allocate(bytes, alignment);
+			void *	b = pool.allocate(bytes, alignment);
+			void *	c = ft::new_delete_resource()->allocate(bytes, alignment);
+
+			CHECK(aligned(a, alignment) && aligned(b, alignment) && aligned(c, alignment));
+			arena.allocate(1, 1);
+			pool.deallocate(b, bytes, alignment);
+			ft::new_delete_resource()->deallocate(c, bytes, alignment);
+		}
+	}
+	pool.release();
+	arena.release();
+	CHECK(upstream.live_bytes == 0);
+}
+
+// release() возвращает все куски и начинает снова с начального буфера,
+// а следующий кусок upstream снова первого размера
+static void	test_monotonic_release(void)
+{
+	CountingResource				upstream;
+	char							buffer[256];
+	ft::monotonic_buffer_resource	arena(buffer, sizeof(buffer), &upstream);
+
+	for (int round = 0; round < 3; round++)
+	{
+		upstream.allocations = 0;
+		CHECK(arena.allocate(100, 8) == buffer);
+		CHECK(upstream.allocations == 0);
+		arena.allocate(200, 8);
+		CHECK(upstream.allocations == 1);
+		CHECK(upstream.last_bytes == 2 * sizeof(buffer));
+		for (int i = 0; i < 100; i++)
+			arena.allocate(64, 16);
+		CHECK(upstream.live_bytes > 0);
+		arena.release();
+		CHECK(upstream.live_bytes == 0);
+	}
+}
+
+// Крупные блоки снимаются из двусвязного списка из середины, с головы и с хвоста;
+// release() освобождает только оставшиеся
+static void	test_pool_large_blocks(void)
+{
+	CountingResource					upstream;
+	ft::unsynchronized_pool_resource	pool(&upstream, 16, 1024);
+	void *								blocks[5];
+	std::size_t							sizes[5] = { 2000, 3000, 5000, 8000, 13000 };
+
+	for (int i = 0; i < 5; i++)
+		blocks[i] = pool.allocate(sizes[i]);
+	CHECK(upstream.allocations == 5);
+
+	std::size_t	live = upstream.live_bytes;
+
+	pool.deallocate(blocks[2], sizes[2]);
+	CHECK(upstream.live_bytes < live);
+	live = upstream.live_bytes;
+	pool.deallocate(blocks[4], sizes[4]);
+	CHECK(upstream.live_bytes < live);
+	live = upstream.live_bytes;
+	pool.deallocate(blocks[0], sizes[0]);
+	CHECK(upstream.live_bytes < live);
+
+	blocks[2] = pool.allocate(sizes[2]);
+	pool.deallocate(blocks[1], sizes[1]);
+	pool.release();
+	CHECK(upstream.live_bytes == 0);
+
+	void *	small = pool.allocate(24);
+
+	pool.deallocate(small, 24);
+	CHECK(pool.allocate(24) == small);
+}
+
+typedef ft::pmr::map<int, int>::type	pmr_map;
+typedef ft::pmr::vector<int>::type		pmr_vector;
+typedef std::map<int, int>				std_map;
+
+static bool	same(const pmr_map & ft, const std_map & std)
+{
+	if (ft.size() != std.size())
+		return (false);
+
+	pmr_map::const_iterator	it = ft.begin();
+
+	for (std_map::const_iterator jt = std.begin(); jt != std.end(); ++it, ++jt)
+		if (it->first != jt->first || it->second != jt->second)
+			return (false);
+	return (it == ft.end());
+}
+
+// Случайные вставки и удаления в pmr::map и pmr::vector на ресурсе,
+// копии наследуют ресурс; освобожденное остается у ресурса до release()
+static void	round_trip(ft::memory_resource & resource, CountingResource & upstream)
+{
+	typedef ft::polymorphic_allocator<ft::pair<const int, int> >	map_allocator;
+
+	{
+		pmr_map		map((std::less<int>()), map_allocator(&resource));
+		pmr_vector	vec((ft::polymorphic_allocator<int>(&resource)));
+		std_map		ref;
+
+		for (int op = 0; op < 20000; op++)
+		{
+			int		key = std::rand() % 2000;
+
+			if (std::rand() % 3)
+			{
+				map[key] = op;
+				ref[key] = op;
+				vec.push_back(key);
+			}
+			else
+			{
+				CHECK(map.erase(key) == ref.erase(key));
+				if (!vec.empty())
+					vec.pop_back();
+			}
+		}
+		CHECK(same(map, ref));
+		CHECK(ft::_test_access::valid_tree(map));
+
+		pmr_map		copy(map);
+		pmr_vector	vec_copy(vec);
+
+		CHECK(*copy.get_allocator().resource() == resource && *vec_copy.get_allocator().resource() == resource);
+		CHECK(same(copy, ref) && vec_copy == vec);
+		vec.resize(50000, 7);
+		vec.clear();
+		map.clear();
+		CHECK(same(copy, ref));
+	}
+	CHECK(upstream.live_bytes > 0);
+}
+
+static void	test_containers(void)
+{
+	CountingResource	upstream;
+
+	{
+		ft::monotonic_buffer_resource	arena(&upstream);
+
+		round_trip(arena, upstream);
+		arena.release();
+		CHECK(upstream.live_bytes == 0);
+		round_trip(arena, upstream);
+	}
+	CHECK(upstream.live_bytes == 0);
+	{
+		ft::unsynchronized_pool_resource	pool(&upstream);
+
+		round_trip(pool, upstream);
+		pool.release();
+		CHECK(upstream.live_bytes == 0);
+		round_trip(pool, upstream);
+	}
+	CHECK(upstream.live_bytes == 0);
+}
+
+static void	test_allocator_equality(void)
+{
+	ft::monotonic_buffer_resource		arena;
+	ft::unsynchronized_pool_resource	pool;
+	ft::polymorphic_allocator<int>		on_arena(&arena);
+	ft::polymorphic_allocator<long>		also_on_arena(&arena);
+	ft::polymorphic_allocator<int>		on_pool(&pool);
+
+	CHECK(on_arena == also_on_arena && on_arena != on_pool);
+
+	ft::memory_resource *	previous = ft::set_default_resource(&pool);
+
+	CHECK(ft::polymorphic_allocator<int>() == on_pool);
+	CHECK(ft::set_default_resource(NULL) == &pool);
+	CHECK(ft::get_default_resource() == ft::new_delete_resource());
+	ft::set_default_resource(previous);
+}
+
+int	main(void)
+{
+	std::srand(41);
+	test_over_alignment();
+	test_monotonic_release();
+	test_pool_large_blocks();
+	test_containers();
+	test_allocator_equality();
+	return (test_result("memory_resource"));
+}
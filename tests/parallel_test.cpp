@@ -0,0 +1,186 @@
+#include <new>
+#include <stdexcept>
+
+#include "parallel.hpp"
+#include "vector.hpp"
+#include "test.hpp"
+
+static const std::size_t	g_count = 100000;
+
+struct Twice
+{
+	long	operator()(long x)	const
+	{
+		return (x * 2);
+	};
+};
+
+// reduce внутри задачи пула: run там идет последовательно одним куском
+struct NestedReduce
+{
+	ft::parallel::thread_pool &		pool;
+	const ft::vector<long> &		values;
+	long *							results;
+
+	void	operator()(std::size_t begin, std::size_t end)
+	{
+		for (; begin < end; begin++)
+			this->results[begin] = ft::parallel::reduce(this->values.begin(), this->values.end(), 5L,
+				ft::parallel::_plus<long>(), this->pool);
+	};
+};
+
+static void	test_reduce(ft::parallel::thread_pool & pool)
+{
+	ft::vector<long>	ones(g_count, 1);
+
+	CHECK(ft::parallel::reduce(ones.begin(), ones.end(), 5L, ft::parallel::_plus<long>(), pool) == 100005);
+	CHECK(ft::parallel::reduce(ones.begin(), ones.begin(), 5L, ft::parallel::_plus<long>(), pool) == 5);
+	CHECK(ft::parallel::reduce(ones.begin(), ones.begin() + 1, 5L, ft::parallel::_plus<long>(), pool) == 6);
+
+	long			results[8];
+	NestedReduce	body = { pool, ones, results };
+
+	pool.run(8, 1, body);
+	for (int i = 0; i < 8; i++)
+		CHECK(results[i] == 100005);
+}
+
+static void	test_transform(ft::parallel::thread_pool & pool)
+{
+	ft::vector<long>	values(g_count);
+	ft::vector<long>	doubled(g_count);
+
+	for (std::size_t i = 0; i < g_count; i++)
+		values[i] = i;
+	ft::parallel::transform(values.begin(), values.end(), doubled.begin(), Twice(), pool);
+
+	bool	same = true;
+
+	for (std::size_t i = 0; i < g_count; i++)
+		same = same && doubled[i] == static_cast<long>(i * 2);
+	CHECK(same);
+}
+
+// Бросает на одном элементе: bad_alloc на нечетном, logic_error на четном
+struct ThrowAt
+{
+	long	victim;
+
+	void	operator()(long x)	const
+	{
+		if (x != this->victim)
+			return ;
+		if (x % 2)
+			throw std::bad_alloc();
+		throw std::logic_error("victim");
+	};
+};
+
+// Бросает в каждом куске: часть кусков достается вызывающему потоку, часть - пулу
+struct ThrowAlways
+{
+	void	operator()(std::size_t, std::size_t)
+	{
+		throw std::logic_error("chunk");
+	};
+};
+
+// Исключение из тела не роняет процесс и не оставляет пул занятым:
+// следующий запуск на том же пуле отрабатывает целиком
+static void	test_exceptions(ft::parallel::thread_pool & pool)
+{
+	ft::vector<long>	values(g_count);
+	ThrowAt				odd = { 777 };
+	ThrowAt				even = { g_count - 2 };
+
+	for (std::size_t i = 0; i < g_count; i++)
+		values[i] = i;
+	CHECK_THROWS(ft::parallel::for_each(values.begin(), values.end(), odd, pool), std::bad_alloc);
+	CHECK_THROWS(ft::parallel::for_each(values.begin(), values.end(), even, pool), std::runtime_error);
+	CHECK(ft::parallel::reduce(values.begin(), values.end(), 0L, ft::parallel::_plus<long>(), pool)
+		== static_cast<long>(g_count * (g_count - 1) / 2));
+
+	for (int round = 0; round < 20; round++)
+	{
+		ThrowAlways	body;
+		bool		thrown = false;
+
+		try
+		{
+			pool.run(g_count, 1000, body);
+		}
+		catch (std::logic_error &)
+		{
+			thrown = true;
+		}
+		catch (std::runtime_error &)
+		{
+			thrown = true;
+		}
+		CHECK(thrown);
+	}
+	test_transform(pool);
+}
+
+struct Pair
+{
+	int		key;
+	int		seq;
+};
+
+struct PairLess
+{
+	bool	operator()(const Pair & lhd, const Pair & rhd)	const
+	{
+		return (lhd.key < rhd.key);
+	};
+};
+
+// sort_unique: ключи по возрастанию без повторов, из равных остается
+// самый ранний во входе - и на одном куске, и после слияний
+static void	test_sort_unique(ft::parallel::thread_pool & pool)
+{
+	std::size_t	sizes[] = { 0, 1, 1000, g_count };
+
+	for (int s = 0; s < 4; s++)
+	{
+		ft::vector<Pair>	items;
+		ft::vector<int>		first_seq(sizes[s] / 4 + 1, -1);
+
+		for (std::size_t i = 0; i < sizes[s]; i++)
+		{
+			Pair	item = { static_cast<int>((i * 7919) % (sizes[s] / 4 + 1)), static_cast<int>(i) };
+
+			if (first_seq[item.key] < 0)
+				first_seq[item.key] = item.seq;
+			items.push_back(item);
+		}
+
+		std::size_t	n = ft::parallel::sort_unique(items, PairLess(), pool);
+		bool		ordered = true;
+		std::size_t	distinct = 0;
+
+		for (std::size_t k = 0; k < first_seq.size(); k++)
+			distinct += first_seq[k] >= 0;
+		for (std::size_t i = 0; i < n; i++)
+			ordered = ordered && (!i || items[i - 1].key < items[i].key) && items[i].seq == first_seq[items[i].key];
+		CHECK(n == distinct && ordered);
+	}
+}
+
+int	main(void)
+{
+	ft::parallel::thread_pool	sequential(1);
+	ft::parallel::thread_pool	pool(4);
+
+	test_reduce(sequential);
+	test_reduce(pool);
+	test_transform(sequential);
+	test_transform(pool);
+	test_exceptions(sequential);
+	test_exceptions(pool);
+	test_sort_unique(sequential);
+	test_sort_unique(pool);
+	return (test_result("parallel"));
+}
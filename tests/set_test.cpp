@@ -0,0 +1,122 @@
+#include <set>
+#include <cstdlib>
+
+#include "set.hpp"
+#include "test.hpp"
+
+// Случайные вставки и удаления в ft::set/multiset и std::set/multiset;
+// инварианты дерева проверяются после каждой операции
+
+template <class Ft, class Std>
+static bool	same(const Ft & ft, const Std & std)
+{
+	if (ft.size() != std.size())
+		return (false);
+
+	typename Ft::const_iterator		it = ft.begin();
+
+	for (typename Std::const_iterator jt = std.begin(); jt != std.end(); ++it, ++jt)
+		if (it == ft.end() || *it != *jt)
+			return (false);
+	return (it == ft.end());
+}
+
+template <class Ft, class Std>
+static void	run_random(void)
+{
+	for (int round = 0; round < 100; round++)
+	{
+		Ft		ft;
+		Std		std;
+		int		range = 1 + std::rand() % 300;
+
+		for (int op = 0; op < 1000; op++)
+		{
+			int		key = std::rand() % range;
+			int		kind = std::rand() % 8;
+
+			if (kind < 3)
+			{
+				ft.insert(key);
+				std.insert(key);
+			}
+			else if (kind < 4)
+			{
+				ft.insert(ft.lower_bound(key), key);
+				std.insert(std.lower_bound(key), key);
+			}
+			else if (kind < 6)
+				CHECK(ft.erase(key) == std.erase(key));
+			else if (kind < 7)
+			{
+				CHECK(ft.count(key) == std.count(key));
+				CHECK((ft.find(key) == ft.end()) == (std.find(key) == std.end()));
+			}
+			else
+			{
+				ft.erase(ft.lower_bound(key), ft.upper_bound(key + range / 16));
+				std.erase(std.lower_bound(key), std.upper_bound(key + range / 16));
+			}
+			CHECK(ft::_test_access::valid_tree(ft));
+		}
+		CHECK(same(ft, std));
+
+		Ft		copy(ft);
+
+		CHECK(ft::_test_access::valid_tree(copy));
+		CHECK(copy == ft);
+	}
+}
+
+template <class Set>
+static void	check_order(const Set & a, const Set & b, bool less, bool equal)
+{
+	CHECK((a == b) == equal);
+	CHECK((a != b) == !equal);
+	CHECK((a < b) == less);
+	CHECK((a > b) == (!less && !equal));
+	CHECK((a <= b) == (less || equal));
+	CHECK((a >= b) == !less);
+}
+
+static void	test_comparisons(void)
+{
+	int				values[] = { 1, 2, 3 };
+	ft::set<int>	abc(values, values + 3);
+	ft::set<int>	ab(values, values + 2);
+	ft::set<int>	same_abc(abc);
+	ft::set<int>	empty;
+
+	check_order(abc, same_abc, false, true);
+	check_order(ab, abc, true, false);
+	check_order(abc, ab, false, false);
+	check_order(empty, ab, true, false);
+	check_order(empty, ft::set<int>(), false, true);
+
+	int					repeated[] = { 1, 1, 2 };
+	ft::multiset<int>	twice(repeated, repeated + 3);
+	ft::multiset<int>	once(repeated + 1, repeated + 3);
+
+	check_order(twice, once, true, false);
+	check_order(once, twice, false, false);
+	check_order(twice, ft::multiset<int>(twice), false, true);
+
+	// Присваивание самому себе не очищает дерево
+	ft::set<int> &		abc_alias = abc;
+	ft::multiset<int> &	twice_alias = twice;
+
+	abc = abc_alias;
+	twice = twice_alias;
+	check_order(abc, same_abc, false, true);
+	check_order(twice, ft::multiset<int>(repeated, repeated + 3), false, true);
+	CHECK(ft::_test_access::valid_tree(abc) && ft::_test_access::valid_tree(twice));
+}
+
+int	main(void)
+{
+	std::srand(7);
+	run_random<ft::set<int>, std::set<int> >();
+	run_random<ft::multiset<int>, std::multiset<int> >();
+	test_comparisons();
+	return (test_result("set"));
+}
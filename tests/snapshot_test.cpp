@@ -0,0 +1,173 @@
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "vector.hpp"
+#include "map.hpp"
+#include "snapshot.hpp"
+#include "tracking_allocator.hpp"
+#include "test.hpp"
+
+// Нетривиальный тип со своей специализацией serializer
+struct Name
+{
+	std::string	text;
+};
+
+namespace ft
+{
+	template <>
+	struct serializer<Name>
+	{
+		static void	write(snapshot_writer & out, const Name & value)
+		{
+			uint32_t	size = static_cast<uint32_t>(value.text.size());
+
+			out.write(&size, sizeof(size));
+			out.write(value.text.data(), size);
+		};
+
+		static Name	read(snapshot_reader & in)
+		{
+			uint32_t	size;
+			Name		value;
+
+			in.read(&size, sizeof(size));
+			value.text.resize(size);
+			if (size)
+				in.read(&value.text[0], size);
+			return (value);
+		};
+	};
+}
+
+static void	test_trivial_vector(void)
+{
+	ft::vector<int>		out;
+	ft::vector<int>		in(3, 7);
+	std::stringstream	stream;
+
+	for (int i = 0; i < 300000; i++)
+		out.push_back(i * 7);
+	out.save(stream);
+	in.load(stream);
+	CHECK(in.size() == out.size());
+	CHECK(in == out);
+}
+
+static void	test_serialized_vector(void)
+{
+	ft::vector<Name>	out(100);
+	ft::vector<Name>	in;
+	std::stringstream	stream;
+
+	for (std::size_t i = 0; i < out.size(); i++)
+		out[i].text = std::string(i % 7, 'a' + i % 26);
+	out.save(stream);
+	in.load(stream);
+	CHECK(in.size() == out.size());
+	for (std::size_t i = 0; i < out.size() && i < in.size(); i++)
+		CHECK(in[i].text == out[i].text);
+}
+
+// Испорченный снимок отвергается, а содержимое приемника не меняется
+static void	test_corrupted_vector(void)
+{
+	ft::vector<int>		out(1000, 1);
+	ft::vector<int>		in(5, 2);
+	std::stringstream	stream;
+
+	out.save(stream);
+
+	std::string		bytes = stream.str();
+
+	bytes[bytes.size() / 2] ^= 1;
+
+	std::stringstream	corrupted(bytes);
+
+	CHECK_THROWS(in.load(corrupted), ft::snapshot_error);
+	CHECK(in == ft::vector<int>(5, 2));
+}
+
+static void	test_map(void)
+{
+	ft::map<int, double>	out;
+	ft::map<int, double>	in;
+	std::stringstream		stream;
+
+	for (int i = 0; i < 10000; i++)
+		out[i * 3] = i / 2.0;
+	out.save(stream);
+	in.load(stream);
+	CHECK(in.size() == out.size());
+	CHECK(ft::_test_access::valid_tree(in));
+
+	ft::map<int, double>::iterator	it = in.begin();
+
+	for (int i = 0; i < 10000 && it != in.end(); i++, ++it)
+		CHECK(it->first == i * 3 && it->second == i / 2.0);
+}
+
+// Копия бросает после g_copies успешных (g_copies < 0 - без ограничений)
+static int	g_copies = -1;
+
+struct Fragile
+{
+	int		value;
+
+	Fragile(int value = 0) : value(value) {};
+
+	Fragile(const Fragile & src) : value(src.value)
+	{
+		if (!g_copies)
+			throw std::runtime_error("copy");
+		if (g_copies > 0)
+			g_copies--;
+	};
+};
+
+// Сборка по отсортированному входу падает на каждой копии по очереди:
+// ни одного узла не остается ни построенным, ни просто выделенным
+static void	test_build_failure(void)
+{
+	typedef ft::pair<const int, Fragile>										value_type;
+	typedef ft::map<int, Fragile, std::less<int>, ft::tracking_allocator<value_type> >	fragile_map;
+
+	ft::vector<ft::pair<int, Fragile> >	sorted;
+
+	for (int i = 0; i < 50; i++)
+		sorted.push_back(ft::make_pair(i, Fragile(i)));
+	for (int budget = 0; ; budget++)
+	{
+		ft::allocation_stats	stats;
+		bool					thrown = false;
+
+		g_copies = budget;
+		try
+		{
+			fragile_map	built(ft::sorted_unique, sorted.begin(), sorted.end(), std::less<int>(),
+				ft::tracking_allocator<value_type>(stats));
+
+			g_copies = -1;
+			CHECK(built.size() == 50 && ft::_test_access::valid_tree(built));
+		}
+		catch (const std::runtime_error &)
+		{
+			thrown = true;
+		}
+		g_copies = -1;
+		CHECK(stats.allocations == stats.deallocations && stats.live_bytes == 0);
+		if (!thrown)
+			break ;
+	}
+}
+
+int	main(void)
+{
+	test_trivial_vector();
+	test_serialized_vector();
+	test_corrupted_vector();
+	test_map();
+	test_build_failure();
+	return (test_result("snapshot"));
+}
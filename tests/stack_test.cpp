@@ -0,0 +1,88 @@
+#include <deque>
+#include <iterator>
+#include <list>
+#include <vector>
+
+#include "stack.hpp"
+#include "vector.hpp"
+#include "tracking_allocator.hpp"
+#include "test.hpp"
+
+// Одни и те же пачечные операции на контейнерах с reserve и произвольным
+// доступом (ft::vector, ft::deque), без reserve (std::deque) и на списке,
+// где остается цикл push_back/pop_back
+template <class Container>
+static void	check_bulk(void)
+{
+	ft::stack<int, Container>	stack;
+	int							values[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	std::list<int>				more(values, values + 4);
+	std::vector<int>			top;
+
+	stack.reserve(100);
+	CHECK(stack.empty());
+	stack.push(0);
+	stack.push_range(values, values + 8);
+	stack.push_range(more.begin(), more.end());
+	stack.push_range(values, values);
+	CHECK(stack.size() == 13 && stack.top() == 4);
+
+	stack.top_n(3, std::back_inserter(top));
+	CHECK(top.size() == 3 && top[0] == 4 && top[1] == 3 && top[2] == 2);
+	top.clear();
+	stack.top_n(0, std::back_inserter(top));
+	CHECK(top.empty());
+
+	stack.pop_n(0);
+	CHECK(stack.size() == 13 && stack.top() == 4);
+	stack.pop_n(4);
+	CHECK(stack.size() == 9 && stack.top() == 8);
+	stack.top_n(100, std::back_inserter(top));
+	CHECK(top.size() == 9 && top[0] == 8 && top[8] == 0);
+	stack.pop_n(stack.size());
+	CHECK(stack.empty());
+	stack.push_range(values, values + 3);
+	stack.pop_n(10);
+	CHECK(stack.empty());
+	stack.pop_n(1);
+	CHECK(stack.empty());
+}
+
+typedef ft::tracking_allocator<int>		tracked;
+
+// reserve заранее выделяет место, пачка на vector - не больше одного выделения
+static void	test_reserve(void)
+{
+	ft::allocation_stats						stats;
+	ft::stack<int, ft::vector<int, tracked> >	stack((ft::vector<int, tracked>(tracked(stats))));
+	ft::vector<int>								values(1000, 7);
+
+	stack.reserve(2000);
+	CHECK(stack.c.capacity() >= 2000);
+
+	std::size_t	allocations = stats.allocations;
+
+	stack.push_range(values.begin(), values.end());
+	stack.push_range(values.begin(), values.end());
+	CHECK(stats.allocations == allocations && stack.size() == 2000);
+	stack.pop_n(1500);
+	CHECK(stack.size() == 500 && stack.c.capacity() >= 2000);
+
+	allocations = stats.allocations;
+	stack.push_range(values.begin(), values.end());
+	stack.push_range(values.begin(), values.end());
+	stack.push_range(values.begin(), values.end());
+	CHECK(stats.allocations - allocations <= 1 && stack.size() == 3500);
+}
+
+int	main(void)
+{
+	check_bulk<ft::vector<int> >();
+	check_bulk<ft::deque<int> >();
+	check_bulk<std::deque<int> >();
+	check_bulk<std::list<int> >();
+	CHECK((ft::_has_reserve<ft::vector<int> >::value && ft::_has_reserve<ft::deque<int> >::value));
+	CHECK((!ft::_has_reserve<std::deque<int> >::value && !ft::_has_reserve<std::list<int> >::value));
+	test_reserve();
+	return (test_result("stack"));
+}
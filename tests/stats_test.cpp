@@ -0,0 +1,80 @@
+#define FT_RBTREE_STATS
+
+#include "map.hpp"
+#include "parallel.hpp"
+#include "test.hpp"
+
+typedef ft::map<int, int>	int_map;
+
+static const int	g_count = 20000;
+
+// const-поиски из потоков пула: счетчики общие для всех читателей
+struct ParallelFind
+{
+	const int_map &		m;
+	std::size_t			found;
+
+	void	operator()(std::size_t begin, std::size_t end)
+	{
+		std::size_t	local = 0;
+
+		for (; begin < end; begin++)
+			local += this->m.count(static_cast<int>(begin)) + (this->m.find(static_cast<int>(begin)) != this->m.end());
+		__atomic_add_fetch(&this->found, local, __ATOMIC_RELAXED);
+	};
+};
+
+static int_map	make_map(void)
+{
+	int_map	m;
+
+	for (int i = 0; i < g_count; i++)
+		m.insert(ft::make_pair(i, i));
+	return (m);
+}
+
+static void	test_concurrent_finds(void)
+{
+	int_map							m = make_map();
+	ft::parallel::thread_pool		pool(4);
+	ParallelFind					body = { m, 0 };
+
+	m.reset_stats();
+	for (int i = 0; i < g_count; i++)
+		m.count(i);
+
+	std::size_t	sequential_comparisons = m.stats().find_comparisons;
+
+	m.reset_stats();
+	pool.run(g_count, 64, body);
+
+	ft::tree_stats	stats = m.stats();
+
+	CHECK(body.found == 2 * static_cast<std::size_t>(g_count));
+	CHECK(stats.counters_enabled);
+	CHECK(stats.finds == 2 * static_cast<std::size_t>(g_count));
+	CHECK(stats.descents == stats.finds);
+	CHECK(stats.find_comparisons == 2 * sequential_comparisons);
+	CHECK(stats.max_descent <= stats.height && stats.max_descent > 0);
+}
+
+// Шаги итераторов считаются на тип узла: обход другой карты того же типа виден в stats()
+static void	test_iterator_steps_per_node_type(void)
+{
+	int_map		counted = make_map();
+	int_map		other = make_map();
+
+	counted.reset_stats();
+	for (int_map::iterator it = other.begin(); it != other.end(); ++it)
+		;
+	CHECK(counted.stats().iterator_steps > 0);
+	counted.reset_stats();
+	CHECK(other.stats().iterator_steps == 0);
+}
+
+int	main(void)
+{
+	test_concurrent_finds();
+	test_iterator_steps_per_node_type();
+	return (test_result("stats"));
+}
@@ -0,0 +1,151 @@
+#ifndef TEST_HPP
+# define TEST_HPP
+
+# include <cstdio>
+# include <cstdlib>
+# include <stdexcept>
+
+// Общее для тестов в tests/: CHECK печатает упавшее условие и продолжает,
+// test_result() дает код возврата для make test
+static int	g_failures = 0;
+
+# define CHECK(cond)															\
+	do																			\
+	{																			\
+		if (!(cond))															\
+		{																		\
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);	\
+			if (++g_failures > 20)												\
+				std::exit(1);													\
+		}																		\
+	} while (0)
+
+# define CHECK_THROWS(expr, exception)											\
+	do																			\
+	{																			\
+		bool	thrown = false;													\
+																				\
+		try																		\
+		{																		\
+			expr;																\
+		}																		\
+		catch (const exception &)												\
+		{																		\
+			thrown = true;														\
+		}																		\
+		CHECK(thrown && #expr);													\
+	} while (0)
+
+static inline int	test_result(const char * name)
+{
+	std::printf("%s: %s\n", name, g_failures ? "FAIL" : "ok");
+	return (g_failures != 0);
+}
+
+namespace ft
+{
+	// Доступ тестов к внутренностям контейнеров (объявлен другом в них):
+	// проверка инвариантов дерева после каждой операции
+	struct _test_access
+	{
+		template <class Container>
+		static bool	valid_tree(const Container & container)
+		{
+			try
+			{
+				container._tree._checkTree();
+			}
+			catch (const std::logic_error &)
+			{
+				return (false);
+			}
+			return (true);
+		};
+
+		// Узел в узел: те же значения, цвета и форма
+		template <class Container>
+		static bool	same_nodes(const Container & lhd, const Container & rhd)
+		{
+			return (_sameNodes(lhd._tree.root, rhd._tree.root));
+		};
+
+		// Интервальное дерево: max_high узла - наибольший правый конец
+		// в его поддереве, ссылки на родителя согласованы
+		template <class Container>
+		static bool	valid_max_high(const Container & container)
+		{
+			return (_validMaxHigh<typename Container::bound_type>(container._tree.root));
+		};
+
+		template <typename Bound, class Node>
+		static bool	_validMaxHigh(const Node * node)
+		{
+			if (!node)
+				return (true);
+
+			Bound	high = node->value.first.second;
+
+			if (node->left && high < node->left->max_high)
+				high = node->left->max_high;
+			if (node->right && high < node->right->max_high)
+				high = node->right->max_high;
+			return (!(high < node->max_high) && !(node->max_high < high)
+				&& (!node->left || node->left->parent == node) && (!node->right || node->right->parent == node)
+				&& _validMaxHigh<Bound>(node->left) && _validMaxHigh<Bound>(node->right));
+		};
+
+		// AVL в cow_map: высоты и баланс, порядок ключей, размер; у каждого
+		// узла есть хотя бы одна ссылка
+		template <class Container>
+		static bool	valid_avl(const Container & container)
+		{
+			return (_validAvlTree(container, container._root));
+		};
+
+		// Копии делят одно дерево
+		template <class Container>
+		static bool	shares_tree(const Container & lhd, const Container & rhd)
+		{
+			return (lhd._root == rhd._root);
+		};
+
+		template <class Container, class Node>
+		static bool	_validAvlTree(const Container & container, const Node * root)
+		{
+			std::size_t	count = 0;
+			const Node *	none = NULL;
+
+			return (_validAvl(container, root, none, none, count) >= 0 && count == container._size);
+		};
+
+		template <class Container, class Node>
+		static int	_validAvl(const Container & container, const Node * node, const Node * lo, const Node * hi, std::size_t & count)
+		{
+			if (!node)
+				return (0);
+			if (!node->refs || (lo && !container._comparator(lo->value.first, node->value.first))
+				|| (hi && !container._comparator(node->value.first, hi->value.first)))
+				return (-1);
+			count++;
+
+			int		left = _validAvl(container, node->left, lo, node, count);
+			int		right = _validAvl(container, node->right, node, hi, count);
+			int		height = 1 + (left < right ? right : left);
+
+			if (left < 0 || right < 0 || left - right > 1 || right - left > 1 || node->height != height)
+				return (-1);
+			return (height);
+		};
+
+		template <class Node>
+		static bool	_sameNodes(const Node * lhd, const Node * rhd)
+		{
+			if (!lhd || !rhd)
+				return (lhd == rhd);
+			return (lhd->value == rhd->value && lhd->red == rhd->red
+				&& _sameNodes(lhd->left, rhd->left) && _sameNodes(lhd->right, rhd->right));
+		};
+	};
+}
+
+#endif
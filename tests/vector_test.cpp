@@ -0,0 +1,270 @@
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+
+#include "map.hpp"
+#include "vector.hpp"
+#include "test.hpp"
+
+// Считает живые объекты; копирование бросает, когда счетчик копий доходит до нуля
+struct Counted
+{
+	static int	live;
+	static int	copies_left;
+
+	int		value;
+
+	Counted(int value = 0) : value(value)
+	{
+		live++;
+	};
+
+	Counted(const Counted & src) : value(src.value)
+	{
+		if (copies_left >= 0 && copies_left-- == 0)
+			throw std::runtime_error("copy failed");
+		live++;
+	};
+
+	Counted &	operator=(const Counted & rhd)
+	{
+		this->value = rhd.value;
+		return (*this);
+	};
+
+	~Counted()
+	{
+		live--;
+	};
+};
+
+int	Counted::live = 0;
+int	Counted::copies_left = -1;
+
+static ft::vector<Counted>	make_vector(int n, int base)
+{
+	ft::vector<Counted>	result;
+
+	for (int i = 0; i < n; i++)
+		result.push_back(Counted(base + i));
+	return (result);
+}
+
+// Источник больше емкости: копия во временный буфер бросает на середине
+static void	test_assign_reallocate_throws(void)
+{
+	{
+		ft::vector<Counted>	dst = make_vector(2, 0);
+		ft::vector<Counted>	src = make_vector(8, 100);
+		int					before = Counted::live;
+
+		Counted::copies_left = 4;
+		try
+		{
+			dst = src;
+			CHECK(false);
+		}
+		catch (const std::runtime_error &)
+		{}
+		Counted::copies_left = -1;
+
+		CHECK(Counted::live == before);
+		CHECK(dst.size() == 2 && dst[0].value == 0 && dst[1].value == 1);
+	}
+	CHECK(Counted::live == 0);
+}
+
+// Буфера хватает: бросает конструкция хвоста за живыми элементами
+static void	test_assign_reuse_throws(void)
+{
+	{
+		ft::vector<Counted>	dst = make_vector(2, 0);
+		ft::vector<Counted>	src = make_vector(6, 100);
+
+		dst.reserve(16);
+		Counted::copies_left = 2;
+		try
+		{
+			dst = src;
+			CHECK(false);
+		}
+		catch (const std::runtime_error &)
+		{}
+		Counted::copies_left = -1;
+
+		CHECK(dst.size() == 4);
+		for (ft::vector<Counted>::size_type i = 0; i < dst.size(); i++)
+			CHECK(dst[i].value == 100 + static_cast<int>(i));
+	}
+	CHECK(Counted::live == 0);
+}
+
+static void	test_copy_constructor_throws(void)
+{
+	{
+		ft::vector<Counted>	src = make_vector(5, 0);
+
+		Counted::copies_left = 3;
+		try
+		{
+			ft::vector<Counted>	copy(src);
+			CHECK(false);
+		}
+		catch (const std::runtime_error &)
+		{}
+		Counted::copies_left = -1;
+	}
+	CHECK(Counted::live == 0);
+}
+
+// resize_default_init не трогает уже живые элементы ни при росте в пределах
+// емкости, ни с переездом, ни при усечении; нетривиальные типы по-прежнему
+// конструируются по умолчанию
+static void	test_default_init(void)
+{
+	ft::vector<int>		ints;
+
+	for (int i = 0; i < 5; i++)
+		ints.push_back(i + 1);
+	ints.reserve(16);
+
+	const int *	data = ints.data();
+
+	ints.resize_default_init(12);
+	CHECK(ints.size() == 12 && ints.data() == data);
+	for (int i = 12; i-- > 5; )
+		ints[i] = -i;
+	ints.resize_default_init(100);
+	CHECK(ints.size() == 100 && ints.capacity() >= 100);
+	for (int i = 0; i < 12; i++)
+		CHECK(ints[i] == (i < 5 ? i + 1 : -i));
+	ints.resize_default_init(3);
+	CHECK(ints.size() == 3 && ints[0] == 1 && ints[2] == 3);
+	ints.resize_default_init(3);
+	CHECK(ints.size() == 3 && ints[2] == 3);
+
+	ft::vector<int>		fresh(1000, ft::default_init);
+
+	CHECK(fresh.size() == 1000 && fresh.capacity() == 1000);
+	CHECK(ft::vector<int>(0, ft::default_init).empty());
+
+	{
+		ft::vector<Counted>	counted = make_vector(3, 10);
+
+		counted.resize_default_init(7);
+		CHECK(counted.size() == 7 && Counted::live == 7);
+		CHECK(counted[2].value == 12 && counted[3].value == 0 && counted[6].value == 0);
+		counted.resize_default_init(2);
+		CHECK(Counted::live == 2 && counted[1].value == 11);
+
+		ft::vector<Counted>	constructed(4, ft::default_init);
+
+		CHECK(constructed.size() == 4 && constructed[3].value == 0 && Counted::live == 6);
+	}
+	CHECK(Counted::live == 0);
+}
+
+static bool	counts_up(const ft::vector<int> & vec, int first, int count)
+{
+	if (vec.size() != static_cast<ft::vector<int>::size_type>(count))
+		return (false);
+	for (int i = 0; i < count; i++)
+		if (vec[i] != first + i)
+			return (false);
+	return (true);
+}
+
+typedef std::istream_iterator<int>	int_reader;
+
+// Однопроходные итераторы: конструктор, assign поверх более длинного
+// и более короткого вектора и insert в середину читают поток один раз
+static void	test_input_iterators(void)
+{
+	std::istringstream	numbers("0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19");
+	ft::vector<int>		read((int_reader(numbers)), int_reader());
+
+	CHECK(counts_up(read, 0, 20));
+
+	std::istringstream	few("100 101 102");
+
+	read.assign((int_reader(few)), int_reader());
+	CHECK(counts_up(read, 100, 3));
+
+	std::istringstream	many("0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24");
+
+	read.assign((int_reader(many)), int_reader());
+	CHECK(counts_up(read, 0, 25));
+
+	std::istringstream	middle("-1 -2 -3");
+
+	read.insert(read.begin() + 10, int_reader(middle), int_reader());
+	CHECK(read.size() == 28 && read[9] == 9 && read[10] == -1 && read[12] == -3 && read[13] == 10 && read[27] == 24);
+
+	std::istringstream	empty("");
+
+	read.insert(read.begin(), int_reader(empty), int_reader());
+	read.assign((int_reader(empty)), int_reader());
+	CHECK(read.empty());
+	CHECK(ft::vector<int>((int_reader(empty)), int_reader()).empty());
+}
+
+// Двунаправленные итераторы (std::list, ft::map) считаются заранее:
+// одно выделение ровно под размер
+static void	test_bidirectional_iterators(void)
+{
+	std::list<int>		list;
+	ft::map<int, int>	map;
+
+	for (int i = 0; i < 50; i++)
+	{
+		list.push_back(i);
+		map[i] = i * i;
+	}
+
+	ft::vector<int>		from_list(list.begin(), list.end());
+
+	CHECK(counts_up(from_list, 0, 50) && from_list.capacity() == 50);
+	from_list.insert(from_list.begin(), list.begin(), list.end());
+	CHECK(from_list.size() == 100 && from_list[49] == 49 && from_list[50] == 0);
+	from_list.assign(list.begin(), list.end());
+	CHECK(counts_up(from_list, 0, 50));
+
+	ft::vector<ft::pair<const int, int> >	pairs(map.begin(), map.end());
+
+	CHECK(pairs.size() == 50 && pairs.capacity() == 50);
+	CHECK(pairs[0].first == 0 && pairs[7].first == 7 && pairs[7].second == 49 && pairs[49].second == 2401);
+}
+
+// Два целых одного типа - это (n, val), а не пара итераторов:
+// enable_if<!is_integral> убирает шаблонные перегрузки
+static void	test_integral_arguments(void)
+{
+	ft::vector<int>		ints(5, 7);
+
+	CHECK(ints.size() == 5 && ints[0] == 7 && ints[4] == 7);
+	ints.assign(3, 9);
+	CHECK(ints.size() == 3 && ints[2] == 9);
+	ints.insert(ints.begin() + 1, 2, 1);
+	CHECK(ints.size() == 5 && ints[0] == 9 && ints[1] == 1 && ints[2] == 1 && ints[3] == 9);
+
+	ft::vector<unsigned long>	longs(4ul, 2ul);
+	ft::vector<char>			chars(static_cast<char>(3), 'a');
+	ft::vector<short>			shorts(static_cast<short>(2), static_cast<short>(-1));
+
+	CHECK(longs.size() == 4 && longs[3] == 2);
+	CHECK(chars.size() == 3 && chars[2] == 'a');
+	CHECK(shorts.size() == 2 && shorts[1] == -1);
+}
+
+int	main(void)
+{
+	test_default_init();
+	test_input_iterators();
+	test_bidirectional_iterators();
+	test_integral_arguments();
+	test_assign_reallocate_throws();
+	test_assign_reuse_throws();
+	test_copy_constructor_throws();
+	return (test_result("vector"));
+}
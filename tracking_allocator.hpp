@@ -0,0 +1,188 @@
+#ifndef TRACKING_ALLOCATOR_HPP
+# define TRACKING_ALLOCATOR_HPP
+
+# include <cstddef>
+# include <memory>
+
+namespace ft
+{
+	// Счетчики одного или нескольких tracking_allocator. Обновляются атомарно,
+	// так что один объект можно отдать контейнерам из разных потоков
+	struct allocation_stats
+	{
+		// Корзина k - запросы размером [2^k, 2^(k+1)) байт, последняя - все, что больше
+		static const std::size_t	histogram_size = 32;
+
+		std::size_t	allocations;
+		std::size_t	deallocations;
+		std::size_t	live_bytes;
+		std::size_t	peak_bytes;
+		std::size_t	total_bytes;
+		std::size_t	histogram[histogram_size];
+
+		allocation_stats(void)
+		{
+			this->reset();
+		};
+
+		void	reset(void)
+		{
+			this->allocations = 0;
+			this->deallocations = 0;
+			this->live_bytes = 0;
+			this->peak_bytes = 0;
+			this->total_bytes = 0;
+			for (std::size_t i = 0; i < histogram_size; i++)
+				this->histogram[i] = 0;
+		};
+
+		static std::size_t	bucket(std::size_t bytes)
+		{
+			std::size_t	k = bytes ? sizeof(unsigned long) * 8 - 1 - __builtin_clzl(bytes) : 0;
+
+			return (k < histogram_size ? k : histogram_size - 1);
+		};
+
+		void	recordAllocate(std::size_t bytes)
+		{
+			std::size_t	live = __atomic_add_fetch(&this->live_bytes, bytes, __ATOMIC_RELAXED);
+			std::size_t	peak = __atomic_load_n(&this->peak_bytes, __ATOMIC_RELAXED);
+
+			while (live > peak && !__atomic_compare_exchange_n(&this->peak_bytes, &peak, live,
+				true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				;
+			__atomic_add_fetch(&this->allocations, 1, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&this->total_bytes, bytes, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&this->histogram[bucket(bytes)], 1, __ATOMIC_RELAXED);
+		};
+
+		void	recordDeallocate(std::size_t bytes)
+		{
+			__atomic_sub_fetch(&this->live_bytes, bytes, __ATOMIC_RELAXED);
+			__atomic_add_fetch(&this->deallocations, 1, __ATOMIC_RELAXED);
+		};
+
+		// Общие счетчики для аллокаторов, созданных без явного allocation_stats
+		static allocation_stats &	global(void)
+		{
+			static allocation_stats	stats;
+
+			return (stats);
+		};
+	};
+
+	// Обертка над Base, которая пишет каждое выделение в allocation_stats.
+	// Счетчики передаются через rebind, поэтому map считает и свои узлы дерева
+	template <typename T, class Base = std::allocator<T> >
+	class tracking_allocator
+	{
+		public:
+			typedef				T								value_type;
+			typedef				T *								pointer;
+			typedef				const T *						const_pointer;
+			typedef				T &								reference;
+			typedef				const T &						const_reference;
+			typedef				std::size_t						size_type;
+			typedef				std::ptrdiff_t					difference_type;
+			typedef				Base							base_type;
+
+			template <typename U>
+			struct rebind
+			{
+				typedef	tracking_allocator<U, typename Base::template rebind<U>::other>	other;
+			};
+
+		private:
+			allocation_stats *	_stats;
+			base_type			_base;
+
+		public:
+			explicit tracking_allocator(allocation_stats & stats = allocation_stats::global(), const base_type & base = base_type())
+				: _stats(&stats), _base(base)
+			{};
+
+			tracking_allocator(const tracking_allocator & src)
+				: _stats(src._stats), _base(src._base)
+			{};
+
+			template <typename U, class B>
+			tracking_allocator(const tracking_allocator<U, B> & src)
+				: _stats(&src.stats()), _base(src.base())
+			{};
+
+			~tracking_allocator() {};
+
+			tracking_allocator &	operator=(const tracking_allocator & rhd)
+			{
+				this->_stats = rhd._stats;
+				this->_base = rhd._base;
+
+				return (*this);
+			};
+
+			allocation_stats &	stats(void)	const
+			{
+				return (*this->_stats);
+			};
+
+			const base_type &	base(void)	const
+			{
+				return (this->_base);
+			};
+
+			pointer	address(reference x)	const
+			{
+				return (&x);
+			};
+
+			const_pointer	address(const_reference x)	const
+			{
+				return (&x);
+			};
+
+			pointer	allocate(size_type n, const void * hint = 0)
+			{
+				pointer	p = this->_base.allocate(n, hint);
+
+				this->_stats->recordAllocate(n * sizeof(T));
+				return (p);
+			};
+
+			void	deallocate(pointer p, size_type n)
+			{
+				if (!p)
+					return ;
+				this->_stats->recordDeallocate(n * sizeof(T));
+				this->_base.deallocate(p, n);
+			};
+
+			size_type	max_size(void)	const
+			{
+				return (this->_base.max_size());
+			};
+
+			void	construct(pointer p, const_reference val)
+			{
+				this->_base.construct(p, val);
+			};
+
+			void	destroy(pointer p)
+			{
+				this->_base.destroy(p);
+			};
+	};
+
+	template <typename T, class BT, typename U, class BU>
+	inline bool	operator==(const tracking_allocator<T, BT> & lhd, const tracking_allocator<U, BU> & rhd)
+	{
+		return (&lhd.stats() == &rhd.stats() && lhd.base() == rhd.base());
+	};
+
+	template <typename T, class BT, typename U, class BU>
+	inline bool	operator!=(const tracking_allocator<T, BT> & lhd, const tracking_allocator<U, BU> & rhd)
+	{
+		return !(lhd == rhd);
+	};
+};
+
+#endif
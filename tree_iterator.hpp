@@ -1,8 +1,38 @@
 #ifndef TREE_ITERATOR
 # define TREE_ITERATOR
 
+# include <cstddef>
+# include "type_traits.hpp"
+
+// -DFT_RBTREE_STATS включает счетчики дерева (см. tree_stats), без него
+// FT_RBTREE_COUNT выбрасывает свой аргумент целиком
+# ifdef FT_RBTREE_STATS
+#  define FT_RBTREE_COUNT(statement) statement
+# else
+#  define FT_RBTREE_COUNT(statement)
+# endif
+
 namespace ft
 {
+# ifdef FT_RBTREE_STATS
+	// Счетчики статистики может менять несколько читающих потоков сразу
+	inline void	_stats_add(std::size_t & counter, std::size_t n = 1)
+	{
+		__atomic_add_fetch(&counter, n, __ATOMIC_RELAXED);
+	}
+
+	// Итератор не знает свое дерево, поэтому шаги считаются на весь тип узла:
+	// tree_stats::iterator_steps любого дерева с этим Node - общая сумма по всем им
+	template <typename Node>
+	struct _tree_iterator_steps
+	{
+		static std::size_t	value;
+	};
+
+	template <typename Node>
+	std::size_t	_tree_iterator_steps<Node>::value = 0;
+# endif
+
 	template <typename T, typename Node>
 	class tree_iterator
 	{
@@ -18,23 +48,34 @@ namespace ft
 			Node *	current;
 		
 		private:
+			template <typename, typename>
+			friend class tree_iterator;
+
 			Node *	root;
 		
 			void	_go(bool forward)
 			{
-				if (*this->current->dirs[forward])
+				if (this->current->dir(forward))
 				{
-					this->current = *this->current->dirs[forward];
-
-					while (*this->current->dirs[!forward])
-						this->current = *this->current->dirs[!forward];
+					this->current = this->current->dir(forward);
+					FT_RBTREE_COUNT(_stats_add(_tree_iterator_steps<Node>::value);)
+
+					while (this->current->dir(!forward))
+					{
+						this->current = this->current->dir(!forward);
+						FT_RBTREE_COUNT(_stats_add(_tree_iterator_steps<Node>::value);)
+					}
 					
 					return ;
 				}
 
 				while (this->current->getDir() == forward)
+				{
 					this->current = this->current->parent;
+					FT_RBTREE_COUNT(_stats_add(_tree_iterator_steps<Node>::value);)
+				}
 				this->current = this->current->parent;
+				FT_RBTREE_COUNT(_stats_add(_tree_iterator_steps<Node>::value);)
 			};
 
 
@@ -52,6 +93,13 @@ namespace ft
 
 			tree_iterator(const tree_iterator & it) : current(it.current), root(it.root) {};
 
+			// iterator -> const_iterator, обратно нельзя
+			template <typename U>
+			tree_iterator(const tree_iterator<U, Node> & it,
+				typename ft::enable_if<ft::is_same<const U, T>::value>::type * = NULL)
+				: current(it.current), root(it.root)
+			{};
+
 			~tree_iterator() {};
 
 			tree_iterator &	operator=(const tree_iterator & rhd)
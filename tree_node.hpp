@@ -4,43 +4,30 @@
 # include <stdexcept>
 
 namespace ft {
-	template <typename T>
-	class TreeNode {
+	// Дополнительные данные узла по умолчанию - ничего (пустая база не занимает места)
+	struct tree_no_augment_data {};
+
+	template <typename T, typename Extra = tree_no_augment_data>
+	class TreeNode : public Extra {
 		public:
 			T			value;
 			bool		red;
 			TreeNode	*left;
 			TreeNode	*right;
 			TreeNode	*parent;
-			TreeNode	**dirs[2];
 
 			// Дефолтный конструктор
-			TreeNode(void) : value(), red(false), left(NULL), right(NULL) {
-				this->dirs[0] = &this->left;
-				this->dirs[1] = &this->right;
-			};
+			TreeNode(void) : Extra(), value(), red(false), left(NULL), right(NULL), parent(NULL) {};
 
 			// Конструктор копирования для красных узлов(??)
 			TreeNode(const T & value, TreeNode * parent, const bool red = true)
-				: value(value)
-			{
-				*this = TreeNode();
-				this->parent = parent;
-				this->red = red;
-
-				this->dirs[0] = &this->left;
-				this->dirs[1] = &this->right;
-			};
+				: Extra(), value(value), red(red), left(NULL), right(NULL), parent(parent)
+			{};
 
 			// Обычный конструктор копирования
 			TreeNode(const TreeNode & src)
-				: value(src.value)
-			{
-				*this = src;
-
-				this->dirs[0] = &this->left;
-				this->dirs[1] = &this->right;
-			};
+				: Extra(src), value(src.value), red(src.red), left(src.left), right(src.right), parent(src.parent)
+			{};
 
 			~TreeNode() {};
 
@@ -54,6 +41,17 @@ namespace ft {
 				return (*this);
 			};
 
+			// Ребенок по направлению: 0 - левый, 1 - правый
+			TreeNode *&	dir(int i)
+			{
+				return (i ? this->right : this->left);
+			};
+
+			TreeNode *	dir(int i)	const
+			{
+				return (i ? this->right : this->left);
+			};
+
 			// Родственная вакханалия начинается тут
 
 			//бери дядю - не пожалеешь
@@ -62,7 +60,7 @@ namespace ft {
 				if (!this->parent || !this->parent->parent)
 					return (NULL);
 				
-				return (*this->parent->parent->dirs[!this->parent->getDir()]);
+				return (this->parent->parent->dir(!this->parent->getDir()));
 			};
 
 			// Проверка на внука
@@ -72,7 +70,7 @@ namespace ft {
 					throw std::range_error("node have no ancestors");
 				
 				for (int i = 0; i < 2; i++)
-					if (*this->parent->parent->dirs[i] == this->parent && *this->parent->dirs[i] == this)
+					if (this->parent->parent->dir(i) == this->parent && this->parent->dir(i) == this)
 						return (true);
 
 				return (false);
@@ -84,7 +82,7 @@ namespace ft {
 				if (!this->parent)
 					return (-1);
 				
-				if (*this->parent->dirs[0] == this)
+				if (this->parent->dir(0) == this)
 					return (0);
 				return (1);
 			};
@@ -97,20 +95,20 @@ namespace ft {
 
 				int		i = this->getDir();
 
-				*this->parent->dirs[i] = *this->dirs[!i];
-				if (*this->dirs[!i])
-					(*this->dirs[!i])->parent = this->parent;
-				*this->dirs[!i] = this->parent;
+				this->parent->dir(i) = this->dir(!i);
+				if (this->dir(!i))
+					(this->dir(!i))->parent = this->parent;
+				this->dir(!i) = this->parent;
 				this->parent = this->parent->parent;
-				(*this->dirs[!i])->parent = this;
+				(this->dir(!i))->parent = this;
 
 				if (!this->parent)
 					return ;
 
-				if (*this->parent->dirs[i] != *this->dirs[!i])
+				if (this->parent->dir(i) != this->dir(!i))
 					i = !i;
 
-				*this->parent->dirs[i] = this;
+				this->parent->dir(i) = this;
 			};
 
 			// притворяемя крысами (ссылки кoрдутця)
@@ -126,7 +124,7 @@ namespace ft {
 				if (this->right)
 					this->right->parent = this;
 				if (this->parent)
-					*this->parent->dirs[src.getDir()] = this;
+					this->parent->dir(src.getDir()) = this;
 			};
 
 			void	stealLinks(const TreeNode * src)
@@ -148,7 +146,7 @@ namespace ft {
 				if (!this->parent)
 					throw std::range_error("node dosn't have a parent and have no siblings");
 				
-				return (*this->parent->dirs[!this->getDir()]);
+				return (this->parent->dir(!this->getDir()));
 			};
 
 			// ммм~ расиситкие шутки
@@ -114,6 +114,14 @@ namespace ft {
 
 	template <typename T>
 	struct is_same<T, T> : true_type {};
+
+	// Можно ли оставить объект без инициализации (конструктор по умолчанию ничего не делает)
+	template <typename T>
+	struct is_trivially_default_constructible : public integral_constant<bool, __has_trivial_constructor(T)> {};
+
+	// Можно ли копировать объект побайтно (memcpy, запись в файл)
+	template <typename T>
+	struct is_trivially_copyable : public integral_constant<bool, __has_trivial_copy(T) && __has_trivial_destructor(T)> {};
 };
 
 #endif
\ No newline at end of file
@@ -1,9 +1,12 @@
 #ifndef VECTOR_HPP
 # define VECTOR_HPP
 
+# include <algorithm>
+# include <iosfwd>
 # include <memory>
 # include <stdexcept>
 # include "algorithm.hpp"
+# include "memory_usage.hpp"
 # include "type_traits.hpp"
 # include "iterator_traits.hpp"
 # include "vector_iterator.hpp"
@@ -11,6 +14,19 @@
 
 namespace ft
 {
+	// Тег для конструктора/resize без инициализации тривиальных элементов
+	struct default_init_t {};
+
+	static const default_init_t	default_init = default_init_t();
+
+	// Тела vector::save/load - в snapshot.hpp: кто их вызывает, подключает его,
+	// остальным пользователям vector потоки и формат снимка не нужны
+	template <class Vector>
+	void	_save_vector(const Vector & vec, std::ostream & out);
+
+	template <class Vector>
+	void	_load_vector(Vector & vec, std::istream & in);
+
 	template <typename T, class Alloc = std::allocator<T> >
 	class vector
 	{
@@ -47,39 +63,188 @@ namespace ft
 					_allocator.construct(new_values + i, this->_values[i]);
 					_allocator.destroy(this->_values + i);
 				}
-				
-				for (size_type i = this->_size; i < this->_capacity; i++)
-					_allocator.destroy(this->_values + i);
 
-				_allocator.deallocate(this->_values, this->_capacity);
+				if (this->_values)
+					_allocator.deallocate(this->_values, this->_capacity);
 				this->_values = new_values;
 				this->_capacity = new_capacity;
 			};
 
-			iterator	_insertion_routine(iterator position, size_type val_num)
+			// Раздвигает [idx, idx + n). Возвращает, сколько первых слотов щели еще
+			// содержат живые объекты: их присваивают, остальные конструируют
+			size_type	_openGap(size_type idx, size_type n)
 			{
-				size_type indx = position.base() - this->_values;
+				if (this->_size + n > this->_capacity)
+				{
+					size_type	new_capacity = this->_capacity * 2;
+					size_type	old_size = this->_size;
 
-				if (this->_size + val_num > this->_capacity * 2)
-					this->reserve(this->_size + val_num);
-				else if (this->_capacity < this->_size + val_num)
-					this->reserve(this->_capacity * 2);
+					if (new_capacity < this->_size + n)
+						new_capacity = this->_size + n;
 
-				position = this->begin() + indx;
+					pointer	new_values = this->_allocator.allocate(new_capacity);
 
-				iterator last = this->end() + val_num;
+					for (size_type i = 0; i < idx; i++)
+						this->_allocator.construct(new_values + i, this->_values[i]);
+					for (size_type i = idx; i < old_size; i++)
+						this->_allocator.construct(new_values + i + n, this->_values[i]);
 
-				while (--last > this->end())
-					this->_allocator.construct(last.base(), *(last - val_num));
-				this->_allocator.construct(last.base(), *(last - val_num));
+					this->clear();
+					if (this->_values)
+						this->_allocator.deallocate(this->_values, this->_capacity);
 
-				while (--last > position + val_num - 1)
-					*last = *(last - val_num);
+					this->_values = new_values;
+					this->_capacity = new_capacity;
+					this->_size = old_size + n;
 
-				this->_size += val_num;
+					return (0);
+				}
 
-				return position;
-			}
+				pointer		position = this->_values + idx;
+				pointer		old_end = this->_values + this->_size;
+				size_type	after = this->_size - idx;
+
+				this->_size += n;
+
+				if (after > n)
+				{
+					for (size_type i = 0; i < n; i++)
+						this->_allocator.construct(old_end + i, *(old_end - n + i));
+					std::copy_backward(position, old_end - n, old_end);
+					return (n);
+				}
+
+				for (size_type i = 0; i < after; i++)
+					this->_allocator.construct(position + n + i, position[i]);
+				return (after);
+			};
+
+			template <typename ForwardIterator>
+			void	_fillGap(size_type idx, size_type n, size_type live, ForwardIterator first)
+			{
+				pointer	position = this->_values + idx;
+
+				for (size_type i = 0; i < n; i++, ++first)
+				{
+					if (i < live)
+						position[i] = *first;
+					else
+						this->_allocator.construct(position + i, *first);
+				}
+			};
+
+			void	_fillGapWithValue(size_type idx, size_type n, size_type live, const_reference val)
+			{
+				pointer	position = this->_values + idx;
+
+				for (size_type i = 0; i < n; i++)
+				{
+					if (i < live)
+						position[i] = val;
+					else
+						this->_allocator.construct(position + i, val);
+				}
+			};
+
+			// Однопроходные итераторы (потоки) нельзя считать заранее: растем по мере чтения
+			template <typename InputIterator>
+			void	_rangeInit(InputIterator first, InputIterator last, std::input_iterator_tag)
+			{
+				for (; first != last; ++first)
+					this->push_back(*first);
+			};
+
+			// Для forward/bidirectional distance проходит один раз, для random access - O(1)
+			template <typename ForwardIterator>
+			void	_rangeInit(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+			{
+				size_type	n = std::distance(first, last);
+
+				this->_values = this->_allocator.allocate(n);
+				this->_capacity = n;
+
+				for (; first != last; ++first)
+					this->_allocator.construct(this->_values + this->_size++, *first);
+			};
+
+			template <typename InputIterator>
+			void	_rangeAssign(InputIterator first, InputIterator last, std::input_iterator_tag)
+			{
+				size_type	i = 0;
+
+				for (; first != last && i < this->_size; ++first, ++i)
+					this->_values[i] = *first;
+
+				if (first == last)
+					this->_destroyAtEnd(i);
+
+				for (; first != last; ++first)
+					this->push_back(*first);
+			};
+
+			template <typename ForwardIterator>
+			void	_rangeAssign(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+			{
+				size_type	n = std::distance(first, last);
+
+				if (n > this->_capacity)
+				{
+					this->clear();
+					if (this->_values)
+						this->_allocator.deallocate(this->_values, this->_capacity);
+					this->_values = NULL;
+					this->_capacity = 0;
+					this->_rangeInit(first, last, std::forward_iterator_tag());
+					return ;
+				}
+
+				size_type	live = this->_size < n ? this->_size : n;
+				size_type	i = 0;
+
+				for (; i < live; ++i, ++first)
+					this->_values[i] = *first;
+				for (; i < n; ++i, ++first)
+					this->_allocator.construct(this->_values + i, *first);
+
+				this->_destroyAtEnd(n);
+				this->_size = n;
+			};
+
+			template <typename InputIterator>
+			void	_rangeInsert(size_type idx, InputIterator first, InputIterator last, std::input_iterator_tag)
+			{
+				size_type	old_size = this->_size;
+
+				for (; first != last; ++first)
+					this->push_back(*first);
+
+				std::rotate(this->_values + idx, this->_values + old_size, this->_values + this->_size);
+			};
+
+			template <typename ForwardIterator>
+			void	_rangeInsert(size_type idx, ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+			{
+				size_type	n = std::distance(first, last);
+
+				if (!n)
+					return ;
+
+				this->_fillGap(idx, n, this->_openGap(idx, n), first);
+			};
+
+			void	_defaultConstructAtEnd(size_type n, ft::true_type) {
+				this->_size += n;
+			};
+
+			void	_defaultConstructAtEnd(size_type n, ft::false_type) {
+				while (n--)
+					this->_allocator.construct(this->_values + this->_size++, value_type());
+			};
+
+			void	_destroyAtEnd(size_type n) {
+				while (this->_size > n)
+					this->_allocator.destroy(this->_values + --this->_size);
+			};
 
 		public:
 			explicit	vector(const allocator_type & alloc = allocator_type())
@@ -96,44 +261,86 @@ namespace ft
 					this->_allocator.construct(this->_values + i, val);
 			};
 
+			vector(size_type n, default_init_t, const allocator_type & alloc = allocator_type())
+				: _allocator(alloc), _values(NULL), _size(0), _capacity(n)
+			{
+				this->_values = this->_allocator.allocate(n);
+				this->_defaultConstructAtEnd(n, ft::is_trivially_default_constructible<value_type>());
+			};
+
 			template <class InputIterator>
-			vector(InputIterator first, InputIterator last, const allocator_type & alloc = allocator_type())
-				: _values(NULL), _size(std::distance(first, last)), _capacity(std::distance(first, last)), _allocator(alloc)
+			vector(InputIterator first, InputIterator last, const allocator_type & alloc = allocator_type(),
+				typename ft::enable_if<!ft::is_integral<InputIterator>::value, InputIterator>::type * = NULL)
+				: _allocator(alloc), _values(NULL), _size(0), _capacity(0)
 			{
-				this->_values = this->_allocator.allocate(std::distance(first, last));
-				std::copy(first, last, this->begin());
+				this->_rangeInit(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
 			};
 
 			vector(const vector & src)
-				: _values(NULL), _size(0), _capacity(0)
+				: _allocator(src._allocator), _values(NULL), _size(0), _capacity(0)
 			{
 				*this = src;
 			};
 
 			~vector() {
 				this->clear();
+				if (this->_values)
+					this->_allocator.deallocate(this->_values, this->_capacity);
 			};
 
+			// Переиспользует буфер, если его хватает: живые элементы присваиваются,
+			// хвост конструируется, лишнее разрушается. Новый буфер берется с емкостью
+			// источника, чтобы снимки растущего вектора не перевыделялись каждый раз
 			vector &	operator=(vector const & rhd) {
-				if (this->_capacity != rhd._capacity)
-				{
+				if (this == &rhd)
+					return (*this);
 
-					for (size_type i = 0; i < this->_capacity; i++)
-						_allocator.destroy(this->_values + i);
-					
-					_allocator.deallocate(this->_values, this->_capacity);
-					this->_values = _allocator.allocate(rhd._capacity);
+				if (this->_capacity < rhd._size)
+				{
+					pointer		new_values = this->_allocator.allocate(rhd._capacity);
+					size_type	built = 0;
+
+					try
+					{
+						for (; built < rhd._size; built++)
+							this->_allocator.construct(new_values + built, rhd._values[built]);
+					}
+					catch (...)
+					{
+						while (built)
+							this->_allocator.destroy(new_values + --built);
+						this->_allocator.deallocate(new_values, rhd._capacity);
+						throw;
+					}
+
+					this->clear();
+					if (this->_values)
+						this->_allocator.deallocate(this->_values, this->_capacity);
+
+					this->_values = new_values;
+					this->_size = rhd._size;
 					this->_capacity = rhd._capacity;
+
+					return (*this);
+				}
+
+				pointer			dst = this->_values;
+				const_pointer	src = rhd._values;
+				size_type		live = this->_size < rhd._size ? this->_size : rhd._size;
+
+				std::copy(src, src + live, dst);
+
+				// _size растет после каждой конструкции: если копия бросит,
+				// уже построенный хвост принадлежит вектору и будет разрушен
+				while (this->_size < rhd._size)
+				{
+					this->_allocator.construct(dst + this->_size, src[this->_size]);
+					this->_size++;
 				}
 
+				this->_destroyAtEnd(rhd._size);
 				this->_size = rhd._size;
 
-				for (size_type i = 0; i < this->_size; i++)
-					_allocator.construct(this->_values + i, rhd._values[i]);
-				
-				for (size_type i = this->_size; i < this->_capacity; i++)
-					_allocator.construct(this->_values + i, value_type());
-				
 				return (*this);
 			};
 
@@ -213,9 +420,7 @@ namespace ft
 			void	resize(size_type n, value_type val = value_type()) {
 				if (n <= this->_size)
 				{
-					this->_size = n;
-					for (size_type i = this->_size; i < this->_capacity; i++)
-						_allocator.destroy(this->_values + i);
+					this->_destroyAtEnd(n);
 					return ;
 				}
 
@@ -225,6 +430,19 @@ namespace ft
 					_allocator.construct(this->_values + this->_size++, val);
 			};
 
+			// Как resize, но тривиальные элементы остаются неинициализированными:
+			// память не трогается, и страницы не подгружаются до первой записи
+			void	resize_default_init(size_type n) {
+				if (n <= this->_size)
+				{
+					this->_destroyAtEnd(n);
+					return ;
+				}
+
+				this->reserve(n);
+				this->_defaultConstructAtEnd(n - this->_size, ft::is_trivially_default_constructible<value_type>());
+			};
+
 			inline size_type	capacity(void)	const {
 				return (this->_capacity);
 			};
@@ -284,32 +502,28 @@ namespace ft
 			};
 
 			template <typename InputIterator>
-			void	assign(InputIterator first, InputIterator last) {
-				size_type	n = std::distance(first, last);
-				this->reserve(n);
-
-				iterator	start = this->begin();
-
-				for (;first != last; first++)
-					*(start++) = *first;
-				
-				for (; start != this->end(); start++)
-					this->_allocator.destroy(start.base());
-				
-				this->_size = n;
+			typename ft::enable_if<!ft::is_integral<InputIterator>::value, void>::type
+				assign(InputIterator first, InputIterator last) {
+				this->_rangeAssign(first, last, typename ft::iterator_traits<InputIterator>::iterator_category());
 			};
 
 			void	assign(size_type n, const_reference val) {
-				this->reserve(n);
+				if (n > this->_capacity)
+				{
+					vector	tmp(n, val, this->_allocator);
+
+					this->swap(tmp);
+					return ;
+				}
 
-				iterator start = this->begin();
+				size_type	live = this->_size < n ? this->_size : n;
 
-				for (size_type i = 0; i < n; i++)
-					*(start++) = val;
-				
-				for (; start != this->end(); start++)
-					this->_allocator.destroy(start.base());
+				for (size_type i = 0; i < live; i++)
+					this->_values[i] = val;
+				for (size_type i = live; i < n; i++)
+					this->_allocator.construct(this->_values + i, val);
 
+				this->_destroyAtEnd(n);
 				this->_size = n;
 			};
 
@@ -326,26 +540,29 @@ namespace ft
 			};
 
 			iterator	insert(iterator position, const_reference val) {
-				position = this->_insertion_routine(position, 1);
+				size_type	idx = position.base() - this->_values;
+				value_type	copy(val);
 
-				*position = val;
+				this->_fillGapWithValue(idx, 1, this->_openGap(idx, 1), copy);
 
-				return (position);
+				return (this->begin() + idx);
 			};
 
 			void	insert(iterator position, size_type n, const_reference val) {
-				position = this->_insertion_routine(position, n);
+				size_type	idx = position.base() - this->_values;
+				value_type	copy(val);
 
-				while (n--)
-					*(position++) = val;
+				if (!n)
+					return ;
+
+				this->_fillGapWithValue(idx, n, this->_openGap(idx, n), copy);
 			};
 
 			template <typename InputIterator>
-			void	insert(iterator position, InputIterator first, InputIterator last) {
-				position = this->_insertion_routine(position, std::distance(first, last));
-
-				while (first++ != last)
-					*(position++) = *first;
+			typename ft::enable_if<!ft::is_integral<InputIterator>::value, void>::type
+				insert(iterator position, InputIterator first, InputIterator last) {
+				this->_rangeInsert(position.base() - this->_values, first, last,
+					typename ft::iterator_traits<InputIterator>::iterator_category());
 			};
 
 			inline iterator	erase(iterator position) {
@@ -371,6 +588,10 @@ namespace ft
 				value_type *	buf = src._values;
 				size_type		size_buf = src._size;
 				size_type		capacity_buf = src._capacity;
+				allocator_type	allocator_buf = src._allocator;
+
+				src._allocator = this->_allocator;
+				this->_allocator = allocator_buf;
 
 				src._values = this->_values;
 				src._size = this->_size;
@@ -389,6 +610,25 @@ namespace ft
 			inline allocator_type	get_allocator(void)	const {
 				return (_allocator);
 			};
+
+			memory_usage_info	memory_usage(void)	const {
+				memory_usage_info	info;
+
+				info.payload_bytes = this->_size * sizeof(value_type);
+				info.overhead_bytes = sizeof(*this);
+				info.unused_bytes = (this->_capacity - this->_size) * sizeof(value_type);
+				return (info);
+			};
+
+			// Формат и точка расширения для своих типов - в snapshot.hpp (нужно подключить)
+			void	save(std::ostream & out)	const {
+				_save_vector(*this, out);
+			};
+
+			// При ошибке бросает snapshot_error, содержимое вектора не меняется
+			void	load(std::istream & in) {
+				_load_vector(*this, in);
+			};
 	};
 
 	template <typename T, typename Alloc>
@@ -397,35 +637,35 @@ namespace ft
 	};
 
 	template <typename T, typename Alloc>
-	bool	operator==(vector<T, Alloc> & lhd, vector<T, Alloc> & rhd) {
+	bool	operator==(const vector<T, Alloc> & lhd, const vector<T, Alloc> & rhd) {
 		if (lhd.size() != rhd.size())
 			return (false);
 		return (ft::equal(lhd.begin(), lhd.end(), rhd.begin()));
 	};
 
 	template <typename T, typename Alloc>
-	inline bool	operator!=(vector<T, Alloc> & lhd, vector<T, Alloc> & rhd) {
+	inline bool	operator!=(const vector<T, Alloc> & lhd, const vector<T, Alloc> & rhd) {
 		return !(lhd == rhd);
 	};
 
 	template <typename T, typename Alloc>
-	inline bool	operator<(vector<T, Alloc> & lhd, vector<T, Alloc> & rhd) {
+	inline bool	operator<(const vector<T, Alloc> & lhd, const vector<T, Alloc> & rhd) {
 		return (ft::lexicographical_compare(lhd.begin(), lhd.end(), rhd.begin(), rhd.end()));
 	};
 
 	template <typename T, typename Alloc>
-	inline bool	operator>(vector<T, Alloc> & lhd, vector<T, Alloc> & rhd) {
+	inline bool	operator>(const vector<T, Alloc> & lhd, const vector<T, Alloc> & rhd) {
 		return (rhd < lhd);
 	};
 
 	template <typename T, typename Alloc>
-	inline bool	operator<=(vector<T, Alloc> & lhd, vector<T, Alloc> & rhd) {
-		return !(rhd > lhd);
+	inline bool	operator<=(const vector<T, Alloc> & lhd, const vector<T, Alloc> & rhd) {
+		return !(rhd < lhd);
 	};
 
 	template <typename T, typename Alloc>
-	inline bool	operator>=(vector<T, Alloc> & lhd, vector<T, Alloc> & rhd) {
-		return !(lhd > rhd);
+	inline bool	operator>=(const vector<T, Alloc> & lhd, const vector<T, Alloc> & rhd) {
+		return !(lhd < rhd);
 	};
 };
 
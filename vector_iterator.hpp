@@ -1,6 +1,8 @@
 #ifndef VECTOR_ITERATOR
 # define VECTOR_ITERATOR
 
+# include "iterator_traits.hpp"
+
 namespace ft {
 	template <typename Iterator>
 		class vector_iterator {
@@ -18,6 +20,8 @@ namespace ft {
 				vector_iterator(void) {};
 				vector_iterator(const vector_iterator &src) { *this = src; };
 				vector_iterator(const pointer &src) : _current(src) {};
+				template <typename Iter>
+				vector_iterator(const vector_iterator<Iter> &src) : _current(src.base()) {};
 				~vector_iterator() {};
 
 				vector_iterator &operator=(const vector_iterator &rhd) 
@@ -29,7 +33,7 @@ namespace ft {
 				reference operator*(void) { return *_current; };
 				pointer operator->(void) const { return _current; };
 				reference operator[](difference_type n) const { return (this->_current[n]); };
-				vector_iterator &operator+(difference_type n) const { return (vector_iterator(this->_current + n)); };
+				vector_iterator	operator+(difference_type n) const { return (vector_iterator(this->_current + n)); };
 				vector_iterator	operator++(int) { return (vector_iterator(this->_current++)); };
 				vector_iterator	operator-(difference_type n) const { return (vector_iterator(this->_current - n)); };
 				vector_iterator	operator--(int) { return (vector_iterator(this->_current--)); };